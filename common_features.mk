@@ -36,6 +36,7 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/process_keycode/process_audio.c
     ifeq ($(PLATFORM),AVR)
         SRC += $(QUANTUM_DIR)/audio/audio.c
+        SRC += $(QUANTUM_DIR)/audio/audio_engine.c
     else
         SRC += $(QUANTUM_DIR)/audio/audio_arm.c
     endif
@@ -110,9 +111,19 @@ ifeq ($(strip $(RGBLIGHT_ENABLE)), yes)
         OPT_DEFS += -DRGBLIGHT_CUSTOM_DRIVER
     else
 	    SRC += ws2812.c
+        ifeq ($(strip $(WS2812_USART)), yes)
+            OPT_DEFS += -DWS2812_USART
+            SRC += ws2812_frame.c
+        endif
     endif
 endif
 
+ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
+    OPT_DEFS += -DRGB_MATRIX_ENABLE
+    SRC += $(QUANTUM_DIR)/rgb_matrix.c
+    CIE1931_CURVE = yes
+endif
+
 ifeq ($(strip $(TAP_DANCE_ENABLE)), yes)
     OPT_DEFS += -DTAP_DANCE_ENABLE
     SRC += $(QUANTUM_DIR)/process_keycode/process_tap_dance.c
@@ -148,6 +159,11 @@ ifneq ($(strip $(MAX_VARIABLE_TRACE_SIZE)),)
 endif
 endif
 
+ifeq ($(strip $(LATENCY_TRACE_ENABLE)), yes)
+    OPT_DEFS += -DLATENCY_TRACE_ENABLE
+    SRC += $(QUANTUM_DIR)/latency_trace.c
+endif
+
 ifeq ($(strip $(LCD_ENABLE)), yes)
     CIE1931_CURVE = yes
 endif
@@ -184,6 +200,26 @@ ifeq ($(strip $(USB_HID_ENABLE)), yes)
     include $(TMK_DIR)/protocol/usb_hid.mk
 endif
 
+ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
+    OPT_DEFS += -DSPLIT_KEYBOARD
+    SPLIT_DIR := $(QUANTUM_DIR)/split
+    VPATH += $(QUANTUM_PATH)/split
+    SRC += $(SPLIT_DIR)/transport.c
+    ifeq ($(PLATFORM),TEST)
+        SRC += $(SPLIT_DIR)/loopback.c
+    else
+        # The physical layer is picked with USE_I2C, USE_USART or USE_SERIAL in config.h
+        SRC += $(SPLIT_DIR)/split_util.c \
+            $(SPLIT_DIR)/serial.c \
+            $(SPLIT_DIR)/usart.c \
+            $(SPLIT_DIR)/i2c.c
+        ifndef CUSTOM_MATRIX
+            SRC += $(SPLIT_DIR)/matrix.c
+            CUSTOM_MATRIX := yes
+        endif
+    endif
+endif
+
 QUANTUM_SRC:= \
     $(QUANTUM_DIR)/quantum.c \
     $(QUANTUM_DIR)/keymap_common.c \
@@ -193,3 +229,14 @@ QUANTUM_SRC:= \
 ifndef CUSTOM_MATRIX
     QUANTUM_SRC += $(QUANTUM_DIR)/matrix.c
 endif
+
+DEBOUNCE_DIR:= $(QUANTUM_DIR)/debounce
+# Debounce Modules. If implemented in matrix.c, don't use these.
+DEBOUNCE_TYPE?= sym_g
+VALID_DEBOUNCE_TYPES := sym_g eager_pk sym_defer_pr custom
+ifeq ($(filter $(DEBOUNCE_TYPE),$(VALID_DEBOUNCE_TYPES)),)
+    $(error DEBOUNCE_TYPE="$(DEBOUNCE_TYPE)" is not a valid debounce algorithm)
+endif
+ifneq ($(strip $(DEBOUNCE_TYPE)), custom)
+    QUANTUM_SRC += $(DEBOUNCE_DIR)/$(strip $(DEBOUNCE_TYPE)).c
+endif
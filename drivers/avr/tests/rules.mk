@@ -0,0 +1,5 @@
+ws2812_frame_DEFS := -DRGBLED_NUM=64
+ws2812_frame_INC := $(DRIVER_PATH)/avr
+ws2812_frame_SRC := \
+	$(DRIVER_PATH)/avr/tests/ws2812_frame_tests.cpp \
+	$(DRIVER_PATH)/avr/ws2812_frame.c
@@ -0,0 +1,228 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "ws2812_frame.h"
+}
+
+// WS2812B datasheet timing, 150 ns either way. The LEDs only time the high
+// part of a bit, a longer low part just has to stay short of the reset.
+static const unsigned t0h_ns = 400;
+static const unsigned t1h_ns = 800;
+static const unsigned t1l_ns = 450;
+static const unsigned tolerance_ns = 150;
+static const unsigned reset_ns = 50000;
+
+// What the LEDs see on the line
+struct Decoded {
+    std::vector<std::vector<uint8_t>> frames;
+    // the shortest low time after the end of a frame
+    unsigned shortest_reset_ns = ~0u;
+    unsigned timing_errors = 0;
+};
+
+static bool within(unsigned ns, unsigned expected) {
+    return ns + tolerance_ns >= expected && ns <= expected + tolerance_ns;
+}
+
+// The line level for each output bit, a late byte keeps the line at the
+// level of the last bit for late_bits[i] bits before byte i
+static std::vector<bool> line_of(const std::vector<uint8_t>& output, const std::vector<unsigned>& late_bits = {}) {
+    std::vector<bool> line;
+    for (size_t i = 0; i < output.size(); i++) {
+        if (i < late_bits.size() && !line.empty()) {
+            line.insert(line.end(), late_bits[i], line.back());
+        }
+        for (int bit = 7; bit >= 0; bit--) {
+            line.push_back((output[i] >> bit) & 1);
+        }
+    }
+    return line;
+}
+
+static Decoded decode(const std::vector<bool>& line) {
+    Decoded decoded;
+    std::vector<uint8_t> frame;
+    uint8_t byte = 0;
+    unsigned bits = 0;
+    size_t i = 0;
+    while (i < line.size()) {
+        size_t high = 0;
+        while (i < line.size() && line[i]) {
+            high++;
+            i++;
+        }
+        size_t low = 0;
+        while (i < line.size() && !line[i]) {
+            low++;
+            i++;
+        }
+        const unsigned high_ns = high * WS2812_OUTPUT_BIT_NS;
+        const unsigned low_ns = low * WS2812_OUTPUT_BIT_NS;
+        const bool end_of_frame = low_ns >= reset_ns || i == line.size();
+        if (high) {
+            const bool one = high_ns > (t0h_ns + t1h_ns) / 2;
+            if (!within(high_ns, one ? t1h_ns : t0h_ns) || (!end_of_frame && low_ns + tolerance_ns < t1l_ns)) {
+                decoded.timing_errors++;
+            }
+            byte = (byte << 1) | one;
+            if (++bits % 8 == 0) {
+                frame.push_back(byte);
+            }
+        }
+        if (end_of_frame && !frame.empty()) {
+            decoded.frames.push_back(frame);
+            decoded.shortest_reset_ns = std::min(decoded.shortest_reset_ns, low_ns);
+            frame.clear();
+            bits = 0;
+        }
+    }
+    return decoded;
+}
+
+static Decoded decode(const std::vector<uint8_t>& output) {
+    return decode(line_of(output));
+}
+
+// The output interrupt, taking up to max bytes
+static std::vector<uint8_t> send(size_t max = ~size_t(0)) {
+    std::vector<uint8_t> output;
+    uint8_t byte;
+    while (output.size() < max && ws2812_frame_next_byte(&byte)) {
+        output.push_back(byte);
+    }
+    return output;
+}
+
+static std::vector<uint8_t> random_frame(unsigned seed, size_t len = WS2812_FRAME_MAX_BYTES) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> frame(len);
+    for (auto& byte : frame) {
+        byte = rng();
+    }
+    return frame;
+}
+
+class Ws2812Frame : public testing::Test {
+public:
+    ~Ws2812Frame() {
+        // leave the output idle for the next test
+        send();
+    }
+};
+
+TEST_F(Ws2812Frame, NothingIsSentWithoutAFrame) {
+    uint8_t byte;
+    EXPECT_FALSE(ws2812_frame_next_byte(&byte));
+}
+
+TEST_F(Ws2812Frame, AFrameIsSentWithinTheWs2812Timing) {
+    auto frame = random_frame(1);
+    EXPECT_TRUE(ws2812_frame_set(frame.data(), frame.size()));
+    auto output = send();
+    EXPECT_EQ(output.size(), frame.size() * 4 + WS2812_RESET_BYTES);
+    Decoded decoded = decode(output);
+    ASSERT_EQ(decoded.frames.size(), 1);
+    EXPECT_EQ(decoded.frames[0], frame);
+    EXPECT_EQ(decoded.timing_errors, 0);
+    EXPECT_GE(decoded.shortest_reset_ns, WS2812_RESET_US * 1000);
+}
+
+TEST_F(Ws2812Frame, EveryByteValueIsEncoded) {
+    std::vector<uint8_t> frame(256);
+    for (int i = 0; i < 256; i++) {
+        frame[i] = i;
+    }
+    ws2812_frame_set(frame.data(), WS2812_FRAME_MAX_BYTES);
+    Decoded decoded = decode(send());
+    ASSERT_EQ(decoded.frames.size(), 1);
+    EXPECT_EQ(decoded.frames[0], std::vector<uint8_t>(frame.begin(), frame.begin() + WS2812_FRAME_MAX_BYTES));
+    EXPECT_EQ(decoded.timing_errors, 0);
+}
+
+TEST_F(Ws2812Frame, AFrameSetWhileSendingFollowsAfterTheReset) {
+    auto first = random_frame(1);
+    auto second = random_frame(2, 30);
+    EXPECT_TRUE(ws2812_frame_set(first.data(), first.size()));
+    auto output = send(100);
+    // the back buffer is written while the front one is sent
+    EXPECT_FALSE(ws2812_frame_set(second.data(), second.size()));
+    auto expected_first = first;
+    first[0] ^= 0xFF;
+    auto rest = send();
+    output.insert(output.end(), rest.begin(), rest.end());
+    Decoded decoded = decode(output);
+    ASSERT_EQ(decoded.frames.size(), 2);
+    EXPECT_EQ(decoded.frames[0], expected_first);
+    EXPECT_EQ(decoded.frames[1], second);
+    EXPECT_EQ(decoded.timing_errors, 0);
+    EXPECT_GE(decoded.shortest_reset_ns, WS2812_RESET_US * 1000);
+}
+
+TEST_F(Ws2812Frame, OnlyTheLatestFrameIsKept) {
+    auto first = random_frame(1);
+    auto second = random_frame(2);
+    auto third = random_frame(3);
+    ws2812_frame_set(first.data(), first.size());
+    auto output = send(10);
+    ws2812_frame_set(second.data(), second.size());
+    ws2812_frame_set(third.data(), third.size());
+    auto rest = send();
+    output.insert(output.end(), rest.begin(), rest.end());
+    Decoded decoded = decode(output);
+    ASSERT_EQ(decoded.frames.size(), 2);
+    EXPECT_EQ(decoded.frames[0], first);
+    EXPECT_EQ(decoded.frames[1], third);
+}
+
+TEST_F(Ws2812Frame, AFrameSetAfterTheResetStartsTheOutputAgain) {
+    auto first = random_frame(1, 3);
+    auto second = random_frame(2, 3);
+    ws2812_frame_set(first.data(), first.size());
+    send();
+    EXPECT_TRUE(ws2812_frame_set(second.data(), second.size()));
+    Decoded decoded = decode(send());
+    ASSERT_EQ(decoded.frames.size(), 1);
+    EXPECT_EQ(decoded.frames[0], second);
+}
+
+TEST_F(Ws2812Frame, EveryOutputByteEndsLow) {
+    auto frame = random_frame(1);
+    ws2812_frame_set(frame.data(), frame.size());
+    for (uint8_t byte : send()) {
+        EXPECT_EQ(byte & 1, 0);
+    }
+}
+
+TEST_F(Ws2812Frame, LateInterruptsOnlyMakeTheLowPartLonger) {
+    auto frame = random_frame(1);
+    ws2812_frame_set(frame.data(), frame.size());
+    auto output = send();
+    // each interrupt is served late by up to 10 us, but well within the reset
+    std::mt19937 rng(2);
+    std::vector<unsigned> late_bits(output.size());
+    for (auto& late : late_bits) {
+        late = rng() % (10000 / WS2812_OUTPUT_BIT_NS);
+    }
+    Decoded decoded = decode(line_of(output, late_bits));
+    ASSERT_EQ(decoded.frames.size(), 1);
+    EXPECT_EQ(decoded.frames[0], frame);
+    EXPECT_EQ(decoded.timing_errors, 0);
+}
@@ -141,13 +141,6 @@ unsigned char I2C_Write(unsigned char c)
 
 #endif
 
-// Setleds for standard RGB
-void inline ws2812_setleds(LED_TYPE *ledarray, uint16_t leds)
-{
-   // ws2812_setleds_pin(ledarray,leds, _BV(ws2812_pin));
-   ws2812_setleds_pin(ledarray,leds, _BV(RGB_DI_PIN & 0xF));
-}
-
 void inline ws2812_setleds_pin(LED_TYPE *ledarray, uint16_t leds, uint8_t pinmask)
 {
   // ws2812_DDRREG |= pinmask; // Enable DDR
@@ -158,6 +151,81 @@ void inline ws2812_setleds_pin(LED_TYPE *ledarray, uint16_t leds, uint8_t pinmas
   _delay_us(50);
 }
 
+#ifdef WS2812_USART
+
+/*
+ * USART1 in SPI master mode sends the frames from ws2812_frame.c on TXD1,
+ * with interrupts enabled. Every output byte ends low, so when the data
+ * register empty interrupt isn't served within one output byte, 3 us, the
+ * low part of a bit gets longer. The LEDs only latch early when that is
+ * longer than the reset time.
+ */
+
+#include "ws2812_frame.h"
+
+#if RGB_DI_PIN != D3
+  #error "WS2812_USART sends on TXD1, RGB_DI_PIN has to be D3"
+#endif
+#if F_CPU != 16000000
+  #error "WS2812_USART needs a 16 MHz clock for its 2.67 MHz output"
+#endif
+#define WS2812_USART_UBRR (F_CPU / 2 / (1000000000 / WS2812_OUTPUT_BIT_NS) - 1)
+
+static void ws2812_usart_init(void)
+{
+  static bool initialized = false;
+  if (initialized) {
+    return;
+  }
+  initialized = true;
+  UBRR1 = 0;
+  // XCK1 as an output selects master mode, it toggles while sending
+  PORTD &= ~(_BV(PD3) | _BV(PD5));
+  DDRD |= _BV(PD3) | _BV(PD5);
+  UCSR1C = _BV(UMSEL11) | _BV(UMSEL10);
+  UCSR1B = _BV(TXEN1);
+  // the baud rate has to be set after the transmitter is enabled
+  UBRR1 = WS2812_USART_UBRR;
+}
+
+static void ws2812_usart_send(LED_TYPE *ledarray, uint16_t len)
+{
+  ws2812_usart_init();
+  if (ws2812_frame_set((uint8_t*)ledarray, len)) {
+    // the data register is empty, so the interrupt fires straight away
+    UCSR1B |= _BV(UDRIE1);
+  }
+}
+
+ISR(USART1_UDRE_vect)
+{
+  uint8_t byte;
+  if (ws2812_frame_next_byte(&byte)) {
+    UDR1 = byte;
+  } else {
+    UCSR1B &= ~_BV(UDRIE1);
+  }
+}
+
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t leds)
+{
+  ws2812_usart_send(ledarray, leds * sizeof(LED_TYPE));
+}
+
+void ws2812_setleds_rgbw(LED_TYPE *ledarray, uint16_t leds)
+{
+  ws2812_usart_send(ledarray, leds * sizeof(LED_TYPE));
+}
+
+#else
+
+// Setleds for standard RGB
+void inline ws2812_setleds(LED_TYPE *ledarray, uint16_t leds)
+{
+   // ws2812_setleds_pin(ledarray,leds, _BV(ws2812_pin));
+   ws2812_setleds_pin(ledarray,leds, _BV(RGB_DI_PIN & 0xF));
+}
+
 // Setleds for SK6812RGBW
 void inline ws2812_setleds_rgbw(LED_TYPE *ledarray, uint16_t leds)
 {
@@ -196,6 +264,8 @@ void inline ws2812_setleds_rgbw(LED_TYPE *ledarray, uint16_t leds)
   #endif
 }
 
+#endif
+
 void ws2812_sendarray(uint8_t *data,uint16_t datlen)
 {
   ws2812_sendarray_mask(data,datlen,_BV(RGB_DI_PIN & 0xF));
@@ -0,0 +1,35 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "ws2812_frame.h"
+
+ws2812_frame_t ws2812_frame;
+uint8_t ws2812_frame_buffers[2][WS2812_FRAME_MAX_BYTES];
+uint16_t ws2812_frame_lengths[2];
+
+bool ws2812_frame_set(const uint8_t *data, uint16_t len) {
+  if (len > WS2812_FRAME_MAX_BYTES) {
+    len = WS2812_FRAME_MAX_BYTES;
+  }
+  // the buffers can't be swapped while the back one is written
+  ws2812_frame.pending = false;
+  uint8_t back = ws2812_frame.front ^ 1;
+  memcpy(ws2812_frame_buffers[back], data, len);
+  ws2812_frame_lengths[back] = len;
+  ws2812_frame.pending = true;
+  return !ws2812_frame.sending;
+}
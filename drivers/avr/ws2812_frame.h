@@ -0,0 +1,107 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WS2812_FRAME_H_
+#define WS2812_FRAME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rgblight_types.h"
+
+/*
+ * Double buffered frames for a WS2812 chain that is driven by a serial
+ * output, like the USART in SPI master mode
+ *
+ * Every bit for the LEDs is four bits of the output, 1000 for a 0 and 1100
+ * for a 1. At 2.67 MHz that is 375 ns high and 1125 ns low, or 750 ns of
+ * each, so each output byte holds two LED bits and ends low. When the next
+ * byte comes late the line stays low, which only makes the low part of a
+ * bit longer, the LEDs time the high part. A frame is followed by enough
+ * zeros for the LEDs to latch it.
+ *
+ * The frame that is being sent is the front buffer. ws2812_frame_set copies
+ * the next one to the back buffer, and the buffers are swapped once the
+ * front one has been sent. When frames come faster than they can be sent,
+ * only the latest one is kept.
+ */
+
+#define WS2812_OUTPUT_BIT_NS 375
+#define WS2812_OUTPUT_BYTE_NS (8 * WS2812_OUTPUT_BIT_NS)
+
+/* how long the line is kept low after a frame, WS2813 needs 300 */
+#ifndef WS2812_RESET_US
+#define WS2812_RESET_US 50
+#endif
+#define WS2812_RESET_BYTES ((WS2812_RESET_US * 1000 + WS2812_OUTPUT_BYTE_NS - 1) / WS2812_OUTPUT_BYTE_NS)
+
+#define WS2812_FRAME_MAX_BYTES (RGBLED_NUM * sizeof(LED_TYPE))
+
+typedef struct {
+  const uint8_t *pos;     // the next LED byte of the front buffer
+  const uint8_t *end;
+  uint8_t data;           // the LED byte being sent, shifted as it goes
+  uint8_t pairs;          // LED bit pairs left in data
+  uint8_t reset_left;     // zero bytes left after the frame
+  volatile uint8_t front;
+  volatile bool pending;  // the back buffer holds a new frame
+  volatile bool sending;
+} ws2812_frame_t;
+
+extern ws2812_frame_t ws2812_frame;
+extern uint8_t ws2812_frame_buffers[2][WS2812_FRAME_MAX_BYTES];
+extern uint16_t ws2812_frame_lengths[2];
+
+// Copies the next frame, returns true if the output is idle and has to be
+// started, after which it asks for the bytes itself
+bool ws2812_frame_set(const uint8_t *data, uint16_t len);
+
+// Called from the interrupt whenever the output can take a byte, returns
+// false when there is nothing left to send. It is inline and calls nothing,
+// so the interrupt only saves the few registers it uses.
+static inline bool ws2812_frame_next_byte(uint8_t *byte) {
+  ws2812_frame_t *f = &ws2812_frame;
+  if (f->pairs == 0) {
+    if (f->pos == f->end) {
+      if (f->reset_left == 0) {
+        if (!f->pending) {
+          f->sending = false;
+          return false;
+        }
+        uint8_t front = f->front ^ 1;
+        f->front = front;
+        f->pending = false;
+        f->sending = true;
+        f->pos = ws2812_frame_buffers[front];
+        f->end = f->pos + ws2812_frame_lengths[front];
+        f->reset_left = WS2812_RESET_BYTES;
+      }
+      if (f->pos == f->end) {
+        f->reset_left--;
+        *byte = 0;
+        return true;
+      }
+    }
+    f->data = *f->pos++;
+    f->pairs = 4;
+  }
+  uint8_t data = f->data;
+  *byte = 0x88 | ((data >> 1) & 0x40) | ((data >> 4) & 0x04);
+  f->data = data << 2;
+  f->pairs--;
+  return true;
+}
+
+#endif
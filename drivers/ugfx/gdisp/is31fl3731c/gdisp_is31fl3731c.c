@@ -109,6 +109,9 @@ typedef struct{
     uint8_t write_buffer[IS31_FRAME_SIZE];
     uint8_t frame_buffer[GDISP_SCREEN_HEIGHT * GDISP_SCREEN_WIDTH];
     uint8_t page;
+    // The PWM registers changed by the previous flush
+    uint8_t prev_first;
+    uint8_t prev_last;
 }__attribute__((__packed__)) PrivData;
 
 // Some common routines and macros
@@ -139,6 +142,17 @@ static GFXINLINE void write_ram(GDisplay *g, uint8_t page, uint16_t offset, uint
     write_data(g, (uint8_t*)PRIV(g), length + 1);
 }
 
+// Writes the PWM registers from first to last, the register address has to be
+// sent just before the data, so it temporarily replaces the byte before the first
+static GFXINLINE void write_pwm(GDisplay *g, uint8_t page, uint8_t first, uint8_t last) {
+    uint8_t* tx = (uint8_t*)PRIV(g) + first;
+    uint8_t saved = *tx;
+    *tx = IS31_PWM_REG + first;
+    write_page(g, page);
+    write_data(g, tx, last - first + 2);
+    *tx = saved;
+}
+
 LLDSPEC bool_t gdisp_lld_init(GDisplay *g) {
     // The private area is the display surface.
     g->priv = gfxAlloc(sizeof(PrivData));
@@ -168,6 +182,11 @@ LLDSPEC bool_t gdisp_lld_init(GDisplay *g) {
         gfxSleepMilliseconds(1);
     }
 
+    // the PWM registers of both pages are now zero
+    __builtin_memset(PRIV(g)->write_buffer, 0, IS31_FRAME_SIZE);
+    PRIV(g)->prev_first = IS31_PWM_SIZE;
+    PRIV(g)->prev_last = 0;
+
     // software shutdown disable (i.e. turn stuff on)
     write_register(g, IS31_FUNCTIONREG, IS31_REG_SHUTDOWN, IS31_REG_SHUTDOWN_OFF);
     gfxSleepMilliseconds(10);
@@ -191,25 +210,42 @@ LLDSPEC bool_t gdisp_lld_init(GDisplay *g) {
         if (!(g->flags & GDISP_FLG_NEEDFLUSH))
             return;
 
-        PRIV(g)->page++;
-        PRIV(g)->page %= 2;
-        // TODO: some smarter algorithm for this
-        // We should run only one physical page at a time
-        // This way we don't need to send so much data, and
-        // we could use slightly less memory
+        g->flags &= ~GDISP_FLG_NEEDFLUSH;
+
+        // The write buffer holds what the displayed page has, so only the
+        // registers between first and last have changed
+        uint8_t first = IS31_PWM_SIZE;
+        uint8_t last = 0;
         uint8_t* src = PRIV(g)->frame_buffer;
         for (int y=0;y<GDISP_SCREEN_HEIGHT;y++) {
             for (int x=0;x<GDISP_SCREEN_WIDTH;x++) {
                 uint8_t val = (uint16_t)*src * g->g.Backlight / 100;
-                PRIV(g)->write_buffer[get_led_address(g, x, y)]=CIE1931_CURVE[val];
+                uint8_t address = get_led_address(g, x, y);
+                uint8_t pwm = CIE1931_CURVE[val];
+                if (PRIV(g)->write_buffer[address] != pwm) {
+                    PRIV(g)->write_buffer[address] = pwm;
+                    first = address < first ? address : first;
+                    last = address > last ? address : last;
+                }
                 ++src;
             }
         }
-        write_ram(g, PRIV(g)->page, IS31_PWM_REG, IS31_PWM_SIZE);
+        if (first > last) {
+            return;
+        }
+
+        // The page that is written to has the frame before the displayed one,
+        // so it also needs the registers that changed in the previous flush
+        uint8_t from = first < PRIV(g)->prev_first ? first : PRIV(g)->prev_first;
+        uint8_t to = last > PRIV(g)->prev_last ? last : PRIV(g)->prev_last;
+        PRIV(g)->prev_first = first;
+        PRIV(g)->prev_last = last;
+
+        PRIV(g)->page++;
+        PRIV(g)->page %= 2;
+        write_pwm(g, PRIV(g)->page, from, to);
         gfxSleepMilliseconds(1);
         write_register(g, IS31_FUNCTIONREG, IS31_REG_PICTDISP, PRIV(g)->page);
-
-        g->flags &= ~GDISP_FLG_NEEDFLUSH;
     }
 #endif
 
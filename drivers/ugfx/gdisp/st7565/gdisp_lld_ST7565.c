@@ -58,6 +58,9 @@
 
 typedef struct{
     bool_t buffer2;
+    // The pages changed since the last flush, and by the last flush
+    uint8_t dirty_pages;
+    uint8_t prev_dirty_pages;
     uint8_t data_pos;
     uint8_t data[16];
     uint8_t ram[GDISP_SCREEN_HEIGHT * GDISP_SCREEN_WIDTH / 8];
@@ -85,6 +88,7 @@ static GFXINLINE void flush_cmd(GDisplay* g) {
 
 #define xyaddr(x, y)        ((x) + ((y)>>3)*GDISP_SCREEN_WIDTH)
 #define xybit(y)            (1<<((y)&7))
+#define xypage(y)           (1<<((y)>>3))
 
 /*===========================================================================*/
 /* Driver exported functions.                                                */
@@ -102,6 +106,9 @@ LLDSPEC bool_t gdisp_lld_init(GDisplay *g) {
     g->priv = gfxAlloc(sizeof(PrivData));
     PRIV(g)->buffer2 = false;
     PRIV(g)->data_pos = 0;
+    // Neither buffer of the display has been written yet
+    PRIV(g)->dirty_pages = 0xF;
+    PRIV(g)->prev_dirty_pages = 0xF;
 
     // Initialise the board interface
     init_board(g);
@@ -156,10 +163,22 @@ LLDSPEC void gdisp_lld_flush(GDisplay *g) {
     if (!(g->flags & GDISP_FLG_NEEDFLUSH))
         return;
 
+    g->flags &= ~GDISP_FLG_NEEDFLUSH;
+    if (!PRIV(g)->dirty_pages)
+        return;
+
+    // The buffer that is written to has the frame before the displayed one,
+    // so it also needs the pages that changed in the previous flush
+    uint8_t pages = PRIV(g)->dirty_pages | PRIV(g)->prev_dirty_pages;
+    PRIV(g)->prev_dirty_pages = PRIV(g)->dirty_pages;
+    PRIV(g)->dirty_pages = 0;
+
     acquire_bus(g);
     enter_cmd_mode(g);
     unsigned dstOffset = (PRIV(g)->buffer2 ? 4 : 0);
     for (p = 0; p < 4; p++) {
+        if (!(pages & (1 << p)))
+            continue;
         write_cmd(g, ST7565_PAGE | (p + dstOffset));
         write_cmd(g, ST7565_COLUMN_MSB | 0);
         write_cmd(g, ST7565_COLUMN_LSB | 0);
@@ -174,8 +193,6 @@ LLDSPEC void gdisp_lld_flush(GDisplay *g) {
     flush_cmd(g);
     PRIV(g)->buffer2 = !PRIV(g)->buffer2;
     release_bus(g);
-
-    g->flags &= ~GDISP_FLG_NEEDFLUSH;
 }
 #endif
 
@@ -202,10 +219,13 @@ LLDSPEC void gdisp_lld_draw_pixel(GDisplay *g) {
         y = g->p.x;
         break;
     }
+    uint8_t old = RAM(g)[xyaddr(x, y)];
     if (gdispColor2Native(g->p.color) != Black)
         RAM(g)[xyaddr(x, y)] |= xybit(y);
     else
         RAM(g)[xyaddr(x, y)] &= ~xybit(y);
+    if (RAM(g)[xyaddr(x, y)] != old)
+        PRIV(g)->dirty_pages |= xypage(y);
     g->flags |= GDISP_FLG_NEEDFLUSH;
 }
 #endif
@@ -251,12 +271,16 @@ LLDSPEC void gdisp_lld_blit_area(GDisplay *g) {
             uint8_t bit = 7-(srcbit % 8);
             uint8_t bitset = (src >> bit) & 1;
             uint8_t* dst = &(RAM(g)[xyaddr(dstx, dsty)]);
+            uint8_t old = *dst;
             if (bitset) {
                 *dst |= xybit(dsty);
             }
             else {
                 *dst &= ~xybit(dsty);
             }
+            if (*dst != old) {
+                PRIV(g)->dirty_pages |= xypage(dsty);
+            }
             dstx++;
             srcbit++;
         }
@@ -70,6 +70,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define SERIAL_LINK_BAUD 562500
 #define SERIAL_LINK_THREAD_PRIORITY (NORMALPRIO - 1)
+// The other half is the only slave
+#define SERIAL_LINK_NUM_SLAVES 1
 
 #define VISUALIZER_USER_DATA_SIZE 16
 
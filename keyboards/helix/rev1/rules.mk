@@ -1,4 +1 @@
-SRC += rev1/matrix.c \
-	   rev1/split_util.c
-
 BACKLIGHT_ENABLE = no
@@ -1,3 +1 @@
-SRC += rev2/matrix.c \
-	   rev2/split_util.c \
-	   ws2812.c
+SRC += ws2812.c
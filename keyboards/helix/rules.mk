@@ -1,6 +1,4 @@
-SRC += i2c.c \
-	   serial.c \
-	   ssd1306.c
+SRC += ssd1306.c
 
 # MCU name
 #MCU = at90usb1287
@@ -68,6 +66,6 @@ USE_I2C = yes
 # Do not enable SLEEP_LED_ENABLE. it uses the same timer as BACKLIGHT_ENABLE
 SLEEP_LED_ENABLE = no    # Breathing sleep LED during USB suspend
 
-CUSTOM_MATRIX = yes
+SPLIT_KEYBOARD = yes
 
 DEFAULT_FOLDER = helix/rev2
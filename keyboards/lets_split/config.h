@@ -21,4 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "config_common.h"
 
+// i2c SCL clock frequency
+#define SCL_CLOCK  400000L
+
 #endif
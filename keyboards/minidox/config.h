@@ -35,6 +35,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /* COL2ROW or ROW2COL */
 #define DIODE_DIRECTION COL2ROW
 
+// i2c SCL clock frequency
+#define SCL_CLOCK  400000L
+
 /* define if matrix has ghost */
 //#define MATRIX_HAS_GHOST
 
@@ -1,6 +0,0 @@
-#ifndef SPLIT_RGB_H
-#define SPLIT_RGB_H
-
-void rgblight_slave_update(void);
-
-#endif
@@ -24,13 +24,12 @@
 #endif
 #include "print.h"
 #include "audio.h"
+#include "audio_engine.h"
 #include "keymap.h"
 #include "wait.h"
 
 #include "eeconfig.h"
 
-#define CPU_PRESCALER 8
-
 // -----------------------------------------------------------------------------
 // Timer Abstractions
 // -----------------------------------------------------------------------------
@@ -76,39 +75,10 @@
 // -----------------------------------------------------------------------------
 
 
-int voices = 0;
-int voice_place = 0;
-float frequency = 0;
-float frequency_alt = 0;
-int volume = 0;
-long position = 0;
-
-float frequencies[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-int volumes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-bool sliding = false;
-
-float place = 0;
-
-uint8_t * sample;
-uint16_t sample_length = 0;
-
-bool     playing_notes = false;
-bool     playing_note = false;
-float    note_frequency = 0;
-float    note_length = 0;
 uint8_t  note_tempo = TEMPO_DEFAULT;
 float    note_timbre = TIMBRE_DEFAULT;
-uint16_t note_position = 0;
-float (* notes_pointer)[][2];
-uint16_t notes_count;
-bool     notes_repeat;
-bool     note_resting = false;
-
-uint8_t current_note = 0;
-uint8_t rest_counter = 0;
 
 #ifdef VIBRATO_ENABLE
-float vibrato_counter = 0;
 float vibrato_strength = .5;
 float vibrato_rate = 0.125;
 #endif
@@ -119,6 +89,7 @@ static bool audio_initialized = false;
 
 audio_config_t audio_config;
 
+// Used by voice_envelope, the interrupts here use the integer voices in audio_engine.c
 uint16_t envelope_index = 0;
 bool glissando = true;
 
@@ -185,8 +156,12 @@ void audio_init()
             TCCR1A = (0 << COM1A1) | (0 << COM1A0) | (1 << WGM11) | (0 << WGM10);
             TCCR1B = (1 << WGM13)  | (1 << WGM12)  | (0 << CS12)  | (1 << CS11) | (0 << CS10);
 
-            TIMER_1_PERIOD = (uint16_t)(((float)F_CPU) / (440 * CPU_PRESCALER));
-            TIMER_1_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (440 * CPU_PRESCALER)) * note_timbre);
+            TIMER_1_PERIOD = audio_engine_period(440);
+            TIMER_1_DUTY_CYCLE = (uint16_t)(audio_engine_period(440) * note_timbre);
+        #endif
+
+        #ifdef VIBRATO_ENABLE
+            audio_engine_set_vibrato(vibrato_rate, vibrato_strength);
         #endif
 
         audio_initialized = true;
@@ -205,8 +180,6 @@ void stop_all_notes()
     if (!audio_initialized) {
         audio_init();
     }
-    voices = 0;
-
 
     #ifdef C6_AUDIO
         DISABLE_AUDIO_COUNTER_3_ISR;
@@ -218,261 +191,79 @@ void stop_all_notes()
         DISABLE_AUDIO_COUNTER_1_OUTPUT;
     #endif
 
-    playing_notes = false;
-    playing_note = false;
-    frequency = 0;
-    frequency_alt = 0;
-    volume = 0;
-
-    for (uint8_t i = 0; i < 8; i++)
-    {
-        frequencies[i] = 0;
-        volumes[i] = 0;
-    }
+    audio_engine_stop();
 }
 
 void stop_note(float freq)
 {
     dprintf("audio stop note freq=%d", (int)freq);
 
-    if (playing_note) {
+    if (audio_engine_playing_note()) {
         if (!audio_initialized) {
             audio_init();
         }
-        for (int i = 7; i >= 0; i--) {
-            if (frequencies[i] == freq) {
-                frequencies[i] = 0;
-                volumes[i] = 0;
-                for (int j = i; (j < 7); j++) {
-                    frequencies[j] = frequencies[j+1];
-                    frequencies[j+1] = 0;
-                    volumes[j] = volumes[j+1];
-                    volumes[j+1] = 0;
-                }
-                break;
-            }
-        }
-        voices--;
-        if (voices < 0)
-            voices = 0;
-        if (voice_place >= voices) {
-            voice_place = 0;
-        }
-        if (voices == 0) {
+        #ifdef C6_AUDIO
+            DISABLE_AUDIO_COUNTER_3_ISR;
+        #endif
+        #ifdef B5_AUDIO
+            DISABLE_AUDIO_COUNTER_1_ISR;
+        #endif
+        if (audio_engine_note_off(freq) == 0) {
             #ifdef C6_AUDIO
-                DISABLE_AUDIO_COUNTER_3_ISR;
                 DISABLE_AUDIO_COUNTER_3_OUTPUT;
             #endif
             #ifdef B5_AUDIO
-                DISABLE_AUDIO_COUNTER_1_ISR;
                 DISABLE_AUDIO_COUNTER_1_OUTPUT;
             #endif
-            frequency = 0;
-            frequency_alt = 0;
-            volume = 0;
-            playing_note = false;
+        } else {
+            #ifdef C6_AUDIO
+                ENABLE_AUDIO_COUNTER_3_ISR;
+                #ifdef B5_AUDIO
+                    // The second voice has stopped
+                    if (audio_engine_voices() < 2) {
+                        DISABLE_AUDIO_COUNTER_1_OUTPUT;
+                    }
+                #endif
+            #else
+                ENABLE_AUDIO_COUNTER_1_ISR;
+            #endif
         }
     }
 }
 
-#ifdef VIBRATO_ENABLE
-
-float mod(float a, int b)
-{
-    float r = fmod(a, b);
-    return r < 0 ? r + b : r;
-}
-
-float vibrato(float average_freq) {
-    #ifdef VIBRATO_STRENGTH_ENABLE
-        float vibrated_freq = average_freq * pow(vibrato_lut[(int)vibrato_counter], vibrato_strength);
-    #else
-        float vibrated_freq = average_freq * vibrato_lut[(int)vibrato_counter];
-    #endif
-    vibrato_counter = mod((vibrato_counter + vibrato_rate * (1.0 + 440.0/average_freq)), VIBRATO_LUT_LENGTH);
-    return vibrated_freq;
-}
-
-#endif
-
 #ifdef C6_AUDIO
 ISR(TIMER3_COMPA_vect)
 {
-    float freq;
-
-    if (playing_note) {
-        if (voices > 0) {
-
-            #ifdef B5_AUDIO
-            float freq_alt = 0;
-                if (voices > 1) {
-                    if (polyphony_rate == 0) {
-                        if (glissando) {
-                            if (frequency_alt != 0 && frequency_alt < frequencies[voices - 2] && frequency_alt < frequencies[voices - 2] * pow(2, -440/frequencies[voices - 2]/12/2)) {
-                                frequency_alt = frequency_alt * pow(2, 440/frequency_alt/12/2);
-                            } else if (frequency_alt != 0 && frequency_alt > frequencies[voices - 2] && frequency_alt > frequencies[voices - 2] * pow(2, 440/frequencies[voices - 2]/12/2)) {
-                                frequency_alt = frequency_alt * pow(2, -440/frequency_alt/12/2);
-                            } else {
-                                frequency_alt = frequencies[voices - 2];
-                            }
-                        } else {
-                            frequency_alt = frequencies[voices - 2];
-                        }
-
-                        #ifdef VIBRATO_ENABLE
-                            if (vibrato_strength > 0) {
-                                freq_alt = vibrato(frequency_alt);
-                            } else {
-                                freq_alt = frequency_alt;
-                            }
-                        #else
-                            freq_alt = frequency_alt;
-                        #endif
-                    }
-
-                    if (envelope_index < 65535) {
-                        envelope_index++;
-                    }
-
-                    freq_alt = voice_envelope(freq_alt);
-
-                    if (freq_alt < 30.517578125) {
-                        freq_alt = 30.52;
-                    }
-
-                    TIMER_1_PERIOD = (uint16_t)(((float)F_CPU) / (freq_alt * CPU_PRESCALER));
-                    TIMER_1_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq_alt * CPU_PRESCALER)) * note_timbre);
-                }
-            #endif
-
-            if (polyphony_rate > 0) {
-                if (voices > 1) {
-                    voice_place %= voices;
-                    if (place++ > (frequencies[voice_place] / polyphony_rate / CPU_PRESCALER)) {
-                        voice_place = (voice_place + 1) % voices;
-                        place = 0.0;
-                    }
-                }
-
-                #ifdef VIBRATO_ENABLE
-                    if (vibrato_strength > 0) {
-                        freq = vibrato(frequencies[voice_place]);
-                    } else {
-                        freq = frequencies[voice_place];
-                    }
-                #else
-                    freq = frequencies[voice_place];
-                #endif
-            } else {
-                if (glissando) {
-                    if (frequency != 0 && frequency < frequencies[voices - 1] && frequency < frequencies[voices - 1] * pow(2, -440/frequencies[voices - 1]/12/2)) {
-                        frequency = frequency * pow(2, 440/frequency/12/2);
-                    } else if (frequency != 0 && frequency > frequencies[voices - 1] && frequency > frequencies[voices - 1] * pow(2, 440/frequencies[voices - 1]/12/2)) {
-                        frequency = frequency * pow(2, -440/frequency/12/2);
-                    } else {
-                        frequency = frequencies[voices - 1];
-                    }
-                } else {
-                    frequency = frequencies[voices - 1];
-                }
-
-                #ifdef VIBRATO_ENABLE
-                    if (vibrato_strength > 0) {
-                        freq = vibrato(frequency);
-                    } else {
-                        freq = frequency;
-                    }
-                #else
-                    freq = frequency;
-                #endif
-            }
-
-            if (envelope_index < 65535) {
-                envelope_index++;
-            }
-
-            freq = voice_envelope(freq);
-
-            if (freq < 30.517578125) {
-                freq = 30.52;
-            }
+    audio_engine_output_t output;
 
-            TIMER_3_PERIOD = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-            TIMER_3_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
-        }
-    }
-
-    if (playing_notes) {
-        if (note_frequency > 0) {
-            #ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(note_frequency);
-                } else {
-                    freq = note_frequency;
-                }
-            #else
-                    freq = note_frequency;
-            #endif
-
-            if (envelope_index < 65535) {
-                envelope_index++;
-            }
-            freq = voice_envelope(freq);
-
-            TIMER_3_PERIOD = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-            TIMER_3_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
-        } else {
-            TIMER_3_PERIOD = 0;
-            TIMER_3_DUTY_CYCLE = 0;
+    #ifdef B5_AUDIO
+        audio_engine_output_t alt;
+        uint8_t updated = audio_engine_tick(&output, &alt);
+        if (updated & AUDIO_ENGINE_ALT) {
+            TIMER_1_PERIOD = alt.period;
+            TIMER_1_DUTY_CYCLE = alt.duty;
         }
+    #else
+        uint8_t updated = audio_engine_tick(&output, NULL);
+    #endif
 
-        note_position++;
-        bool end_of_note = false;
-        if (TIMER_3_PERIOD > 0) {
-            if (!note_resting) 
-                end_of_note = (note_position >= (note_length / TIMER_3_PERIOD * 0xFFFF - 1));
-            else
-                end_of_note = (note_position >= (note_length));
+    if (updated & AUDIO_ENGINE_OUTPUT) {
+        TIMER_3_PERIOD = output.period;
+        TIMER_3_DUTY_CYCLE = output.duty;
+        if (output.silent) {
+            DISABLE_AUDIO_COUNTER_3_OUTPUT;
         } else {
-            end_of_note = (note_position >= (note_length));
+            ENABLE_AUDIO_COUNTER_3_OUTPUT;
         }
+    }
 
-        if (end_of_note) {
-            current_note++;
-            if (current_note >= notes_count) {
-                if (notes_repeat) {
-                    current_note = 0;
-                } else {
-                    DISABLE_AUDIO_COUNTER_3_ISR;
-                    DISABLE_AUDIO_COUNTER_3_OUTPUT;
-                    playing_notes = false;
-                    return;
-                }
-            }
-            if (!note_resting) {
-                note_resting = true;
-                current_note--;
-                if ((*notes_pointer)[current_note][0] == (*notes_pointer)[current_note + 1][0]) {
-                    note_frequency = 0;
-                    note_length = 1;
-                } else {
-                    note_frequency = (*notes_pointer)[current_note][0];
-                    note_length = 1;
-                }
-            } else {
-                note_resting = false;
-                envelope_index = 0;
-                note_frequency = (*notes_pointer)[current_note][0];
-                note_length = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
-            }
-
-            note_position = 0;
-        }
+    if (updated & AUDIO_ENGINE_STOP) {
+        DISABLE_AUDIO_COUNTER_3_ISR;
+        DISABLE_AUDIO_COUNTER_3_OUTPUT;
     }
 
     if (!audio_config.enable) {
-        playing_notes = false;
-        playing_note = false;
+        audio_engine_stop();
     }
 }
 #endif
@@ -481,140 +272,28 @@ ISR(TIMER3_COMPA_vect)
 ISR(TIMER1_COMPA_vect)
 {
     #if defined(B5_AUDIO) && !defined(C6_AUDIO)
-    float freq = 0;
-
-    if (playing_note) {
-        if (voices > 0) {
-            if (polyphony_rate > 0) {
-                if (voices > 1) {
-                    voice_place %= voices;
-                    if (place++ > (frequencies[voice_place] / polyphony_rate / CPU_PRESCALER)) {
-                        voice_place = (voice_place + 1) % voices;
-                        place = 0.0;
-                    }
-                }
-
-                #ifdef VIBRATO_ENABLE
-                    if (vibrato_strength > 0) {
-                        freq = vibrato(frequencies[voice_place]);
-                    } else {
-                        freq = frequencies[voice_place];
-                    }
-                #else
-                    freq = frequencies[voice_place];
-                #endif
-            } else {
-                if (glissando) {
-                    if (frequency != 0 && frequency < frequencies[voices - 1] && frequency < frequencies[voices - 1] * pow(2, -440/frequencies[voices - 1]/12/2)) {
-                        frequency = frequency * pow(2, 440/frequency/12/2);
-                    } else if (frequency != 0 && frequency > frequencies[voices - 1] && frequency > frequencies[voices - 1] * pow(2, 440/frequencies[voices - 1]/12/2)) {
-                        frequency = frequency * pow(2, -440/frequency/12/2);
-                    } else {
-                        frequency = frequencies[voices - 1];
-                    }
-                } else {
-                    frequency = frequencies[voices - 1];
-                }
-
-                #ifdef VIBRATO_ENABLE
-                    if (vibrato_strength > 0) {
-                        freq = vibrato(frequency);
-                    } else {
-                        freq = frequency;
-                    }
-                #else
-                    freq = frequency;
-                #endif
-            }
-
-            if (envelope_index < 65535) {
-                envelope_index++;
-            }
-
-            freq = voice_envelope(freq);
-
-            if (freq < 30.517578125) {
-                freq = 30.52;
-            }
-
-            TIMER_1_PERIOD = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-            TIMER_1_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
-        }
-    }
-
-    if (playing_notes) {
-        if (note_frequency > 0) {
-            #ifdef VIBRATO_ENABLE
-                if (vibrato_strength > 0) {
-                    freq = vibrato(note_frequency);
-                } else {
-                    freq = note_frequency;
-                }
-            #else
-                    freq = note_frequency;
-            #endif
-
-            if (envelope_index < 65535) {
-                envelope_index++;
-            }
-            freq = voice_envelope(freq);
-
-            TIMER_1_PERIOD = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-            TIMER_1_DUTY_CYCLE = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
-        } else {
-            TIMER_1_PERIOD = 0;
-            TIMER_1_DUTY_CYCLE = 0;
-        }
-
-        note_position++;
-        bool end_of_note = false;
-        if (TIMER_1_PERIOD > 0) {
-            if (!note_resting) 
-                end_of_note = (note_position >= (note_length / TIMER_1_PERIOD * 0xFFFF - 1));
-            else
-                end_of_note = (note_position >= (note_length));
+    audio_engine_output_t output;
+    uint8_t updated = audio_engine_tick(&output, NULL);
+
+    if (updated & AUDIO_ENGINE_OUTPUT) {
+        TIMER_1_PERIOD = output.period;
+        TIMER_1_DUTY_CYCLE = output.duty;
+        if (output.silent) {
+            DISABLE_AUDIO_COUNTER_1_OUTPUT;
         } else {
-            end_of_note = (note_position >= (note_length));
+            ENABLE_AUDIO_COUNTER_1_OUTPUT;
         }
+    }
 
-        if (end_of_note) {
-            current_note++;
-            if (current_note >= notes_count) {
-                if (notes_repeat) {
-                    current_note = 0;
-                } else {
-                    DISABLE_AUDIO_COUNTER_1_ISR;
-                    DISABLE_AUDIO_COUNTER_1_OUTPUT;
-                    playing_notes = false;
-                    return;
-                }
-            }
-            if (!note_resting) {
-                note_resting = true;
-                current_note--;
-                if ((*notes_pointer)[current_note][0] == (*notes_pointer)[current_note + 1][0]) {
-                    note_frequency = 0;
-                    note_length = 1;
-                } else {
-                    note_frequency = (*notes_pointer)[current_note][0];
-                    note_length = 1;
-                }
-            } else {
-                note_resting = false;
-                envelope_index = 0;
-                note_frequency = (*notes_pointer)[current_note][0];
-                note_length = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
-            }
-
-            note_position = 0;
-        }
+    if (updated & AUDIO_ENGINE_STOP) {
+        DISABLE_AUDIO_COUNTER_1_ISR;
+        DISABLE_AUDIO_COUNTER_1_OUTPUT;
     }
 
     if (!audio_config.enable) {
-        playing_notes = false;
-        playing_note = false;
+        audio_engine_stop();
     }
-#endif
+    #endif
 }
 #endif
 
@@ -626,7 +305,7 @@ void play_note(float freq, int vol) {
         audio_init();
     }
 
-    if (audio_config.enable && voices < 8) {
+    if (audio_config.enable && audio_engine_voices() < AUDIO_ENGINE_VOICES) {
         #ifdef C6_AUDIO
             DISABLE_AUDIO_COUNTER_3_ISR;
         #endif
@@ -635,18 +314,10 @@ void play_note(float freq, int vol) {
         #endif
 
         // Cancel notes if notes are playing
-        if (playing_notes)
+        if (audio_engine_playing_song())
             stop_all_notes();
 
-        playing_note = true;
-
-        envelope_index = 0;
-
-        if (freq > 0) {
-            frequencies[voices] = freq;
-            volumes[voices] = vol;
-            voices++;
-        }
+        audio_engine_note_on(freq);
 
         #ifdef C6_AUDIO
             ENABLE_AUDIO_COUNTER_3_ISR;
@@ -654,7 +325,7 @@ void play_note(float freq, int vol) {
         #endif
         #ifdef B5_AUDIO
             #ifdef C6_AUDIO
-            if (voices > 1) {
+            if (audio_engine_voices() > 1) {
                 ENABLE_AUDIO_COUNTER_1_ISR;
                 ENABLE_AUDIO_COUNTER_1_OUTPUT;
             }
@@ -684,22 +355,10 @@ void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat)
         #endif
 
         // Cancel note if a note is playing
-        if (playing_note)
+        if (audio_engine_playing_note())
             stop_all_notes();
 
-        playing_notes = true;
-
-        notes_pointer = np;
-        notes_count = n_count;
-        notes_repeat = n_repeat;
-
-        place = 0;
-        current_note = 0;
-
-        note_frequency = (*notes_pointer)[current_note][0];
-        note_length = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
-        note_position = 0;
-
+        audio_engine_play_song(np, n_count, n_repeat);
 
         #ifdef C6_AUDIO
             ENABLE_AUDIO_COUNTER_3_ISR;
@@ -716,7 +375,11 @@ void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat)
 }
 
 bool is_playing_notes(void) {
-    return playing_notes;
+    return audio_engine_playing_song();
+}
+
+void audio_task(void) {
+    audio_engine_task();
 }
 
 bool is_audio_on(void) {
@@ -751,28 +414,34 @@ void audio_off(void) {
 
 void set_vibrato_rate(float rate) {
     vibrato_rate = rate;
+    audio_engine_set_vibrato(vibrato_rate, vibrato_strength);
 }
 
 void increase_vibrato_rate(float change) {
     vibrato_rate *= change;
+    audio_engine_set_vibrato(vibrato_rate, vibrato_strength);
 }
 
 void decrease_vibrato_rate(float change) {
     vibrato_rate /= change;
+    audio_engine_set_vibrato(vibrato_rate, vibrato_strength);
 }
 
 #ifdef VIBRATO_STRENGTH_ENABLE
 
 void set_vibrato_strength(float strength) {
     vibrato_strength = strength;
+    audio_engine_set_vibrato(vibrato_rate, vibrato_strength);
 }
 
 void increase_vibrato_strength(float change) {
     vibrato_strength *= change;
+    audio_engine_set_vibrato(vibrato_rate, vibrato_strength);
 }
 
 void decrease_vibrato_strength(float change) {
     vibrato_strength /= change;
+    audio_engine_set_vibrato(vibrato_rate, vibrato_strength);
 }
 
 #endif  /* VIBRATO_STRENGTH_ENABLE */
@@ -783,44 +452,47 @@ void decrease_vibrato_strength(float change) {
 
 void set_polyphony_rate(float rate) {
     polyphony_rate = rate;
+    audio_engine_set_polyphony_rate(polyphony_rate);
 }
 
 void enable_polyphony() {
-    polyphony_rate = 5;
+    set_polyphony_rate(5);
 }
 
 void disable_polyphony() {
-    polyphony_rate = 0;
+    set_polyphony_rate(0);
 }
 
 void increase_polyphony_rate(float change) {
-    polyphony_rate *= change;
+    set_polyphony_rate(polyphony_rate * change);
 }
 
 void decrease_polyphony_rate(float change) {
-    polyphony_rate /= change;
+    set_polyphony_rate(polyphony_rate / change);
 }
 
 // Timbre function
 
 void set_timbre(float timbre) {
     note_timbre = timbre;
+    audio_engine_set_timbre(note_timbre);
 }
 
 // Tempo functions
 
 void set_tempo(uint8_t tempo) {
     note_tempo = tempo;
+    audio_engine_set_tempo(note_tempo);
 }
 
 void decrease_tempo(uint8_t tempo_change) {
-    note_tempo += tempo_change;
+    set_tempo(note_tempo + tempo_change);
 }
 
 void increase_tempo(uint8_t tempo_change) {
     if (note_tempo - tempo_change < 10) {
-        note_tempo = 10;
+        set_tempo(10);
     } else {
-        note_tempo -= tempo_change;
+        set_tempo(note_tempo - tempo_change);
     }
 }
@@ -82,6 +82,8 @@ void increase_tempo(uint8_t tempo_change);
 void decrease_tempo(uint8_t tempo_change);
 
 void audio_init(void);
+// Called on each scan, prepares the next notes of a song
+void audio_task(void);
 
 #ifdef PWM_AUDIO
 void play_sample(uint8_t * s, uint16_t l, bool r);
@@ -682,6 +682,10 @@ bool is_playing_notes(void) {
     return playing_notes;
 }
 
+void audio_task(void) {
+    // Songs are played straight from the note arrays by the timer callback
+}
+
 bool is_audio_on(void) {
     return (audio_config.enable != 0);
 }
@@ -0,0 +1,573 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include "audio_engine.h"
+#include "musical_notes.h"
+#include "voices.h"
+#include "luts.h"
+
+#if AUDIO_ENGINE_QUEUE_SIZE & (AUDIO_ENGINE_QUEUE_SIZE - 1)
+#   error "AUDIO_ENGINE_QUEUE_SIZE has to be a power of two"
+#endif
+
+// Timbres are fractions of the period in 1/65536ths
+#define TIMBRE(t) ((uint16_t)((t) * 65536))
+
+// How often the interrupt checks for the next song note when the main loop
+// hasn't converted it yet, 1 ms
+#define WAIT_PERIOD ((uint16_t)(AUDIO_TIMER_HZ / 1000))
+
+// ln(2) * 440 / 24 * 2^32 / AUDIO_TIMER_HZ, see glide_step
+#define GLIDE_SCALE ((uint16_t)(54579148650ULL / AUDIO_TIMER_HZ))
+
+// What follows a song note before the next one starts
+enum {
+    GAP_NONE,     // the last note of the song
+    GAP_SILENT,   // one period of silence, so that repeated notes can be told apart
+    GAP_HOLD,     // one more period of the note
+};
+
+typedef struct {
+    uint32_t ticks;   // the length in timer ticks
+    uint16_t period;  // 0 for a rest
+    uint8_t  gap;
+} song_note_t;
+
+enum {
+    SONG_WAIT,  // the next note hasn't been taken from the queue
+    SONG_NOTE,
+    SONG_GAP,
+};
+
+// Voices started with audio_engine_note_on, the last one started is played
+static volatile bool playing_note = false;
+static uint8_t  voice_count = 0;
+static float    voice_freqs[AUDIO_ENGINE_VOICES];
+static uint16_t voice_periods[AUDIO_ENGINE_VOICES];
+// With polyphony the interrupt calls spent on a voice before the next one
+static uint16_t voice_calls[AUDIO_ENGINE_VOICES];
+static uint8_t  voice_place = 0;
+static uint16_t place = 0;
+static bool     polyphony = false;
+static float    polyphony_rate = 0;
+
+// The period sliding towards the voice, in 1/256 ticks
+static uint32_t glide_period = 0;
+static uint32_t glide_period_alt = 0;
+static bool     glissando = true;
+
+static uint16_t timbre = TIMBRE(TIMBRE_DEFAULT);
+
+// Counts interrupt calls since the note started, and the time since then at
+// 880 Hz like voice_envelope does
+static uint16_t envelope_index = 0;
+static uint16_t compensated_index = 0;
+static uint32_t compensated_ticks = 0;
+
+// The main loop converts song notes into the queue, and the interrupt takes
+// them from it. Each side only writes its own end of the queue.
+static volatile bool playing_song = false;
+static song_note_t song_queue[AUDIO_ENGINE_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_tail = 0;
+static volatile bool song_converted = false;
+
+static float (*song_notes)[][2];
+static uint16_t song_count;
+static uint16_t song_index;
+static bool     song_repeat;
+static uint8_t  song_tempo = TEMPO_DEFAULT;
+
+static uint8_t     song_state;
+static song_note_t song_note;
+static uint32_t    song_ticks;
+
+#ifdef VIBRATO_ENABLE
+static bool     vibrato_on = true;
+// The position in vibrato_period_lut in 1/4096ths, and how far it moves for
+// each call, some of which is scaled by the period
+static uint32_t vibrato_counter = 0;
+static uint16_t vibrato_rate = 0;
+static uint16_t vibrato_rate_scale = 0;
+#ifdef VIBRATO_STRENGTH_ENABLE
+static uint16_t vibrato_periods[VIBRATO_LUT_LENGTH];
+#else
+#define vibrato_periods vibrato_period_lut
+#endif
+#endif
+
+#ifdef AUDIO_VOICES
+static uint16_t noise = 1;
+#endif
+
+uint16_t audio_engine_period(float freq) {
+    if (freq < 30.517578125) {
+        freq = 30.52;
+    }
+    return (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
+}
+
+static void reset_envelope(void) {
+    envelope_index = 0;
+    compensated_index = 0;
+    compensated_ticks = 0;
+}
+
+static void update_voice_calls(void) {
+    polyphony = polyphony_rate > 0;
+    if (polyphony) {
+        for (uint8_t i = 0; i < voice_count; i++) {
+            voice_calls[i] = (uint16_t)(voice_freqs[i] / polyphony_rate / CPU_PRESCALER);
+        }
+    }
+}
+
+void audio_engine_stop(void) {
+    playing_note = false;
+    playing_song = false;
+    voice_count = 0;
+    glide_period = 0;
+    glide_period_alt = 0;
+    queue_head = queue_tail;
+}
+
+void audio_engine_note_on(float freq) {
+    playing_note = true;
+    reset_envelope();
+    if (freq > 0 && voice_count < AUDIO_ENGINE_VOICES) {
+        voice_freqs[voice_count] = freq;
+        voice_periods[voice_count] = audio_engine_period(freq);
+        voice_count++;
+        update_voice_calls();
+    }
+}
+
+uint8_t audio_engine_note_off(float freq) {
+    for (int8_t i = voice_count - 1; i >= 0; i--) {
+        if (voice_freqs[i] == freq) {
+            for (uint8_t j = i; j < voice_count - 1; j++) {
+                voice_freqs[j] = voice_freqs[j + 1];
+                voice_periods[j] = voice_periods[j + 1];
+                voice_calls[j] = voice_calls[j + 1];
+            }
+            break;
+        }
+    }
+    if (voice_count > 0) {
+        voice_count--;
+    }
+    if (voice_place >= voice_count) {
+        voice_place = 0;
+    }
+    if (voice_count == 0) {
+        glide_period = 0;
+        glide_period_alt = 0;
+        playing_note = false;
+    }
+    return voice_count;
+}
+
+uint8_t audio_engine_voices(void) {
+    return voice_count;
+}
+
+bool audio_engine_playing_note(void) {
+    return playing_note;
+}
+
+// Converts the next note, and works out what comes after it
+static void convert_song_note(song_note_t *note) {
+    float freq = (*song_notes)[song_index][0];
+    float length = ((*song_notes)[song_index][1] / 4) * (((float)song_tempo) / 100);
+    note->period = freq > 0 ? audio_engine_period(freq) : 0;
+    note->ticks = (uint32_t)ceilf(length * 0xFFFF);
+    if (note->ticks == 0) {
+        note->ticks = 1;
+    }
+
+    song_index++;
+    if (song_index >= song_count) {
+        if (!song_repeat) {
+            note->gap = GAP_NONE;
+            return;
+        }
+        song_index = 0;
+    }
+    note->gap = (*song_notes)[song_index][0] == freq ? GAP_SILENT : GAP_HOLD;
+}
+
+void audio_engine_task(void) {
+    while (playing_song && !song_converted &&
+           (uint8_t)(queue_tail - queue_head) < AUDIO_ENGINE_QUEUE_SIZE) {
+        song_note_t note;
+        convert_song_note(&note);
+        // The interrupt doesn't read the slot before queue_tail moves past it
+        song_note_t *slot = &song_queue[queue_tail & (AUDIO_ENGINE_QUEUE_SIZE - 1)];
+        *slot = note;
+        __asm__ __volatile__ ("" ::: "memory");
+        queue_tail++;
+        if (note.gap == GAP_NONE) {
+            song_converted = true;
+        }
+    }
+}
+
+void audio_engine_play_song(float (*notes)[][2], uint16_t count, bool repeat) {
+    if (count == 0) {
+        return;
+    }
+    song_notes = notes;
+    song_count = count;
+    song_index = 0;
+    song_repeat = repeat;
+    song_state = SONG_WAIT;
+    song_converted = false;
+    queue_head = queue_tail;
+    place = 0;
+    playing_song = true;
+    audio_engine_task();
+}
+
+bool audio_engine_playing_song(void) {
+    return playing_song;
+}
+
+void audio_engine_set_tempo(uint8_t tempo) {
+    song_tempo = tempo;
+}
+
+void audio_engine_set_timbre(float t) {
+    timbre = t >= 1 ? 0xFFFF : TIMBRE(t);
+}
+
+void audio_engine_set_polyphony_rate(float rate) {
+    polyphony_rate = rate;
+    update_voice_calls();
+}
+
+#ifdef VIBRATO_ENABLE
+void audio_engine_set_vibrato(float rate, float strength) {
+    vibrato_on = strength > 0;
+    float step = rate * 4096 + 0.5;
+    float scale = rate * 4096 * 440 / AUDIO_TIMER_HZ * 65536 + 0.5;
+    vibrato_rate = step > 0xFFFF ? 0xFFFF : (uint16_t)step;
+    vibrato_rate_scale = scale > 0xFFFF ? 0xFFFF : (uint16_t)scale;
+#ifdef VIBRATO_STRENGTH_ENABLE
+    for (uint8_t i = 0; i < VIBRATO_LUT_LENGTH; i++) {
+        vibrato_periods[i] = (uint16_t)(32768 / pow(vibrato_lut[i], strength) + 0.5);
+    }
+#endif
+}
+#endif
+
+// Everything below runs in the timer interrupt
+#pragma GCC poison float double
+
+// How much the period changes when gliding a quarter tone at 440 Hz, with
+// larger steps at lower notes like the original frequency based glissando.
+// Stepping the frequency by 2^(440 / f / 24) scales the period by about
+// 1 - period * ln(2) * 440 / 24 / AUDIO_TIMER_HZ. Returns 1/256 ticks.
+static uint32_t glide_step(uint16_t period) {
+    return ((uint32_t)period * GLIDE_SCALE >> 16) * period >> 8;
+}
+
+static uint16_t glide(uint32_t *current, uint16_t target) {
+    uint32_t target_256 = (uint32_t)target << 8;
+    if (glissando && *current != 0) {
+        uint32_t target_step = glide_step(target);
+        if (*current > target_256 + target_step) {
+            *current -= glide_step(*current >> 8);
+            return *current >> 8;
+        } else if (*current + target_step < target_256) {
+            *current += glide_step(*current >> 8);
+            return *current >> 8;
+        }
+    }
+    *current = target_256;
+    return target;
+}
+
+#ifdef VIBRATO_ENABLE
+static uint32_t vibrato(uint16_t period) {
+    if (!vibrato_on) {
+        return period;
+    }
+    uint32_t vibrated = (uint32_t)period * vibrato_periods[vibrato_counter >> 12] >> 15;
+    vibrato_counter += vibrato_rate + (((uint32_t)period * vibrato_rate_scale + 0x8000) >> 16);
+    while (vibrato_counter >= (uint32_t)VIBRATO_LUT_LENGTH << 12) {
+        vibrato_counter -= (uint32_t)VIBRATO_LUT_LENGTH << 12;
+    }
+    return vibrated;
+}
+#else
+#define vibrato(period) ((uint32_t)(period))
+#endif
+
+#ifdef AUDIO_VOICES
+// A random period between two frequencies
+static uint16_t noise_period(uint16_t shortest, uint16_t longest) {
+    noise ^= noise << 7;
+    noise ^= noise >> 9;
+    noise ^= noise << 8;
+    return shortest + ((uint32_t)noise * (longest - shortest) >> 16);
+}
+#endif
+
+// The same voices as voice_envelope, on the period instead of the frequency
+static uint32_t envelope(uint32_t period) {
+    // Every voice turns polyphony off again
+    polyphony = false;
+
+    switch (get_voice()) {
+        case default_voice:
+            glissando = false;
+            timbre = TIMBRE(TIMBRE_50);
+            break;
+
+    #ifdef AUDIO_VOICES
+
+        case something:
+            glissando = false;
+            if (compensated_index < 10) {
+                timbre = TIMBRE(TIMBRE_12);
+            } else if (compensated_index <= 200) {
+                timbre = TIMBRE(TIMBRE_25);
+            } else {
+                timbre = TIMBRE(TIMBRE_12);
+            }
+            break;
+
+        case drums:
+            glissando = false;
+            if (period > AUDIO_TIMER_HZ / 80) {
+
+            } else if (period > AUDIO_TIMER_HZ / 160) {
+                // Bass drum: 60 - 100 Hz
+                period = noise_period(AUDIO_TIMER_HZ / 100, AUDIO_TIMER_HZ / 60);
+                if (envelope_index <= 10) {
+                    timbre = TIMBRE(0.5);
+                } else if (envelope_index <= 20) {
+                    timbre = (21 - envelope_index) * (TIMBRE(0.5) / 10);
+                } else {
+                    timbre = 0;
+                }
+            } else if (period > AUDIO_TIMER_HZ / 320) {
+                // Snare drum: 1 - 2 KHz
+                period = noise_period(AUDIO_TIMER_HZ / 2000, AUDIO_TIMER_HZ / 1000);
+                if (envelope_index <= 5) {
+                    timbre = TIMBRE(0.5);
+                } else if (envelope_index <= 20) {
+                    timbre = (21 - envelope_index) * (TIMBRE(0.5) / 15);
+                } else {
+                    timbre = 0;
+                }
+            } else if (period > AUDIO_TIMER_HZ / 640) {
+                // Closed Hi-hat: 3 - 5 KHz
+                period = noise_period(AUDIO_TIMER_HZ / 5000, AUDIO_TIMER_HZ / 3000);
+                if (envelope_index <= 15) {
+                    timbre = TIMBRE(0.5);
+                } else if (envelope_index <= 20) {
+                    timbre = (21 - envelope_index) * (TIMBRE(0.5) / 5);
+                } else {
+                    timbre = 0;
+                }
+            } else if (period > AUDIO_TIMER_HZ / 1280) {
+                // Open Hi-hat: 3 - 5 KHz
+                period = noise_period(AUDIO_TIMER_HZ / 5000, AUDIO_TIMER_HZ / 3000);
+                if (envelope_index <= 35) {
+                    timbre = TIMBRE(0.5);
+                } else if (envelope_index <= 50) {
+                    timbre = (51 - envelope_index) * (TIMBRE(0.5) / 15);
+                } else {
+                    timbre = 0;
+                }
+            }
+            break;
+
+        case butts_fader:
+            glissando = true;
+            if (compensated_index < 10) {
+                period *= 4;
+                timbre = TIMBRE(TIMBRE_12);
+            } else if (compensated_index < 20) {
+                period *= 2;
+                timbre = TIMBRE(TIMBRE_12);
+            } else if (compensated_index <= 200) {
+                // .125 - ((index - 20) / 180)^2 * .125
+                uint16_t d = compensated_index - 20;
+                timbre = TIMBRE(TIMBRE_12) - ((uint32_t)d * d * 16570 >> 16);
+            } else {
+                timbre = 0;
+            }
+            break;
+
+        case duty_osc: {
+            // A triangle wave between .375 and .625
+            int16_t d = (compensated_index % 300) * 10 - 1500;
+            if (d < 0) {
+                d = -d;
+            }
+            timbre = TIMBRE(0.375) + ((uint32_t)d * 715828 >> 16);
+            glissando = true;
+            break;
+        }
+
+        case duty_octave_down:
+            glissando = true;
+            timbre = (envelope_index & 1) ? TIMBRE(0.875) : TIMBRE(0.75);
+            if ((envelope_index & 3) == 0)
+                timbre = TIMBRE(0.5);
+            if ((envelope_index & 7) == 0)
+                timbre = 0;
+            break;
+
+        case delayed_vibrato:
+            glissando = true;
+            timbre = TIMBRE(TIMBRE_50);
+            if (compensated_index > 150) {
+                period = period * vibrato_period_lut[(compensated_index - 151) / 20 % VIBRATO_LUT_LENGTH] >> 15;
+            }
+            break;
+
+    #endif
+
+        default:
+            break;
+    }
+
+    return period;
+}
+
+// Plays one period of a note
+static void render(audio_engine_output_t *output, uint32_t period) {
+    if (envelope_index < 0xFFFF) {
+        envelope_index++;
+    }
+    compensated_ticks += period * 880;
+    while (compensated_ticks >= AUDIO_TIMER_HZ) {
+        compensated_ticks -= AUDIO_TIMER_HZ;
+        if (compensated_index < 0xFFFF) {
+            compensated_index++;
+        }
+    }
+
+    period = envelope(period);
+    if (period > 0xFFFF) {
+        period = AUDIO_ENGINE_MAX_PERIOD;
+    }
+    output->period = period;
+    output->duty = period * timbre >> 16;
+    output->silent = false;
+}
+
+static void silence(audio_engine_output_t *output, uint16_t period) {
+    output->period = period;
+    output->duty = 0;
+    output->silent = true;
+}
+
+static uint8_t note_tick(audio_engine_output_t *output, audio_engine_output_t *alt) {
+    uint8_t updated = 0;
+
+    if (voice_count == 0) {
+        return 0;
+    }
+
+    if (alt && voice_count > 1) {
+        uint32_t period = AUDIO_ENGINE_MAX_PERIOD;
+        if (!polyphony) {
+            period = vibrato(glide(&glide_period_alt, voice_periods[voice_count - 2]));
+        }
+        render(alt, period);
+        updated |= AUDIO_ENGINE_ALT;
+    }
+
+    uint32_t period;
+    if (polyphony) {
+        if (voice_count > 1) {
+            voice_place %= voice_count;
+            if (place++ > voice_calls[voice_place]) {
+                voice_place = (voice_place + 1) % voice_count;
+                place = 0;
+            }
+        }
+        period = vibrato(voice_periods[voice_place]);
+    } else {
+        period = vibrato(glide(&glide_period, voice_periods[voice_count - 1]));
+    }
+    render(output, period);
+    return updated | AUDIO_ENGINE_OUTPUT;
+}
+
+static uint8_t song_tick(audio_engine_output_t *output) {
+    if (song_state == SONG_WAIT) {
+        if (queue_head == queue_tail) {
+            silence(output, WAIT_PERIOD);
+            return AUDIO_ENGINE_OUTPUT;
+        }
+        __asm__ __volatile__ ("" ::: "memory");
+        song_note = song_queue[queue_head & (AUDIO_ENGINE_QUEUE_SIZE - 1)];
+        __asm__ __volatile__ ("" ::: "memory");
+        queue_head++;
+        song_ticks = song_note.ticks;
+        song_state = SONG_NOTE;
+        reset_envelope();
+    }
+
+    if (song_state == SONG_GAP) {
+        if (song_note.gap == GAP_SILENT) {
+            silence(output, song_note.period);
+        } else {
+            render(output, vibrato(song_note.period));
+        }
+        song_state = SONG_WAIT;
+        return AUDIO_ENGINE_OUTPUT;
+    }
+
+    bool end_of_note;
+    if (song_note.period == 0) {
+        // A rest, the interrupt only comes back once it's over
+        uint16_t period = song_ticks > 0xFFFF ? 0xFFFF : song_ticks;
+        silence(output, period);
+        song_ticks -= period;
+        end_of_note = song_ticks == 0;
+    } else {
+        // The note ends when there's less than a period left
+        render(output, vibrato(song_note.period));
+        song_ticks = song_ticks > output->period ? song_ticks - output->period : 0;
+        end_of_note = song_ticks <= output->period;
+    }
+
+    if (end_of_note) {
+        if (song_note.gap == GAP_NONE) {
+            playing_song = false;
+            return AUDIO_ENGINE_OUTPUT | AUDIO_ENGINE_STOP;
+        }
+        song_state = song_note.period == 0 ? SONG_WAIT : SONG_GAP;
+    }
+    return AUDIO_ENGINE_OUTPUT;
+}
+
+uint8_t audio_engine_tick(audio_engine_output_t *output, audio_engine_output_t *alt) {
+    if (playing_note) {
+        return note_tick(output, alt);
+    }
+    if (playing_song) {
+        return song_tick(output);
+    }
+    return 0;
+}
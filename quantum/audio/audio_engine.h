@@ -0,0 +1,84 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AUDIO_ENGINE_H
+#define AUDIO_ENGINE_H
+
+// The sound generator behind the AVR audio timers. The timer interrupt fires
+// once per waveform period and calls audio_engine_tick for the next period
+// and duty cycle. Everything that needs floating point, like converting
+// frequencies and note lengths into timer ticks, is done from the main loop,
+// so the interrupt only does integer math.
+//
+// The timers make the square wave themselves, so there are no samples to
+// step a phase accumulator through. Pitch changes like glissando and vibrato
+// work on the timer period instead, which is reloaded once per waveform period.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CPU_PRESCALER 8
+#define AUDIO_TIMER_HZ ((uint32_t)(F_CPU / CPU_PRESCALER))
+
+// Notes below 30.52 Hz don't fit in the 16 bit timer and play at this period
+#define AUDIO_ENGINE_MAX_PERIOD ((uint16_t)(AUDIO_TIMER_HZ * 100 / 3052))
+
+// How many song notes are converted ahead of the one playing, a power of two
+#ifndef AUDIO_ENGINE_QUEUE_SIZE
+#   define AUDIO_ENGINE_QUEUE_SIZE 8
+#endif
+
+#define AUDIO_ENGINE_VOICES 8
+
+typedef struct {
+    uint16_t period;
+    uint16_t duty;
+    // The output should be disconnected until the next period
+    bool     silent;
+} audio_engine_output_t;
+
+// Returned by audio_engine_tick
+#define AUDIO_ENGINE_OUTPUT (1 << 0)  // output has a new period
+#define AUDIO_ENGINE_ALT    (1 << 1)  // alt has a new period
+#define AUDIO_ENGINE_STOP   (1 << 2)  // the song has ended
+
+// Called from the main loop, with the timer interrupts disabled unless
+// stated otherwise
+void audio_engine_stop(void);
+void audio_engine_note_on(float freq);
+// Returns the number of voices still playing
+uint8_t audio_engine_note_off(float freq);
+uint8_t audio_engine_voices(void);
+bool audio_engine_playing_note(void);
+void audio_engine_play_song(float (*notes)[][2], uint16_t count, bool repeat);
+bool audio_engine_playing_song(void);
+// Converts the next song notes, called on every scan with interrupts enabled
+void audio_engine_task(void);
+
+void audio_engine_set_tempo(uint8_t tempo);
+void audio_engine_set_timbre(float timbre);
+void audio_engine_set_polyphony_rate(float rate);
+#ifdef VIBRATO_ENABLE
+void audio_engine_set_vibrato(float rate, float strength);
+#endif
+
+// The timer period for a frequency
+uint16_t audio_engine_period(float freq);
+
+// Called from the timer interrupt, alt is the second output or NULL
+uint8_t audio_engine_tick(audio_engine_output_t *output, audio_engine_output_t *alt);
+
+#endif
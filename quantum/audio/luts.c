@@ -40,6 +40,30 @@ const float vibrato_lut[VIBRATO_LUT_LENGTH] =
 	1.0000000000000,
 };
 
+const uint16_t vibrato_period_lut[VIBRATO_LUT_LENGTH] =
+{
+	32695,
+	32629,
+	32577,
+	32544,
+	32532,
+	32544,
+	32577,
+	32629,
+	32695,
+	32768,
+	32841,
+	32907,
+	32960,
+	32994,
+	33005,
+	32994,
+	32960,
+	32907,
+	32841,
+	32768,
+};
+
 const uint16_t frequency_lut[FREQUENCY_LUT_LENGTH] =
 {
 	0x8E0B,
@@ -0,0 +1,534 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+extern "C" {
+#include "audio_engine.h"
+#include "musical_notes.h"
+#include "song_list.h"
+#include "voices.h"
+
+// Used by voice_envelope, which the original interrupt calls
+uint16_t envelope_index = 0;
+float note_timbre = TIMBRE_DEFAULT;
+float polyphony_rate = 0;
+bool glissando = true;
+}
+
+struct Period {
+    uint16_t period;
+    uint16_t duty;
+};
+
+// The TIMER3_COMPA_vect interrupt from before audio_engine.c, with the
+// timer registers replaced by icr and ocr
+class OriginalAudio {
+public:
+    uint16_t icr = 0;
+    uint16_t ocr = 0;
+    bool playing_notes = false;
+    bool playing_note = false;
+
+    OriginalAudio() {
+        envelope_index = 0;
+        note_timbre = TIMBRE_DEFAULT;
+        polyphony_rate = 0;
+        glissando = true;
+    }
+
+    void play_note(float freq) {
+        playing_note = true;
+        envelope_index = 0;
+        if (freq > 0) {
+            frequencies[voices] = freq;
+            voices++;
+        }
+    }
+
+    void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat) {
+        playing_notes = true;
+        notes_pointer = np;
+        notes_count = n_count;
+        notes_repeat = n_repeat;
+        place = 0;
+        current_note = 0;
+        note_frequency = (*notes_pointer)[current_note][0];
+        note_length = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
+        note_position = 0;
+    }
+
+    // Returns false when the interrupt disables itself
+    bool tick() {
+        float freq;
+
+        if (playing_note) {
+            if (voices > 0) {
+                if (polyphony_rate > 0) {
+                    if (voices > 1) {
+                        voice_place %= voices;
+                        if (place++ > (frequencies[voice_place] / polyphony_rate / CPU_PRESCALER)) {
+                            voice_place = (voice_place + 1) % voices;
+                            place = 0.0;
+                        }
+                    }
+                    freq = vibrato(frequencies[voice_place]);
+                } else {
+                    if (glissando) {
+                        if (frequency != 0 && frequency < frequencies[voices - 1] && frequency < frequencies[voices - 1] * pow(2, -440/frequencies[voices - 1]/12/2)) {
+                            frequency = frequency * pow(2, 440/frequency/12/2);
+                        } else if (frequency != 0 && frequency > frequencies[voices - 1] && frequency > frequencies[voices - 1] * pow(2, 440/frequencies[voices - 1]/12/2)) {
+                            frequency = frequency * pow(2, -440/frequency/12/2);
+                        } else {
+                            frequency = frequencies[voices - 1];
+                        }
+                    } else {
+                        frequency = frequencies[voices - 1];
+                    }
+                    freq = vibrato(frequency);
+                }
+
+                if (envelope_index < 65535) {
+                    envelope_index++;
+                }
+
+                freq = voice_envelope(freq);
+
+                if (freq < 30.517578125) {
+                    freq = 30.52;
+                }
+
+                icr = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
+                ocr = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
+            }
+        }
+
+        if (playing_notes) {
+            if (note_frequency > 0) {
+                freq = vibrato(note_frequency);
+                if (envelope_index < 65535) {
+                    envelope_index++;
+                }
+                freq = voice_envelope(freq);
+
+                icr = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
+                ocr = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre);
+            } else {
+                icr = 0;
+                ocr = 0;
+            }
+
+            note_position++;
+            bool end_of_note = false;
+            if (icr > 0) {
+                if (!note_resting)
+                    end_of_note = (note_position >= (note_length / icr * 0xFFFF - 1));
+                else
+                    end_of_note = (note_position >= (note_length));
+            } else {
+                end_of_note = (note_position >= (note_length));
+            }
+
+            if (end_of_note) {
+                current_note++;
+                if (current_note >= notes_count) {
+                    if (notes_repeat) {
+                        current_note = 0;
+                    } else {
+                        playing_notes = false;
+                        return false;
+                    }
+                }
+                if (!note_resting) {
+                    note_resting = true;
+                    current_note--;
+                    if ((*notes_pointer)[current_note][0] == (*notes_pointer)[current_note + 1][0]) {
+                        note_frequency = 0;
+                        note_length = 1;
+                    } else {
+                        note_frequency = (*notes_pointer)[current_note][0];
+                        note_length = 1;
+                    }
+                } else {
+                    note_resting = false;
+                    envelope_index = 0;
+                    note_frequency = (*notes_pointer)[current_note][0];
+                    note_length = ((*notes_pointer)[current_note][1] / 4) * (((float)note_tempo) / 100);
+                }
+
+                note_position = 0;
+            }
+        }
+        return true;
+    }
+
+private:
+    int voices = 0;
+    int voice_place = 0;
+    float frequency = 0;
+    float frequencies[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    float place = 0;
+    float note_frequency = 0;
+    float note_length = 0;
+    uint8_t note_tempo = TEMPO_DEFAULT;
+    uint16_t note_position = 0;
+    float (*notes_pointer)[][2];
+    uint16_t notes_count;
+    bool notes_repeat;
+    bool note_resting = false;
+    uint8_t current_note = 0;
+
+#ifdef VIBRATO_ENABLE
+    float vibrato_counter = 0;
+    float vibrato_rate = 0.125;
+
+    float vibrato(float average_freq) {
+        float vibrated_freq = average_freq * vibrato_lut[(int)vibrato_counter];
+        float r = fmod(vibrato_counter + vibrato_rate * (1.0 + 440.0/average_freq), VIBRATO_LUT_LENGTH);
+        vibrato_counter = r < 0 ? r + VIBRATO_LUT_LENGTH : r;
+        return vibrated_freq;
+    }
+#else
+    float vibrato(float freq) {
+        return freq;
+    }
+#endif
+};
+
+// The vibrato isn't tracked exactly, but stays within its depth
+#ifdef VIBRATO_ENABLE
+#define TOLERANCE(period, ticks) ((period) / 50 + (ticks))
+#else
+#define TOLERANCE(period, ticks) (ticks)
+#endif
+
+class AudioEngine : public testing::Test {
+public:
+    AudioEngine() {
+        audio_engine_stop();
+        audio_engine_set_tempo(TEMPO_DEFAULT);
+        audio_engine_set_polyphony_rate(0);
+#ifdef VIBRATO_ENABLE
+        audio_engine_set_vibrato(0.125, 0.5);
+#endif
+        set_voice(default_voice);
+    }
+
+    ~AudioEngine() {
+        audio_engine_stop();
+        set_voice(default_voice);
+    }
+
+    // Plays a song until it ends, with the main loop running between each period
+    std::vector<audio_engine_output_t> render_song(float (*notes)[][2], uint16_t count) {
+        std::vector<audio_engine_output_t> periods;
+        audio_engine_play_song(notes, count, false);
+        for (int i = 0; i < 1000000; i++) {
+            audio_engine_output_t output;
+            uint8_t updated = audio_engine_tick(&output, NULL);
+            EXPECT_TRUE(updated & AUDIO_ENGINE_OUTPUT);
+            periods.push_back(output);
+            if (updated & AUDIO_ENGINE_STOP) {
+                return periods;
+            }
+            audio_engine_task();
+        }
+        ADD_FAILURE() << "The song doesn't end";
+        return periods;
+    }
+
+    // Only the audible periods, the original can't be silent for any length of time
+    std::vector<Period> render_audible_song(float (*notes)[][2], uint16_t count) {
+        std::vector<Period> audible;
+        for (auto& output : render_song(notes, count)) {
+            if (!output.silent) {
+                audible.push_back({output.period, output.duty});
+            }
+        }
+        return audible;
+    }
+
+    std::vector<Period> render_original_song(float (*notes)[][2], uint16_t count) {
+        std::vector<Period> audible;
+        OriginalAudio original;
+        original.play_notes(notes, count, false);
+        while (original.tick()) {
+            if (original.icr != 0) {
+                audible.push_back({original.icr, original.ocr});
+            }
+        }
+        // The last period is written before the interrupt stops
+        if (original.icr != 0) {
+            audible.push_back({original.icr, original.ocr});
+        }
+        return audible;
+    }
+
+    void compare_song(float (*notes)[][2], uint16_t count) {
+        std::vector<Period> expected = render_original_song(notes, count);
+        std::vector<Period> actual = render_audible_song(notes, count);
+#ifdef VIBRATO_ENABLE
+        // The original ends a note after a number of periods that depends on
+        // the vibrato at the time, so only the total length can be compared
+        uint32_t expected_ticks = 0;
+        uint32_t actual_ticks = 0;
+        for (auto& p : expected) {
+            expected_ticks += p.period;
+        }
+        for (auto& p : actual) {
+            actual_ticks += p.period;
+        }
+        EXPECT_NEAR(actual_ticks, expected_ticks, expected_ticks / 100);
+#else
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            ASSERT_NEAR(actual[i].period, expected[i].period, 1) << "period " << i;
+            ASSERT_NEAR(actual[i].duty, expected[i].duty, 1) << "period " << i;
+        }
+#endif
+    }
+
+    // Float rounding in the original sometimes puts an envelope step that
+    // lands exactly on a boundary one period later, so a few periods can differ
+    void compare_note(voice_type voice, float freq, int periods, int ticks) {
+        set_voice(voice);
+        OriginalAudio original;
+        original.play_note(freq);
+        audio_engine_note_on(freq);
+        int different = 0;
+        for (int i = 0; i < periods; i++) {
+            audio_engine_output_t output;
+            EXPECT_EQ(audio_engine_tick(&output, NULL), AUDIO_ENGINE_OUTPUT);
+            original.tick();
+            EXPECT_FALSE(output.silent);
+            if (abs(output.period - original.icr) > TOLERANCE(original.icr, ticks) ||
+                abs(output.duty - original.ocr) > TOLERANCE(original.ocr, ticks)) {
+                different++;
+            }
+        }
+        EXPECT_LE(different, periods / 100) << "voice " << voice << " at " << freq << " Hz";
+        audio_engine_stop();
+    }
+};
+
+float ode_to_joy[][2] = SONG(ODE_TO_JOY);
+float imperial_march[][2] = SONG(IMPERIAL_MARCH);
+float startup_sound[][2] = SONG(STARTUP_SOUND);
+float goodbye_sound[][2] = SONG(GOODBYE_SOUND);
+float zelda_puzzle[][2] = SONG(ZELDA_PUZZLE);
+float one_up_sound[][2] = SONG(ONE_UP_SOUND);
+
+TEST_F(AudioEngine, PeriodsMatchTheFloatingPointConversion) {
+    for (float freq = 31; freq < 10000; freq *= 1.01) {
+        EXPECT_EQ(audio_engine_period(freq), (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER)));
+    }
+    EXPECT_EQ(audio_engine_period(20), AUDIO_ENGINE_MAX_PERIOD);
+}
+
+TEST_F(AudioEngine, NotesMatchTheOriginal) {
+    float notes[] = {NOTE_C4, NOTE_A4, NOTE_E5, NOTE_C7, NOTE_B2, 32, 5000};
+    for (float freq : notes) {
+        compare_note(default_voice, freq, 500, 1);
+    }
+}
+
+// With vibrato the original envelopes follow the vibrated frequency, so they
+// can only be compared without it
+#if defined(AUDIO_VOICES) && !defined(VIBRATO_ENABLE)
+TEST_F(AudioEngine, VoicesMatchTheOriginal) {
+    // At these frequencies both the period and the 880 Hz envelope time are
+    // exact, so the envelopes change on the same periods
+    voice_type voices[] = {something, butts_fader, duty_osc, duty_octave_down, delayed_vibrato};
+    for (voice_type voice : voices) {
+        compare_note(voice, 320, 3000, 3);
+        compare_note(voice, 640, 3000, 3);
+    }
+}
+#endif
+
+#ifdef AUDIO_VOICES
+
+TEST_F(AudioEngine, DrumsStayInTheirRange) {
+    set_voice(drums);
+    audio_engine_note_on(NOTE_C3);
+    for (int i = 0; i < 30; i++) {
+        audio_engine_output_t output;
+        audio_engine_tick(&output, NULL);
+        EXPECT_GE(output.period, AUDIO_TIMER_HZ / 100);
+        EXPECT_LE(output.period, AUDIO_TIMER_HZ / 60);
+        if (i < 10) {
+            EXPECT_EQ(output.duty, output.period / 2);
+        } else if (i >= 20) {
+            EXPECT_EQ(output.duty, 0);
+        }
+    }
+}
+
+TEST_F(AudioEngine, GlissandoTakesAsLongAsTheOriginal) {
+    // Both glide in steps of about a quarter tone at 440 Hz, the integer
+    // version uses the first order approximation of the step
+    set_voice(duty_octave_down);
+    OriginalAudio original;
+    original.play_note(320);
+    audio_engine_note_on(320);
+    audio_engine_output_t output;
+    for (int i = 0; i < 10; i++) {
+        original.tick();
+        audio_engine_tick(&output, NULL);
+    }
+    original.play_note(1280);
+    audio_engine_note_on(1280);
+
+    int original_periods = 0;
+    do {
+        original.tick();
+        original_periods++;
+    } while (original.icr > 1562 + TOLERANCE(1562, 0));
+    int periods = 0;
+    uint16_t last_period = 0xFFFF;
+    do {
+        audio_engine_tick(&output, NULL);
+        periods++;
+        EXPECT_LE(output.period, last_period + TOLERANCE(last_period, 0));
+        last_period = output.period;
+    } while (output.period > 1562 + TOLERANCE(1562, 0));
+
+    EXPECT_GT(original_periods, 10);
+    EXPECT_NEAR(periods, original_periods, original_periods / 20 + 1);
+}
+#endif
+
+#ifdef VIBRATO_ENABLE
+TEST_F(AudioEngine, VibratoGoesThroughItsWholeDepth) {
+    audio_engine_note_on(NOTE_A4);
+    uint16_t period = audio_engine_period(NOTE_A4);
+    uint16_t shortest = 0xFFFF;
+    uint16_t longest = 0;
+    for (int i = 0; i < 2000; i++) {
+        audio_engine_output_t output;
+        audio_engine_tick(&output, NULL);
+        shortest = std::min(shortest, output.period);
+        longest = std::max(longest, output.period);
+    }
+    EXPECT_NEAR(shortest, period / 1.0072464122237, 1);
+    EXPECT_NEAR(longest, period / 0.9928057204913, 1);
+}
+#endif
+
+TEST_F(AudioEngine, SongsMatchTheOriginal) {
+    compare_song(&ode_to_joy, sizeof(ode_to_joy) / sizeof(ode_to_joy[0]));
+    compare_song(&imperial_march, sizeof(imperial_march) / sizeof(imperial_march[0]));
+    compare_song(&startup_sound, sizeof(startup_sound) / sizeof(startup_sound[0]));
+    compare_song(&goodbye_sound, sizeof(goodbye_sound) / sizeof(goodbye_sound[0]));
+    compare_song(&zelda_puzzle, sizeof(zelda_puzzle) / sizeof(zelda_puzzle[0]));
+}
+
+TEST_F(AudioEngine, RestsAreSilentForTheirLength) {
+    float song[][2] = {Q__NOTE(_C4), H__NOTE(_REST), Q__NOTE(_E4)};
+    uint32_t silent_ticks = 0;
+    for (auto& output : render_song(&song, 3)) {
+        if (output.silent) {
+            silent_ticks += output.period;
+            EXPECT_EQ(output.duty, 0);
+        }
+    }
+    EXPECT_EQ(silent_ticks, 8 * 0xFFFF);
+}
+
+TEST_F(AudioEngine, RepeatedNotesAreSeparated) {
+    float song[][2] = {E__NOTE(_C4), E__NOTE(_C4)};
+    std::vector<audio_engine_output_t> periods = render_song(&song, 2);
+    int silent = 0;
+    for (size_t i = 0; i < periods.size(); i++) {
+        if (periods[i].silent) {
+            EXPECT_EQ(periods[i].period, audio_engine_period(NOTE_C4));
+            silent++;
+        }
+    }
+    EXPECT_EQ(silent, 1);
+}
+
+TEST_F(AudioEngine, SongsWaitForTheMainLoop) {
+    float song[][2] = {
+        S__NOTE(_C4), S__NOTE(_D4), S__NOTE(_E4), S__NOTE(_F4), S__NOTE(_G4),
+        S__NOTE(_A4), S__NOTE(_B4), S__NOTE(_C5), S__NOTE(_D5), S__NOTE(_E5),
+    };
+    audio_engine_play_song(&song, 10, false);
+    audio_engine_output_t output;
+    uint16_t c5 = audio_engine_period(NOTE_C5);
+    int i = 0;
+    do {
+        ASSERT_EQ(audio_engine_tick(&output, NULL), AUDIO_ENGINE_OUTPUT);
+        ASSERT_LT(i++, 1000);
+    } while (abs(output.period - c5) > TOLERANCE(c5, 0));
+    // Only the queued notes are played, then it waits
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(audio_engine_tick(&output, NULL), AUDIO_ENGINE_OUTPUT);
+    }
+    EXPECT_TRUE(output.silent);
+    EXPECT_EQ(output.period, AUDIO_TIMER_HZ / 1000);
+
+    audio_engine_task();
+    audio_engine_tick(&output, NULL);
+    EXPECT_FALSE(output.silent);
+    EXPECT_NEAR(output.period, audio_engine_period(NOTE_D5), TOLERANCE(output.period, 0));
+    EXPECT_TRUE(audio_engine_playing_song());
+}
+
+TEST_F(AudioEngine, RepeatedSongsStartOver) {
+    float song[][2] = {E__NOTE(_C4), E__NOTE(_E4)};
+    audio_engine_play_song(&song, 2, true);
+    std::vector<uint16_t> notes;
+    for (int i = 0; i < 100000; i++) {
+        audio_engine_output_t output;
+        ASSERT_EQ(audio_engine_tick(&output, NULL), AUDIO_ENGINE_OUTPUT);
+        if (notes.empty() || abs(notes.back() - output.period) > TOLERANCE(output.period, 0)) {
+            notes.push_back(output.period);
+        }
+        audio_engine_task();
+    }
+    ASSERT_GT(notes.size(), 6);
+    for (size_t i = 0; i < 6; i++) {
+        EXPECT_NEAR(notes[i], audio_engine_period(i % 2 ? NOTE_E4 : NOTE_C4), TOLERANCE(notes[i], 0));
+    }
+}
+
+TEST_F(AudioEngine, StoppedNotesGoBackToThePreviousOne) {
+    audio_engine_note_on(NOTE_C4);
+    audio_engine_note_on(NOTE_E4);
+    audio_engine_output_t output;
+    audio_engine_tick(&output, NULL);
+    EXPECT_NEAR(output.period, audio_engine_period(NOTE_E4), TOLERANCE(output.period, 0));
+    EXPECT_EQ(audio_engine_note_off(NOTE_E4), 1);
+    audio_engine_tick(&output, NULL);
+    EXPECT_NEAR(output.period, audio_engine_period(NOTE_C4), TOLERANCE(output.period, 0));
+    EXPECT_EQ(audio_engine_note_off(NOTE_C4), 0);
+    EXPECT_EQ(audio_engine_tick(&output, NULL), 0);
+}
+
+TEST_F(AudioEngine, TheSecondVoiceGoesToTheAltOutput) {
+    audio_engine_note_on(NOTE_C4);
+    audio_engine_output_t output, alt;
+    EXPECT_EQ(audio_engine_tick(&output, &alt), AUDIO_ENGINE_OUTPUT);
+    audio_engine_note_on(NOTE_E4);
+    EXPECT_EQ(audio_engine_tick(&output, &alt), AUDIO_ENGINE_OUTPUT | AUDIO_ENGINE_ALT);
+    EXPECT_NEAR(output.period, audio_engine_period(NOTE_E4), TOLERANCE(output.period, 0));
+    EXPECT_NEAR(alt.period, audio_engine_period(NOTE_C4), TOLERANCE(alt.period, 0));
+}
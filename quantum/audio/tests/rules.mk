@@ -0,0 +1,15 @@
+AUDIO_ENGINE_COMMON_DEFS := -DF_CPU=16000000UL -DAUDIO_VOICES
+AUDIO_ENGINE_COMMON_INC := $(QUANTUM_PATH)/audio
+AUDIO_ENGINE_COMMON_SRC := \
+	$(QUANTUM_PATH)/audio/tests/audio_engine_tests.cpp \
+	$(QUANTUM_PATH)/audio/audio_engine.c \
+	$(QUANTUM_PATH)/audio/voices.c \
+	$(QUANTUM_PATH)/audio/luts.c
+
+audio_engine_DEFS := $(AUDIO_ENGINE_COMMON_DEFS)
+audio_engine_INC := $(AUDIO_ENGINE_COMMON_INC)
+audio_engine_SRC := $(AUDIO_ENGINE_COMMON_SRC)
+
+audio_engine_vibrato_DEFS := $(AUDIO_ENGINE_COMMON_DEFS) -DVIBRATO_ENABLE
+audio_engine_vibrato_INC := $(AUDIO_ENGINE_COMMON_INC)
+audio_engine_vibrato_SRC := $(AUDIO_ENGINE_COMMON_SRC)
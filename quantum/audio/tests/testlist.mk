@@ -0,0 +1,3 @@
+TEST_LIST +=\
+	audio_engine\
+	audio_engine_vibrato
@@ -13,8 +13,9 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <math.h>
 #include "voices.h"
-#include "audio.h"
+#include "musical_notes.h"
 #include "stdlib.h"
 
 // these are imported from audio.c
@@ -29,6 +30,10 @@ void set_voice(voice_type v) {
     voice = v;
 }
 
+voice_type get_voice(void) {
+    return voice;
+}
+
 void voice_iterate() {
     voice = (voice + 1) % number_of_voices;
 }
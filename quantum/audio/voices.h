@@ -46,6 +46,7 @@ typedef enum {
 } voice_type;
 
 void set_voice(voice_type v);
+voice_type get_voice(void);
 void voice_iterate(void);
 void voice_deiterate(void);
 
@@ -0,0 +1,53 @@
+/*
+Copyright 2026 agent
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/* Debounce time in milliseconds, set 0 if debouncing isn't needed */
+#ifndef DEBOUNCING_DELAY
+#   define DEBOUNCING_DELAY 5
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The debounce algorithm is selected with DEBOUNCE_TYPE in rules.mk
+ *   sym_g        - global deferred, any change restarts a single timer for the whole matrix (default)
+ *   eager_pk     - per key eager, a change is reported immediately, then the key is locked for DEBOUNCING_DELAY
+ *   sym_defer_pr - per row deferred, a row is reported once it has been stable for DEBOUNCING_DELAY
+ *   custom       - the keyboard provides its own implementation
+ */
+void debounce_init(void);
+
+/* raw is the matrix as read during this scan, changed tells if it differs from the previous scan.
+ * cooked is the debounced matrix, which is updated in place. */
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed);
+
+/* true while there are changes that haven't settled yet */
+bool debounce_active(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+/*
+Copyright 2026 agent
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Per key eager debouncing.
+ * A change of a key is reported immediately, after which the key is locked
+ * for DEBOUNCING_DELAY milliseconds, so that the bouncing is ignored. Other
+ * keys are not affected by the lock.
+ */
+
+#include "debounce.h"
+#include "timer.h"
+
+#if (DEBOUNCING_DELAY > 255)
+#   error "DEBOUNCING_DELAY has to fit the 8-bit per key counters of eager_pk"
+#endif
+
+#if (MATRIX_COLS <= 8)
+#    define ROW_SHIFTER ((uint8_t)1)
+#elif (MATRIX_COLS <= 16)
+#    define ROW_SHIFTER ((uint16_t)1)
+#elif (MATRIX_COLS <= 32)
+#    define ROW_SHIFTER  ((uint32_t)1)
+#endif
+
+// The remaining lock time of each key in milliseconds, 0 when the key is free to change
+static uint8_t debounce_counters[MATRIX_ROWS * MATRIX_COLS];
+static bool counters_active = false;
+static uint16_t last_time;
+
+static void update_counters(uint8_t elapsed) {
+    bool active = false;
+    uint8_t *counter = debounce_counters;
+    for (uint16_t i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++, counter++) {
+        if (*counter) {
+            *counter = *counter > elapsed ? *counter - elapsed : 0;
+            active |= *counter != 0;
+        }
+    }
+    counters_active = active;
+}
+
+static void commit_free_keys(matrix_row_t raw[], matrix_row_t cooked[]) {
+    uint8_t *counter = debounce_counters;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        if (!delta) {
+            counter += MATRIX_COLS;
+            continue;
+        }
+        for (uint8_t col = 0; col < MATRIX_COLS; col++, counter++) {
+            matrix_row_t col_mask = ROW_SHIFTER << col;
+            if ((delta & col_mask) && *counter == 0) {
+                cooked[row] ^= col_mask;
+#if (DEBOUNCING_DELAY > 0)
+                *counter = DEBOUNCING_DELAY;
+                counters_active = true;
+#endif
+            }
+        }
+    }
+}
+
+void debounce_init(void) {
+    for (uint16_t i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++) {
+        debounce_counters[i] = 0;
+    }
+    counters_active = false;
+    last_time = timer_read();
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
+    uint16_t now = timer_read();
+    if (counters_active) {
+        uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+        if (elapsed) {
+            update_counters(elapsed > 255 ? 255 : elapsed);
+            // A key that got free might differ from the raw state, even if nothing changed this scan
+            changed = true;
+        }
+    }
+    last_time = now;
+
+    if (changed) {
+        commit_free_keys(raw, cooked);
+    }
+}
+
+bool debounce_active(void) {
+    return counters_active;
+}
@@ -0,0 +1,88 @@
+/*
+Copyright 2026 agent
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Per row deferred debouncing.
+ * Each row has its own timer, which is restarted by any change on that row.
+ * A row is reported once it has been stable for DEBOUNCING_DELAY milliseconds,
+ * so a bouncing key only delays the keys sharing its row.
+ */
+
+#include "debounce.h"
+#include "timer.h"
+
+#if (DEBOUNCING_DELAY > 255)
+#   error "DEBOUNCING_DELAY has to fit the 8-bit per row counters of sym_defer_pr"
+#endif
+
+// The remaining time until each row is reported in milliseconds, 0 when the row is settled
+static uint8_t debounce_counters[MATRIX_ROWS];
+// The raw state of the previous scan, used to find the rows that changed
+static matrix_row_t raw_prev[MATRIX_ROWS];
+static bool counters_active = false;
+static uint16_t last_time;
+
+void debounce_init(void) {
+    for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+        debounce_counters[i] = 0;
+        raw_prev[i] = 0;
+    }
+    counters_active = false;
+    last_time = timer_read();
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], bool changed) {
+    uint16_t now = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+    last_time = now;
+
+    if (!changed && !counters_active) {
+        return;
+    }
+    if (elapsed > 255) {
+        elapsed = 255;
+    }
+
+    bool active = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        uint8_t *counter = &debounce_counters[row];
+        if (raw[row] != raw_prev[row]) {
+            raw_prev[row] = raw[row];
+#if (DEBOUNCING_DELAY > 0)
+            // The first scan after the change already counts, like with the global timer
+            *counter = DEBOUNCING_DELAY + 1;
+            active = true;
+            continue;
+#else
+            cooked[row] = raw[row];
+#endif
+        }
+        if (*counter) {
+            *counter = *counter > elapsed ? *counter - elapsed : 0;
+            if (*counter == 0) {
+                cooked[row] = raw[row];
+            } else {
+                active = true;
+            }
+        }
+    }
+    counters_active = active;
+}
+
+bool debounce_active(void) {
+    return counters_active;
+}
@@ -0,0 +1,68 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+#include <string.h>
+
+extern "C" {
+#include "debounce.h"
+#include "timer.h"
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+static void keys_to_matrix(const std::vector<MatrixTestKey>& keys, matrix_row_t matrix[]) {
+    memset(matrix, 0, sizeof(matrix_row_t) * MATRIX_ROWS);
+    for (auto& key : keys) {
+        matrix[key.row] |= (matrix_row_t)1 << key.col;
+    }
+}
+
+void DebounceTest::addEvents(std::initializer_list<MatrixTestEvent> events) {
+    trace.insert(trace.end(), events);
+}
+
+void DebounceTest::runTrace() {
+    matrix_row_t raw[MATRIX_ROWS] = {};
+    matrix_row_t cooked[MATRIX_ROWS] = {};
+    set_time(0);
+    debounce_init();
+
+    uint32_t time = 0;
+    auto event = trace.begin();
+    while (event != trace.end()) {
+        bool changed = false;
+        if (event->time == time) {
+            matrix_row_t new_raw[MATRIX_ROWS];
+            keys_to_matrix(event->raw, new_raw);
+            changed = memcmp(raw, new_raw, sizeof(raw)) != 0;
+            memcpy(raw, new_raw, sizeof(raw));
+        }
+
+        debounce(raw, cooked, changed);
+
+        if (event->time == time) {
+            matrix_row_t expected[MATRIX_ROWS];
+            keys_to_matrix(event->expected, expected);
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                EXPECT_EQ(cooked[row], expected[row]) << "at time " << time << ", row " << (int)row;
+            }
+            ++event;
+        }
+        time++;
+        advance_time(1);
+    }
+}
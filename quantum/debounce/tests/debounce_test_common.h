@@ -0,0 +1,47 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gtest/gtest.h"
+#include <initializer_list>
+#include <vector>
+
+extern "C" {
+#include "matrix.h"
+}
+
+struct MatrixTestKey {
+    uint8_t row;
+    uint8_t col;
+};
+
+// One step of a recorded bounce trace. From `time` on the switches read as `raw`,
+// and after the scan at `time` the debounced matrix has to contain exactly `expected`.
+struct MatrixTestEvent {
+    uint32_t time;
+    std::vector<MatrixTestKey> raw;
+    std::vector<MatrixTestKey> expected;
+};
+
+// Runs the debounce algorithm linked into the test once per millisecond through the trace
+class DebounceTest : public ::testing::Test {
+protected:
+    void addEvents(std::initializer_list<MatrixTestEvent> events);
+    void runTrace();
+
+    std::vector<MatrixTestEvent> trace;
+};
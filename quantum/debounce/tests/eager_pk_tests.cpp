@@ -0,0 +1,72 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+
+// Per key eager debouncing with DEBOUNCING_DELAY 5
+
+TEST_F(DebounceTest, OneKeyShort) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {{0, 1}}},
+        {10, {}, {}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, BouncingPressIsReportedImmediately) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {{0, 1}}},
+        {1, {}, {{0, 1}}},
+        {2, {{0, 1}}, {{0, 1}}},
+        {3, {}, {{0, 1}}},
+        {4, {{0, 1}}, {{0, 1}}},
+        {20, {{0, 1}}, {{0, 1}}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, ChangeDuringLockIsReportedWhenTheLockExpires) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {{0, 1}}},
+        {1, {}, {{0, 1}}},
+        {4, {}, {{0, 1}}},
+        {5, {}, {}},
+        // The release locks the key again
+        {6, {{0, 1}}, {}},
+        {10, {{0, 1}}, {{0, 1}}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, BouncingKeyDoesNotDelayOtherKeys) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {{0, 1}}},
+        {1, {}, {{0, 1}}},
+        {2, {{0, 1}, {0, 2}}, {{0, 1}, {0, 2}}},
+        {3, {{0, 2}, {3, 5}}, {{0, 1}, {0, 2}, {3, 5}}},
+        {4, {{0, 1}, {0, 2}, {3, 5}}, {{0, 1}, {0, 2}, {3, 5}}},
+        {20, {{0, 1}, {0, 2}, {3, 5}}, {{0, 1}, {0, 2}, {3, 5}}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, LongPressIsReleasedImmediately) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{2, 9}}, {{2, 9}}},
+        {1000, {}, {}},
+    });
+    runTrace();
+}
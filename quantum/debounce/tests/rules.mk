@@ -0,0 +1,19 @@
+DEBOUNCE_COMMON_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -DDEBOUNCING_DELAY=5
+
+DEBOUNCE_COMMON_SRC := $(QUANTUM_PATH)/debounce/tests/debounce_test_common.cpp \
+	$(TMK_PATH)/common/test/timer.c
+
+debounce_sym_g_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_g_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_g.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_g_tests.cpp
+
+debounce_eager_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_eager_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/eager_pk.c \
+	$(QUANTUM_PATH)/debounce/tests/eager_pk_tests.cpp
+
+debounce_sym_defer_pr_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_pr_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pr.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pr_tests.cpp
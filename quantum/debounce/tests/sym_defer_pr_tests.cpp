@@ -0,0 +1,68 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+
+// Per row deferred debouncing with DEBOUNCING_DELAY 5
+
+TEST_F(DebounceTest, OneKeyShort) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {}},
+        {5, {{0, 1}}, {}},
+        {6, {{0, 1}}, {{0, 1}}},
+        {10, {}, {{0, 1}}},
+        {16, {}, {}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, BouncingPressIsReportedOnceStable) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {}},
+        {1, {}, {}},
+        {2, {{0, 1}}, {}},
+        {3, {}, {}},
+        {4, {{0, 1}}, {}},
+        {9, {{0, 1}}, {}},
+        {10, {{0, 1}}, {{0, 1}}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, BouncingKeyDoesNotDelayOtherRows) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {}},
+        {1, {{3, 5}}, {}},
+        {2, {{0, 1}, {3, 5}}, {}},
+        {3, {{3, 5}}, {}},
+        {4, {{0, 1}, {3, 5}}, {}},
+        {7, {{0, 1}, {3, 5}}, {{3, 5}}},
+        {10, {{0, 1}, {3, 5}}, {{0, 1}, {3, 5}}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, BouncingKeyDelaysItsOwnRow) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{1, 0}}, {}},
+        {2, {{1, 0}, {1, 7}}, {}},
+        {3, {{1, 0}}, {}},
+        {4, {{1, 0}, {1, 7}}, {}},
+        {6, {{1, 0}, {1, 7}}, {}},
+        {10, {{1, 0}, {1, 7}}, {{1, 0}, {1, 7}}},
+    });
+    runTrace();
+}
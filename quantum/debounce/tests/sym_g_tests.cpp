@@ -0,0 +1,66 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+
+// Global deferred debouncing with DEBOUNCING_DELAY 5
+
+TEST_F(DebounceTest, OneKeyShort) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {}},
+        {5, {{0, 1}}, {}},
+        {6, {{0, 1}}, {{0, 1}}},
+        {10, {}, {{0, 1}}},
+        {16, {}, {}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, BouncingPressIsReportedOnceStable) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {}},
+        {1, {}, {}},
+        {2, {{0, 1}}, {}},
+        {3, {}, {}},
+        {4, {{0, 1}}, {}},
+        {9, {{0, 1}}, {}},
+        {10, {{0, 1}}, {{0, 1}}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, BouncingKeyDelaysAllOtherKeys) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{0, 1}}, {}},
+        {2, {{0, 1}, {3, 5}}, {}},
+        {3, {{0, 1}}, {}},
+        {4, {{0, 1}, {3, 5}}, {}},
+        {6, {{0, 1}, {3, 5}}, {}},
+        {10, {{0, 1}, {3, 5}}, {{0, 1}, {3, 5}}},
+    });
+    runTrace();
+}
+
+TEST_F(DebounceTest, ReleaseShorterThanDelayIsIgnored) {
+    addEvents({ /* Time, Inputs, Outputs */
+        {0, {{1, 2}}, {}},
+        {6, {{1, 2}}, {{1, 2}}},
+        {10, {}, {{1, 2}}},
+        {12, {{1, 2}}, {{1, 2}}},
+        {18, {{1, 2}}, {{1, 2}}},
+    });
+    runTrace();
+}
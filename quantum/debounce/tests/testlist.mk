@@ -0,0 +1,4 @@
+TEST_LIST +=\
+	debounce_sym_g\
+	debounce_eager_pk\
+	debounce_sym_defer_pr
@@ -49,6 +49,9 @@ uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
 // translates function id to action
 uint16_t keymap_function_id_to_action( uint16_t function_id );
 
+// translates keycode to action, without the keymap_config remapping
+action_t keymap_keycode_to_action(uint16_t keycode);
+
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
 extern const uint16_t fn_actions[];
 
@@ -37,6 +37,28 @@ extern keymap_config_t keymap_config;
 
 #include <inttypes.h>
 
+/* converts a basic keycode to an action at compile time */
+#define BASIC_ACTION(kc) ( \
+    IS_KEY(kc) || IS_MOD(kc) ? ACTION_KEY(kc) : \
+    IS_SYSTEM(kc)            ? ACTION_USAGE_SYSTEM(KEYCODE2SYSTEM(kc)) : \
+    IS_CONSUMER(kc)          ? ACTION_USAGE_CONSUMER(KEYCODE2CONSUMER(kc)) : \
+    IS_MOUSEKEY(kc)          ? ACTION_MOUSEKEY(kc) : \
+    (kc) == KC_TRNS          ? ACTION_TRANSPARENT : \
+                               ACTION_NO)
+#define BASIC_ACTIONS_4(kc)   BASIC_ACTION(kc), BASIC_ACTION((kc) + 1), \
+                              BASIC_ACTION((kc) + 2), BASIC_ACTION((kc) + 3)
+#define BASIC_ACTIONS_16(kc)  BASIC_ACTIONS_4(kc), BASIC_ACTIONS_4((kc) + 4), \
+                              BASIC_ACTIONS_4((kc) + 8), BASIC_ACTIONS_4((kc) + 12)
+#define BASIC_ACTIONS_64(kc)  BASIC_ACTIONS_16(kc), BASIC_ACTIONS_16((kc) + 16), \
+                              BASIC_ACTIONS_16((kc) + 32), BASIC_ACTIONS_16((kc) + 48)
+
+/* The actions of all the basic keycodes, except for KC_FN0 - KC_FN31 which
+ * are read from fn_actions at runtime */
+static const uint16_t PROGMEM basic_actions[QK_TMK_MAX + 1] = {
+    BASIC_ACTIONS_64(0x00), BASIC_ACTIONS_64(0x40),
+    BASIC_ACTIONS_64(0x80), BASIC_ACTIONS_64(0xC0)
+};
+
 /* converts key to action */
 action_t action_for_key(uint8_t layer, keypos_t key)
 {
@@ -46,29 +68,25 @@ action_t action_for_key(uint8_t layer, keypos_t key)
     // keycode remapping
     keycode = keycode_config(keycode);
 
+    return keymap_keycode_to_action(keycode);
+}
+
+/* converts keycode to action */
+action_t keymap_keycode_to_action(uint16_t keycode)
+{
     action_t action;
     uint8_t action_layer, when, mod;
 
-    switch (keycode) {
-        case KC_FN0 ... KC_FN31:
+    if (keycode <= QK_TMK_MAX) {
+        if (IS_FN(keycode)) {
             action.code = keymap_function_id_to_action(FN_INDEX(keycode));
-            break;
-        case KC_A ... KC_EXSEL:
-        case KC_LCTRL ... KC_RGUI:
-            action.code = ACTION_KEY(keycode);
-            break;
-        case KC_SYSTEM_POWER ... KC_SYSTEM_WAKE:
-            action.code = ACTION_USAGE_SYSTEM(KEYCODE2SYSTEM(keycode));
-            break;
-        case KC_AUDIO_MUTE ... KC_MEDIA_REWIND:
-            action.code = ACTION_USAGE_CONSUMER(KEYCODE2CONSUMER(keycode));
-            break;
-        case KC_MS_UP ... KC_MS_ACCEL2:
-            action.code = ACTION_MOUSEKEY(keycode);
-            break;
-        case KC_TRNS:
-            action.code = ACTION_TRANSPARENT;
-            break;
+        } else {
+            action.code = pgm_read_word(&basic_actions[keycode]);
+        }
+        return action;
+    }
+
+    switch (keycode) {
         case QK_MODS ... QK_MODS_MAX: ;
             // Has a modifier
             // Split it up
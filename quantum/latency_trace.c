@@ -0,0 +1,208 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "latency_trace.h"
+#include "timer.h"
+#include "print.h"
+#include <string.h>
+
+#ifndef LATENCY_TRACE_BUFFER_SIZE
+#   define LATENCY_TRACE_BUFFER_SIZE 32
+#endif
+
+#if (LATENCY_TRACE_BUFFER_SIZE & (LATENCY_TRACE_BUFFER_SIZE - 1)) != 0 || LATENCY_TRACE_BUFFER_SIZE > 256
+#   error "LATENCY_TRACE_BUFFER_SIZE has to be a power of two, and at most 256"
+#endif
+
+// Set to 0 to only print on demand with latency_trace_print
+#ifndef LATENCY_TRACE_PRINT_INTERVAL
+#   define LATENCY_TRACE_PRINT_INTERVAL 10000
+#endif
+
+typedef struct {
+    uint32_t time;
+    uint8_t probe;
+} trace_entry_t;
+
+static trace_entry_t trace_buffer[LATENCY_TRACE_BUFFER_SIZE];
+static uint8_t trace_head;
+static uint8_t trace_tail;
+static uint16_t trace_overflows;
+
+static latency_stats_t stats[NUM_LATENCY_METRICS];
+
+static bool scan_started;
+static uint32_t scan_start_time;
+// The oldest event that hasn't been processed or reported yet
+static bool event_pending_process;
+static uint32_t event_process_time;
+static bool event_pending_report;
+static uint32_t event_report_time;
+
+#if LATENCY_TRACE_PRINT_INTERVAL > 0
+static uint32_t last_print_time;
+#endif
+
+void latency_trace_probe(latency_trace_probe_t probe) {
+    uint8_t next = (trace_head + 1) & (LATENCY_TRACE_BUFFER_SIZE - 1);
+    if (next == trace_tail) {
+        trace_overflows++;
+        return;
+    }
+    trace_buffer[trace_head].time = timer_read_us();
+    trace_buffer[trace_head].probe = probe;
+    trace_head = next;
+}
+
+static uint8_t get_bucket(uint32_t value) {
+    uint8_t bucket = 0;
+    value >>= 4;
+    while (value && bucket < LATENCY_TRACE_BUCKETS - 1) {
+        value >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static void add_sample(latency_metric_t metric, uint32_t value) {
+    latency_stats_t* s = &stats[metric];
+    if (s->count == 0 || value < s->min) {
+        s->min = value;
+    }
+    if (value > s->max) {
+        s->max = value;
+    }
+    s->count++;
+    s->sum += value;
+    uint16_t* bucket = &s->histogram[get_bucket(value)];
+    if (*bucket < UINT16_MAX) {
+        (*bucket)++;
+    }
+}
+
+static void handle_entry(const trace_entry_t* entry) {
+    switch (entry->probe) {
+        case TRACE_SCAN_START:
+            if (scan_started) {
+                add_sample(LATENCY_SCAN_PERIOD, entry->time - scan_start_time);
+            }
+            scan_started = true;
+            scan_start_time = entry->time;
+            break;
+        case TRACE_SCAN_END:
+            if (scan_started) {
+                add_sample(LATENCY_SCAN_DURATION, entry->time - scan_start_time);
+            }
+            break;
+        case TRACE_EVENT:
+            if (!event_pending_process) {
+                event_pending_process = true;
+                event_process_time = entry->time;
+            }
+            if (!event_pending_report) {
+                event_pending_report = true;
+                event_report_time = entry->time;
+            }
+            break;
+        case TRACE_PROCESS_RECORD:
+            if (event_pending_process) {
+                add_sample(LATENCY_EVENT_TO_PROCESS, entry->time - event_process_time);
+                event_pending_process = false;
+            }
+            break;
+        case TRACE_REPORT:
+            if (event_pending_report) {
+                add_sample(LATENCY_EVENT_TO_REPORT, entry->time - event_report_time);
+                event_pending_report = false;
+            }
+            break;
+    }
+}
+
+void latency_trace_task(void) {
+    while (trace_tail != trace_head) {
+        handle_entry(&trace_buffer[trace_tail]);
+        trace_tail = (trace_tail + 1) & (LATENCY_TRACE_BUFFER_SIZE - 1);
+    }
+#if LATENCY_TRACE_PRINT_INTERVAL > 0
+    if (timer_elapsed32(last_print_time) >= LATENCY_TRACE_PRINT_INTERVAL) {
+        last_print_time = timer_read32();
+        latency_trace_print();
+        latency_trace_clear();
+    }
+#endif
+}
+
+const latency_stats_t* latency_trace_get_stats(latency_metric_t metric) {
+    return &stats[metric];
+}
+
+uint32_t latency_trace_average(latency_metric_t metric) {
+    const latency_stats_t* s = &stats[metric];
+    return s->count ? s->sum / s->count : 0;
+}
+
+uint32_t latency_trace_percentile(latency_metric_t metric, uint8_t percent) {
+    const latency_stats_t* s = &stats[metric];
+    if (s->count == 0) {
+        return 0;
+    }
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < LATENCY_TRACE_BUCKETS; i++) {
+        total += s->histogram[i];
+    }
+    // Round up, so that the percentile always includes at least one sample
+    uint32_t target = (total * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < LATENCY_TRACE_BUCKETS - 1; i++) {
+        seen += s->histogram[i];
+        if (seen >= target) {
+            uint32_t upper_bound = ((uint32_t)16 << i) - 1;
+            return upper_bound < s->max ? upper_bound : s->max;
+        }
+    }
+    return s->max;
+}
+
+uint16_t latency_trace_overflows(void) {
+    return trace_overflows;
+}
+
+void latency_trace_clear(void) {
+    memset(stats, 0, sizeof(stats));
+    trace_overflows = 0;
+    // Don't count the time spent printing as a scan
+    scan_started = false;
+}
+
+void latency_trace_print(void) {
+#ifdef CONSOLE_ENABLE
+    static const char* const names[NUM_LATENCY_METRICS] = {
+        "scan period",
+        "scan duration",
+        "event to process",
+        "event to report",
+    };
+    for (uint8_t i = 0; i < NUM_LATENCY_METRICS; i++) {
+        const latency_stats_t* s = &stats[i];
+        xprintf("%s: n %lu min %lu avg %lu p99 %lu max %lu us\n", names[i],
+            s->count, s->min, latency_trace_average(i), latency_trace_percentile(i, 99), s->max);
+    }
+    if (trace_overflows) {
+        xprintf("trace overflows: %u\n", trace_overflows);
+    }
+#endif
+}
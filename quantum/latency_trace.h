@@ -0,0 +1,91 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+// Measures where the time goes between scanning the matrix and sending the report.
+// Enable with LATENCY_TRACE_ENABLE = yes in rules.mk.
+//
+// The probes only store a timestamp into a ring buffer, the statistics are
+// calculated by latency_trace_task at the end of each keyboard_task.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TRACE_SCAN_START,
+    TRACE_SCAN_END,
+    TRACE_EVENT,
+    TRACE_PROCESS_RECORD,
+    TRACE_REPORT,
+} latency_trace_probe_t;
+
+typedef enum {
+    // From the start of one scan to the start of the next, the inverse of the scan rate
+    LATENCY_SCAN_PERIOD,
+    // The time spent in matrix_scan
+    LATENCY_SCAN_DURATION,
+    // From action_exec of a key event until process_record_quantum sees it
+    LATENCY_EVENT_TO_PROCESS,
+    // From action_exec of a key event until the next keyboard report is sent
+    LATENCY_EVENT_TO_REPORT,
+    NUM_LATENCY_METRICS
+} latency_metric_t;
+
+// Histogram bucket 0 counts samples below 16us, bucket n samples in [2^(n+3), 2^(n+4)) us
+// and the last bucket everything above that
+#define LATENCY_TRACE_BUCKETS 16
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint16_t histogram[LATENCY_TRACE_BUCKETS];
+} latency_stats_t;
+
+#ifdef LATENCY_TRACE_ENABLE
+#   define LATENCY_TRACE(probe) latency_trace_probe(probe)
+#else
+#   define LATENCY_TRACE(probe)
+#endif
+
+// Don't call directly, use the LATENCY_TRACE macro instead
+void latency_trace_probe(latency_trace_probe_t probe);
+
+// Processes the recorded probes, and prints the statistics every LATENCY_TRACE_PRINT_INTERVAL ms
+void latency_trace_task(void);
+
+const latency_stats_t* latency_trace_get_stats(latency_metric_t metric);
+// The average in us, 0 when there are no samples
+uint32_t latency_trace_average(latency_metric_t metric);
+// An upper bound of the given percentile in us, based on the histogram
+uint32_t latency_trace_percentile(latency_metric_t metric, uint8_t percent);
+// Number of probes lost because the ring buffer was full
+uint16_t latency_trace_overflows(void);
+void latency_trace_clear(void);
+void latency_trace_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -42,6 +42,8 @@ extern backlight_config_t backlight_config;
 #include "process_midi.h"
 #endif
 
+#include "latency_trace.h"
+
 #ifdef AUDIO_ENABLE
   #ifndef GOODBYE_SONG
     #define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -187,7 +189,69 @@ static uint16_t scs_timer[2] = {0, 0};
  */
 static bool grave_esc_was_shifted = false;
 
+typedef bool (*process_record_handler_t)(uint16_t keycode, keyrecord_t *record);
+
+typedef struct {
+  uint16_t first;
+  uint16_t last;
+  process_record_handler_t handler;
+} process_record_handler_entry_t;
+
+#define ALL_KEYCODES 0x0000, 0xFFFF
+
+/* The feature handlers in the order they get to see the events, until one of them returns false.
+ * A handler is only called for keycodes within its range, so handlers that only care about
+ * their own keycodes don't slow down the processing of the other keys. Handlers that can
+ * capture any key while they are active (music mode, leader, ...) have to use ALL_KEYCODES.
+ */
+static const process_record_handler_entry_t process_record_handlers[] PROGMEM = {
+  { ALL_KEYCODES, process_record_kb },
+  #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
+    { MIDI_TONE_MIN, MI_MODSU, process_midi },
+  #endif
+  #ifdef AUDIO_ENABLE
+    { AU_ON, MUV_DE, process_audio },
+  #endif
+  #ifdef STENO_ENABLE
+    { QK_STENO, QK_STENO_MAX, process_steno },
+  #endif
+  #if ( defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
+    { ALL_KEYCODES, process_music },
+  #endif
+  #ifdef TAP_DANCE_ENABLE
+    { QK_TAP_DANCE, QK_TAP_DANCE_MAX, process_tap_dance },
+  #endif
+  #ifndef DISABLE_LEADER
+    { ALL_KEYCODES, process_leader },
+  #endif
+  #ifndef DISABLE_CHORDING
+    { QK_CHORDING, QK_CHORDING_MAX, process_chording },
+  #endif
+  #ifdef COMBO_ENABLE
+    { ALL_KEYCODES, process_combo },
+  #endif
+  #ifdef UNICODE_ENABLE
+    { QK_UNICODE + 1, QK_UNICODE_MAX, process_unicode },
+  #endif
+  #ifdef UCIS_ENABLE
+    { ALL_KEYCODES, process_ucis },
+  #endif
+  #ifdef PRINTING_ENABLE
+    { ALL_KEYCODES, process_printer },
+  #endif
+  #ifdef AUTO_SHIFT_ENABLE
+    { ALL_KEYCODES, process_auto_shift },
+  #endif
+  #ifdef UNICODEMAP_ENABLE
+    { QK_UNICODE_MAP, QK_UNICODE_MAX, process_unicode_map },
+  #endif
+  #ifdef TERMINAL_ENABLE
+    { ALL_KEYCODES, process_terminal },
+  #endif
+};
+
 bool process_record_quantum(keyrecord_t *record) {
+  LATENCY_TRACE(TRACE_PROCESS_RECORD);
 
   /* This gets the keycode from the key pressed */
   keypos_t key = record->event.key;
@@ -221,56 +285,22 @@ bool process_record_quantum(keyrecord_t *record) {
     preprocess_tap_dance(keycode, record);
   #endif
 
-  if (!(
   #if defined(KEY_LOCK_ENABLE)
     // Must run first to be able to mask key_up events.
-    process_key_lock(&keycode, record) &&
-  #endif
-    process_record_kb(keycode, record) &&
-  #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-    process_midi(keycode, record) &&
-  #endif
-  #ifdef AUDIO_ENABLE
-    process_audio(keycode, record) &&
-  #endif
-  #ifdef STENO_ENABLE
-    process_steno(keycode, record) &&
-  #endif
-  #if ( defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE) 
-    process_music(keycode, record) &&
-  #endif
-  #ifdef TAP_DANCE_ENABLE
-    process_tap_dance(keycode, record) &&
-  #endif
-  #ifndef DISABLE_LEADER
-    process_leader(keycode, record) &&
-  #endif
-  #ifndef DISABLE_CHORDING
-    process_chording(keycode, record) &&
-  #endif
-  #ifdef COMBO_ENABLE
-    process_combo(keycode, record) &&
-  #endif
-  #ifdef UNICODE_ENABLE
-    process_unicode(keycode, record) &&
-  #endif
-  #ifdef UCIS_ENABLE
-    process_ucis(keycode, record) &&
-  #endif
-  #ifdef PRINTING_ENABLE
-    process_printer(keycode, record) &&
-  #endif
-  #ifdef AUTO_SHIFT_ENABLE
-    process_auto_shift(keycode, record) &&
-  #endif
-  #ifdef UNICODEMAP_ENABLE
-    process_unicode_map(keycode, record) &&
-  #endif
-  #ifdef TERMINAL_ENABLE
-    process_terminal(keycode, record) &&
+    if (!process_key_lock(&keycode, record)) {
+      return false;
+    }
   #endif
-      true)) {
-    return false;
+
+  for (uint8_t i = 0; i < sizeof(process_record_handlers) / sizeof(process_record_handlers[0]); i++) {
+    const process_record_handler_entry_t *entry = &process_record_handlers[i];
+    if (keycode < pgm_read_word(&entry->first) || keycode > pgm_read_word(&entry->last)) {
+      continue;
+    }
+    process_record_handler_t handler = (process_record_handler_t)pgm_read_ptr(&entry->handler);
+    if (!handler(keycode, record)) {
+      return false;
+    }
   }
 
   // Shift / paren setup
@@ -426,6 +456,69 @@ bool process_record_quantum(keyrecord_t *record) {
       }
     }
     return false;
+  #elif defined(RGB_MATRIX_ENABLE)
+  case RGB_TOG:
+    if (record->event.pressed) {
+      rgb_matrix_toggle();
+    }
+    return false;
+  case RGB_MODE_FORWARD:
+    if (record->event.pressed) {
+      uint8_t shifted = get_mods() & (MOD_BIT(KC_LSHIFT)|MOD_BIT(KC_RSHIFT));
+      if(shifted) {
+        rgb_matrix_step_reverse();
+      }
+      else {
+        rgb_matrix_step();
+      }
+    }
+    return false;
+  case RGB_MODE_REVERSE:
+    if (record->event.pressed) {
+      uint8_t shifted = get_mods() & (MOD_BIT(KC_LSHIFT)|MOD_BIT(KC_RSHIFT));
+      if(shifted) {
+        rgb_matrix_step();
+      }
+      else {
+        rgb_matrix_step_reverse();
+      }
+    }
+    return false;
+  case RGB_HUI:
+    if (record->event.pressed) {
+      rgb_matrix_increase_hue();
+    }
+    return false;
+  case RGB_HUD:
+    if (record->event.pressed) {
+      rgb_matrix_decrease_hue();
+    }
+    return false;
+  case RGB_SAI:
+    if (record->event.pressed) {
+      rgb_matrix_increase_sat();
+    }
+    return false;
+  case RGB_SAD:
+    if (record->event.pressed) {
+      rgb_matrix_decrease_sat();
+    }
+    return false;
+  case RGB_VAI:
+    if (record->event.pressed) {
+      rgb_matrix_increase_val();
+    }
+    return false;
+  case RGB_VAD:
+    if (record->event.pressed) {
+      rgb_matrix_decrease_val();
+    }
+    return false;
+  case RGB_MODE_PLAIN:
+    if (record->event.pressed) {
+      rgb_matrix_mode(RGB_MATRIX_SOLID_COLOR);
+    }
+    return false;
   #endif
     #ifdef PROTOCOL_LUFA
     case OUT_AUTO:
@@ -695,6 +788,51 @@ const uint8_t ascii_to_keycode_lut[0x80] PROGMEM = {
     KC_X, KC_Y, KC_Z, KC_LBRC, KC_BSLS, KC_RBRC, KC_GRV, KC_DEL
 };
 
+/*
+ * The strings are played as a stream of keyboard reports. The characters
+ * are added to the report directly instead of going through register_code,
+ * and shift is only pressed or released when it changes between two
+ * characters, so a run of shifted characters costs two reports each.
+ */
+static bool send_string_shifted = false;
+
+static void send_string_set_shift(bool shift) {
+  if (shift == send_string_shifted) return;
+  send_string_shifted = shift;
+  if (shift) {
+    add_weak_mods(MOD_BIT(KC_LSFT));
+  } else {
+    del_weak_mods(MOD_BIT(KC_LSFT));
+  }
+  send_keyboard_report();
+}
+
+static void send_string_char(char ascii_code) {
+  uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+  if (!keycode) return;
+  send_string_set_shift(pgm_read_byte(&ascii_to_shift_lut[(uint8_t)ascii_code]));
+  add_key(keycode);
+  send_keyboard_report();
+  del_key(keycode);
+  send_keyboard_report();
+}
+
+static void send_string_code(uint8_t type, uint8_t keycode) {
+  // the keycode may depend on the state of shift
+  send_string_set_shift(false);
+  if (type == 1) {
+    // tap
+    register_code(keycode);
+    unregister_code(keycode);
+  } else if (type == 2) {
+    // down
+    register_code(keycode);
+  } else {
+    // up
+    unregister_code(keycode);
+  }
+}
+
 void send_string(const char *str) {
   send_string_with_delay(str, 0);
 }
@@ -707,66 +845,37 @@ void send_string_with_delay(const char *str, uint8_t interval) {
     while (1) {
         char ascii_code = *str;
         if (!ascii_code) break;
-        if (ascii_code == 1) {
-          // tap
-          uint8_t keycode = *(++str);
-          register_code(keycode);
-          unregister_code(keycode);
-        } else if (ascii_code == 2) {
-          // down
-          uint8_t keycode = *(++str);
-          register_code(keycode);
-        } else if (ascii_code == 3) {
-          // up
-          uint8_t keycode = *(++str);
-          unregister_code(keycode);
+        if ((uint8_t)ascii_code <= 3) {
+          send_string_code(ascii_code, *(++str));
         } else {
-          send_char(ascii_code);
+          send_string_char(ascii_code);
         }
         ++str;
         // interval
         { uint8_t ms = interval; while (ms--) wait_ms(1); }
     }
+    send_string_set_shift(false);
 }
 
 void send_string_with_delay_P(const char *str, uint8_t interval) {
     while (1) {
         char ascii_code = pgm_read_byte(str);
         if (!ascii_code) break;
-        if (ascii_code == 1) {
-          // tap
-          uint8_t keycode = pgm_read_byte(++str);
-          register_code(keycode);
-          unregister_code(keycode);
-        } else if (ascii_code == 2) {
-          // down
-          uint8_t keycode = pgm_read_byte(++str);
-          register_code(keycode);
-        } else if (ascii_code == 3) {
-          // up
-          uint8_t keycode = pgm_read_byte(++str);
-          unregister_code(keycode);
+        if ((uint8_t)ascii_code <= 3) {
+          send_string_code(ascii_code, pgm_read_byte(++str));
         } else {
-          send_char(ascii_code);
+          send_string_char(ascii_code);
         }
         ++str;
         // interval
         { uint8_t ms = interval; while (ms--) wait_ms(1); }
     }
+    send_string_set_shift(false);
 }
 
 void send_char(char ascii_code) {
-  uint8_t keycode;
-  keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
-  if (pgm_read_byte(&ascii_to_shift_lut[(uint8_t)ascii_code])) {
-      register_code(KC_LSFT);
-      register_code(keycode);
-      unregister_code(keycode);
-      unregister_code(KC_LSFT);
-  } else {
-      register_code(keycode);
-      unregister_code(keycode);
-  }
+  send_string_char(ascii_code);
+  send_string_set_shift(false);
 }
 
 void set_single_persistent_default_layer(uint8_t default_layer) {
@@ -830,27 +939,38 @@ void matrix_init_quantum() {
   #ifdef AUDIO_ENABLE
     audio_init();
   #endif
+  #ifdef RGB_MATRIX_ENABLE
+    rgb_matrix_init();
+  #endif
   matrix_init_kb();
 }
 
-void matrix_scan_quantum() {
+/* The features that need to run on every matrix scan, matrix_scan_kb always runs last */
+static void (*const matrix_scan_hooks[])(void) PROGMEM = {
   #if defined(AUDIO_ENABLE)
-    matrix_scan_music();
+    audio_task,
+    matrix_scan_music,
   #endif
-
   #ifdef TAP_DANCE_ENABLE
-    matrix_scan_tap_dance();
+    matrix_scan_tap_dance,
   #endif
-
   #ifdef COMBO_ENABLE
-    matrix_scan_combo();
+    matrix_scan_combo,
   #endif
-
   #if defined(BACKLIGHT_ENABLE) && defined(BACKLIGHT_PIN)
-    backlight_task();
+    backlight_task,
   #endif
+  #ifdef RGB_MATRIX_ENABLE
+    rgb_matrix_task,
+  #endif
+  matrix_scan_kb,
+};
 
-  matrix_scan_kb();
+void matrix_scan_quantum() {
+  for (uint8_t i = 0; i < sizeof(matrix_scan_hooks) / sizeof(matrix_scan_hooks[0]); i++) {
+    void (*hook)(void) = (void (*)(void))pgm_read_ptr(&matrix_scan_hooks[i]);
+    hook();
+  }
 }
 
 #if defined(BACKLIGHT_ENABLE) && defined(BACKLIGHT_PIN)
@@ -30,6 +30,9 @@
 #ifdef RGBLIGHT_ENABLE
   #include "rgblight.h"
 #endif
+#ifdef RGB_MATRIX_ENABLE
+  #include "rgb_matrix.h"
+#endif
 #include "action_layer.h"
 #include "eeconfig.h"
 #include <stddef.h>
@@ -0,0 +1,467 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "rgb_matrix.h"
+#include "matrix.h"
+#include "timer.h"
+#include "debug.h"
+#include "led_tables.h"
+
+#ifndef RGB_MATRIX_STARTUP_MODE
+#   define RGB_MATRIX_STARTUP_MODE RGB_MATRIX_CYCLE_LEFT_RIGHT
+#endif
+
+#if RGB_MATRIX_LED_PROCESS_LIMIT < 1 || RGB_MATRIX_LED_PROCESS_LIMIT > RGB_MATRIX_LED_COUNT
+#   error "RGB_MATRIX_LED_PROCESS_LIMIT has to be between 1 and RGB_MATRIX_LED_COUNT"
+#endif
+
+#if RGB_MATRIX_REACTIVE_FADE_MS > RGB_MATRIX_SPLASH_MS
+#   define RGB_MATRIX_KEY_ACTIVE_MS RGB_MATRIX_REACTIVE_FADE_MS
+#else
+#   define RGB_MATRIX_KEY_ACTIVE_MS RGB_MATRIX_SPLASH_MS
+#endif
+
+// The width of the splash ring
+#define SPLASH_WIDTH 16
+
+// a * b / 255, exact at both ends
+#define SCALE8(a, b) ((uint8_t)(((uint16_t)(a) * (b) + (b)) >> 8))
+
+typedef struct {
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+} hsv_t;
+
+typedef struct {
+    uint8_t x;
+    uint8_t y;
+    uint16_t time;
+} splash_hit_t;
+
+typedef struct {
+    // Called once at the start of each frame, can be NULL
+    void (*begin)(uint16_t elapsed);
+    // Renders count LEDs starting from first
+    void (*render)(uint8_t first, uint8_t count, hsv_t *out);
+    // Animated effects change over time, the others only when keys are pressed
+    bool animated;
+} rgb_matrix_effect_t;
+
+static rgb_matrix_config_t rgb_matrix_config;
+
+static uint8_t key_led[MATRIX_ROWS][MATRIX_COLS];
+
+// What the driver has been told, so that only changes are written
+static LED_TYPE led_sent[RGB_MATRIX_LED_COUNT];
+static bool led_sent_valid;
+
+// The next LED to render, the frame starts over from 0
+static uint8_t render_pos;
+static uint16_t frame_time;
+static uint16_t last_frame_time;
+static bool frame_written;
+// Nothing is rendered until the config changes or a key is pressed
+static bool idle;
+// Keys pressed recently might still be fading out
+static bool keys_active;
+static uint16_t last_key_time;
+
+// The brightness of each key in the reactive effect
+static uint8_t led_heat[RGB_MATRIX_LED_COUNT];
+static uint8_t heat_decay;
+static uint16_t heat_decay_remainder;
+
+static splash_hit_t splash_hits[RGB_MATRIX_SPLASH_HITS];
+static uint8_t splash_head;
+static uint8_t splash_count;
+// The hits that are still visible during this frame
+static uint8_t splash_active;
+static uint8_t splash_x[RGB_MATRIX_SPLASH_HITS];
+static uint8_t splash_y[RGB_MATRIX_SPLASH_HITS];
+static uint8_t splash_radius[RGB_MATRIX_SPLASH_HITS];
+static uint8_t splash_fade[RGB_MATRIX_SPLASH_HITS];
+
+static uint8_t cycle_offset;
+
+static void effect_off(uint8_t first, uint8_t count, hsv_t *out) {
+    memset(out, 0, count * sizeof(hsv_t));
+}
+
+static void effect_solid_color(uint8_t first, uint8_t count, hsv_t *out) {
+    for (uint8_t i = 0; i < count; i++) {
+        out[i].h = rgb_matrix_config.hue;
+        out[i].s = rgb_matrix_config.sat;
+        out[i].v = rgb_matrix_config.val;
+    }
+}
+
+// The whole colour wheel every 4 seconds
+static void effect_cycle_begin(uint16_t elapsed) {
+    cycle_offset = frame_time >> 4;
+}
+
+static void effect_cycle_all(uint8_t first, uint8_t count, hsv_t *out) {
+    for (uint8_t i = 0; i < count; i++) {
+        out[i].h = rgb_matrix_config.hue + cycle_offset;
+        out[i].s = rgb_matrix_config.sat;
+        out[i].v = rgb_matrix_config.val;
+    }
+}
+
+static void effect_cycle_left_right(uint8_t first, uint8_t count, hsv_t *out) {
+    // The colours move to the right, so the hue goes backwards in time
+    uint8_t hue = rgb_matrix_config.hue - cycle_offset;
+    for (uint8_t i = 0; i < count; i++) {
+        out[i].h = hue + pgm_read_byte(&rgb_matrix_leds[first + i].x);
+        out[i].s = rgb_matrix_config.sat;
+        out[i].v = rgb_matrix_config.val;
+    }
+}
+
+static void effect_reactive_begin(uint16_t elapsed) {
+    uint32_t decay = (uint32_t)elapsed * 255 + heat_decay_remainder;
+    if (decay >= 255UL * RGB_MATRIX_REACTIVE_FADE_MS) {
+        heat_decay = 255;
+        heat_decay_remainder = 0;
+    } else {
+        heat_decay = decay / RGB_MATRIX_REACTIVE_FADE_MS;
+        heat_decay_remainder = decay % RGB_MATRIX_REACTIVE_FADE_MS;
+    }
+}
+
+static void effect_reactive(uint8_t first, uint8_t count, hsv_t *out) {
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t heat = led_heat[first + i];
+        heat = heat > heat_decay ? heat - heat_decay : 0;
+        led_heat[first + i] = heat;
+        out[i].h = rgb_matrix_config.hue;
+        out[i].s = rgb_matrix_config.sat;
+        out[i].v = SCALE8(heat, rgb_matrix_config.val);
+    }
+}
+
+static void effect_splash_begin(uint16_t elapsed) {
+    splash_active = 0;
+    for (uint8_t i = 0; i < splash_count; i++) {
+        const splash_hit_t *hit = &splash_hits[i];
+        uint16_t age = TIMER_DIFF_16(frame_time, hit->time);
+        if (age >= RGB_MATRIX_SPLASH_MS) {
+            continue;
+        }
+        uint16_t radius = ((uint32_t)age * RGB_MATRIX_SPLASH_SPEED) >> 4;
+        splash_x[splash_active] = hit->x;
+        splash_y[splash_active] = hit->y;
+        splash_radius[splash_active] = radius > 255 ? 255 : radius;
+        splash_fade[splash_active] = 255 - (uint32_t)age * 255 / RGB_MATRIX_SPLASH_MS;
+        splash_active++;
+    }
+}
+
+static void effect_splash(uint8_t first, uint8_t count, hsv_t *out) {
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t x = pgm_read_byte(&rgb_matrix_leds[first + i].x);
+        uint8_t y = pgm_read_byte(&rgb_matrix_leds[first + i].y);
+        uint16_t v = 0;
+        for (uint8_t j = 0; j < splash_active; j++) {
+            uint8_t dx = x > splash_x[j] ? x - splash_x[j] : splash_x[j] - x;
+            uint8_t dy = y > splash_y[j] ? y - splash_y[j] : splash_y[j] - y;
+            // Close enough to the real distance, without a square root
+            uint16_t dist = dx > dy ? dx + (dy >> 1) : dy + (dx >> 1);
+            uint16_t ring = dist > splash_radius[j] ? dist - splash_radius[j] : splash_radius[j] - dist;
+            if (ring < SPLASH_WIDTH) {
+                v += SCALE8((SPLASH_WIDTH - ring) * (256 / SPLASH_WIDTH) - 1, splash_fade[j]);
+            }
+        }
+        out[i].h = rgb_matrix_config.hue;
+        out[i].s = rgb_matrix_config.sat;
+        out[i].v = SCALE8(v > 255 ? 255 : v, rgb_matrix_config.val);
+    }
+}
+
+static const rgb_matrix_effect_t effect_disabled = { NULL, effect_off, false };
+
+// In the order of enum rgb_matrix_modes
+static const rgb_matrix_effect_t rgb_matrix_effects[] PROGMEM = {
+    { NULL, effect_solid_color, false },
+    { effect_cycle_begin, effect_cycle_all, true },
+    { effect_cycle_begin, effect_cycle_left_right, true },
+    { effect_reactive_begin, effect_reactive, false },
+    { effect_splash_begin, effect_splash, false },
+};
+
+// The hue is split into six sectors of 256 / 6, which needs no division
+static void hsv_to_rgb(const hsv_t *in, LED_TYPE *out, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t v = in[i].v;
+        uint8_t span = ((uint16_t)in[i].s * v + v) >> 8;
+        uint8_t base = v - span;
+        uint16_t h6 = in[i].h * 6;
+        uint8_t color = ((uint16_t)span * (h6 & 0xFF)) >> 8;
+        uint8_t r, g, b;
+        switch (h6 >> 8) {
+            case 0:
+                r = base + span; g = base + color; b = base;
+                break;
+            case 1:
+                r = base + span - color; g = base + span; b = base;
+                break;
+            case 2:
+                r = base; g = base + span; b = base + color;
+                break;
+            case 3:
+                r = base; g = base + span - color; b = base + span;
+                break;
+            case 4:
+                r = base + color; g = base; b = base + span;
+                break;
+            default:
+                r = base + span; g = base; b = base + span - color;
+                break;
+        }
+        out[i].r = pgm_read_byte(&CIE1931_CURVE[r]);
+        out[i].g = pgm_read_byte(&CIE1931_CURVE[g]);
+        out[i].b = pgm_read_byte(&CIE1931_CURVE[b]);
+#ifdef RGBW
+        out[i].w = 0;
+#endif
+    }
+}
+
+static void read_effect(rgb_matrix_effect_t *effect) {
+    if (!rgb_matrix_config.enable) {
+        *effect = effect_disabled;
+        return;
+    }
+    const rgb_matrix_effect_t *entry = &rgb_matrix_effects[rgb_matrix_config.mode - 1];
+    effect->begin = (void (*)(uint16_t))pgm_read_ptr(&entry->begin);
+    effect->render = (void (*)(uint8_t, uint8_t, hsv_t *))pgm_read_ptr(&entry->render);
+    effect->animated = pgm_read_byte(&entry->animated);
+}
+
+// Writes the LEDs that differ from what the driver already has, in runs
+static void write_changed(uint8_t first, const LED_TYPE *leds, uint8_t count) {
+    uint8_t i = 0;
+    while (i < count) {
+        if (led_sent_valid && memcmp(&leds[i], &led_sent[first + i], sizeof(LED_TYPE)) == 0) {
+            i++;
+            continue;
+        }
+        uint8_t start = i;
+        while (i < count &&
+            (!led_sent_valid || memcmp(&leds[i], &led_sent[first + i], sizeof(LED_TYPE)) != 0)) {
+            i++;
+        }
+        memcpy(&led_sent[first + start], &leds[start], (i - start) * sizeof(LED_TYPE));
+        rgb_matrix_driver_write(first + start, &led_sent[first + start], i - start);
+        frame_written = true;
+    }
+}
+
+void rgb_matrix_task(void) {
+    if (idle) {
+        return;
+    }
+
+    rgb_matrix_effect_t effect;
+    read_effect(&effect);
+
+    if (render_pos == 0) {
+        frame_time = timer_read();
+        if (effect.begin) {
+            effect.begin(TIMER_DIFF_16(frame_time, last_frame_time));
+        }
+        last_frame_time = frame_time;
+        frame_written = false;
+    }
+
+    uint8_t count = RGB_MATRIX_LED_COUNT - render_pos;
+    if (count > RGB_MATRIX_LED_PROCESS_LIMIT) {
+        count = RGB_MATRIX_LED_PROCESS_LIMIT;
+    }
+    hsv_t hsv[RGB_MATRIX_LED_PROCESS_LIMIT];
+    LED_TYPE rgb[RGB_MATRIX_LED_PROCESS_LIMIT];
+    effect.render(render_pos, count, hsv);
+    hsv_to_rgb(hsv, rgb, count);
+    write_changed(render_pos, rgb, count);
+    render_pos += count;
+
+    if (render_pos < RGB_MATRIX_LED_COUNT) {
+        return;
+    }
+    render_pos = 0;
+    led_sent_valid = true;
+    // The reactive effects have faded out once the last key press is older than this
+    if (keys_active && timer_elapsed(last_key_time) > RGB_MATRIX_KEY_ACTIVE_MS) {
+        memset(led_heat, 0, sizeof(led_heat));
+        splash_count = 0;
+        splash_head = 0;
+        keys_active = false;
+    }
+    if (frame_written) {
+        rgb_matrix_driver_flush();
+    } else if (!effect.animated && !keys_active) {
+        // A whole frame without any changes, so the picture stands still
+        idle = true;
+    }
+}
+
+void rgb_matrix_record_key(keyevent_t event) {
+    if (!event.pressed || event.key.row >= MATRIX_ROWS || event.key.col >= MATRIX_COLS) {
+        return;
+    }
+    uint8_t led = key_led[event.key.row][event.key.col];
+    if (led == RGB_MATRIX_NO_LED) {
+        return;
+    }
+    led_heat[led] = 255;
+    splash_hit_t *hit = &splash_hits[splash_head];
+    hit->x = pgm_read_byte(&rgb_matrix_leds[led].x);
+    hit->y = pgm_read_byte(&rgb_matrix_leds[led].y);
+    hit->time = event.time;
+    splash_head = (splash_head + 1) % RGB_MATRIX_SPLASH_HITS;
+    if (splash_count < RGB_MATRIX_SPLASH_HITS) {
+        splash_count++;
+    }
+    last_key_time = event.time;
+    keys_active = true;
+    idle = false;
+}
+
+uint8_t rgb_matrix_key_to_led(uint8_t row, uint8_t col) {
+    if (row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+        return RGB_MATRIX_NO_LED;
+    }
+    return key_led[row][col];
+}
+
+// Draws at least one whole frame with the new config
+static void rgb_matrix_config_changed(void) {
+    idle = false;
+}
+
+void rgb_matrix_init(void) {
+    memset(key_led, RGB_MATRIX_NO_LED, sizeof(key_led));
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        uint8_t row = pgm_read_byte(&rgb_matrix_leds[i].row);
+        uint8_t col = pgm_read_byte(&rgb_matrix_leds[i].col);
+        if (row < MATRIX_ROWS && col < MATRIX_COLS) {
+            key_led[row][col] = i;
+        }
+    }
+    memset(led_heat, 0, sizeof(led_heat));
+    splash_count = 0;
+    splash_head = 0;
+    render_pos = 0;
+    led_sent_valid = false;
+    keys_active = false;
+    last_frame_time = timer_read();
+
+    rgb_matrix_config.enable = true;
+    rgb_matrix_config.mode = RGB_MATRIX_STARTUP_MODE;
+    rgb_matrix_config.hue = 0;
+    rgb_matrix_config.sat = 255;
+    rgb_matrix_config.val = RGB_MATRIX_LIMIT_VAL;
+
+    rgb_matrix_driver_init();
+    rgb_matrix_config_changed();
+}
+
+const rgb_matrix_config_t *rgb_matrix_get_config(void) {
+    return &rgb_matrix_config;
+}
+
+void rgb_matrix_enable(void) {
+    rgb_matrix_config.enable = true;
+    rgb_matrix_config_changed();
+}
+
+void rgb_matrix_disable(void) {
+    rgb_matrix_config.enable = false;
+    rgb_matrix_config_changed();
+}
+
+void rgb_matrix_toggle(void) {
+    if (rgb_matrix_config.enable) {
+        rgb_matrix_disable();
+    } else {
+        rgb_matrix_enable();
+    }
+}
+
+void rgb_matrix_mode(uint8_t mode) {
+    if (mode < 1) {
+        mode = 1;
+    } else if (mode > RGB_MATRIX_MODES) {
+        mode = RGB_MATRIX_MODES;
+    }
+    dprintf("rgb_matrix mode: %u\n", mode);
+    rgb_matrix_config.mode = mode;
+    memset(led_heat, 0, sizeof(led_heat));
+    splash_count = 0;
+    splash_head = 0;
+    render_pos = 0;
+    rgb_matrix_config_changed();
+}
+
+uint8_t rgb_matrix_get_mode(void) {
+    return rgb_matrix_config.enable ? rgb_matrix_config.mode : 0;
+}
+
+void rgb_matrix_step(void) {
+    rgb_matrix_mode(rgb_matrix_config.mode < RGB_MATRIX_MODES ? rgb_matrix_config.mode + 1 : 1);
+}
+
+void rgb_matrix_step_reverse(void) {
+    rgb_matrix_mode(rgb_matrix_config.mode > 1 ? rgb_matrix_config.mode - 1 : RGB_MATRIX_MODES);
+}
+
+void rgb_matrix_sethsv(uint8_t hue, uint8_t sat, uint8_t val) {
+    rgb_matrix_config.hue = hue;
+    rgb_matrix_config.sat = sat;
+    rgb_matrix_config.val = val > RGB_MATRIX_LIMIT_VAL ? RGB_MATRIX_LIMIT_VAL : val;
+    rgb_matrix_config_changed();
+}
+
+static uint8_t add_clamped(uint8_t value, int16_t step) {
+    int16_t result = value + step;
+    return result < 0 ? 0 : result > 255 ? 255 : result;
+}
+
+void rgb_matrix_increase_hue(void) {
+    rgb_matrix_sethsv(rgb_matrix_config.hue + RGB_MATRIX_HUE_STEP, rgb_matrix_config.sat, rgb_matrix_config.val);
+}
+
+void rgb_matrix_decrease_hue(void) {
+    rgb_matrix_sethsv(rgb_matrix_config.hue - RGB_MATRIX_HUE_STEP, rgb_matrix_config.sat, rgb_matrix_config.val);
+}
+
+void rgb_matrix_increase_sat(void) {
+    rgb_matrix_sethsv(rgb_matrix_config.hue, add_clamped(rgb_matrix_config.sat, RGB_MATRIX_SAT_STEP), rgb_matrix_config.val);
+}
+
+void rgb_matrix_decrease_sat(void) {
+    rgb_matrix_sethsv(rgb_matrix_config.hue, add_clamped(rgb_matrix_config.sat, -RGB_MATRIX_SAT_STEP), rgb_matrix_config.val);
+}
+
+void rgb_matrix_increase_val(void) {
+    rgb_matrix_sethsv(rgb_matrix_config.hue, rgb_matrix_config.sat, add_clamped(rgb_matrix_config.val, RGB_MATRIX_VAL_STEP));
+}
+
+void rgb_matrix_decrease_val(void) {
+    rgb_matrix_sethsv(rgb_matrix_config.hue, rgb_matrix_config.sat, add_clamped(rgb_matrix_config.val, -RGB_MATRIX_VAL_STEP));
+}
@@ -0,0 +1,145 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RGB_MATRIX_H
+#define RGB_MATRIX_H
+
+// Per-key RGB lighting. Enable with RGB_MATRIX_ENABLE = yes in rules.mk.
+//
+// The keyboard describes where its LEDs are in rgb_matrix_leds, and provides
+// the rgb_matrix_driver_* functions that talk to the LED driver. A frame is
+// rendered a few LEDs at a time, so each scan only spends a fixed amount of
+// time on the lighting, however many LEDs there are.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "progmem.h"
+#include "keyboard.h"
+#include "rgblight_types.h"
+
+#ifndef RGB_MATRIX_LED_COUNT
+#   error "RGB_MATRIX_LED_COUNT has to be defined to the number of LEDs"
+#endif
+
+#if RGB_MATRIX_LED_COUNT > 254
+#   error "RGB_MATRIX_LED_COUNT can be at most 254"
+#endif
+
+// How many LEDs are rendered and written to the driver on each scan
+#ifndef RGB_MATRIX_LED_PROCESS_LIMIT
+#   define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
+#endif
+
+// How long it takes for a key to fade out in the reactive effect
+#ifndef RGB_MATRIX_REACTIVE_FADE_MS
+#   define RGB_MATRIX_REACTIVE_FADE_MS 500
+#endif
+
+// The number of key presses the splash effect remembers
+#ifndef RGB_MATRIX_SPLASH_HITS
+#   define RGB_MATRIX_SPLASH_HITS 8
+#endif
+
+// How long a splash lasts, and how fast it spreads in 1/16 units per ms
+#ifndef RGB_MATRIX_SPLASH_MS
+#   define RGB_MATRIX_SPLASH_MS 1000
+#endif
+#ifndef RGB_MATRIX_SPLASH_SPEED
+#   define RGB_MATRIX_SPLASH_SPEED 4
+#endif
+
+#ifndef RGB_MATRIX_HUE_STEP
+#   define RGB_MATRIX_HUE_STEP 8
+#endif
+#ifndef RGB_MATRIX_SAT_STEP
+#   define RGB_MATRIX_SAT_STEP 17
+#endif
+#ifndef RGB_MATRIX_VAL_STEP
+#   define RGB_MATRIX_VAL_STEP 17
+#endif
+
+#ifndef RGB_MATRIX_LIMIT_VAL
+#   define RGB_MATRIX_LIMIT_VAL 255
+#endif
+
+// Marks an LED that isn't under a key, and a key without an LED
+#define RGB_MATRIX_NO_KEY 255
+#define RGB_MATRIX_NO_LED 255
+
+typedef struct {
+    // The matrix position of the key above the LED, or RGB_MATRIX_NO_KEY
+    uint8_t row;
+    uint8_t col;
+    // The physical position, the whole keyboard should span 0-255 horizontally
+    // with the same scale vertically
+    uint8_t x;
+    uint8_t y;
+} rgb_matrix_led_t;
+
+// Defined by the keyboard, in the order the driver expects the LEDs
+extern const rgb_matrix_led_t rgb_matrix_leds[RGB_MATRIX_LED_COUNT] PROGMEM;
+
+enum rgb_matrix_modes {
+    RGB_MATRIX_SOLID_COLOR = 1,
+    RGB_MATRIX_CYCLE_ALL,
+    RGB_MATRIX_CYCLE_LEFT_RIGHT,
+    RGB_MATRIX_REACTIVE,
+    RGB_MATRIX_SPLASH,
+    RGB_MATRIX_MODES = RGB_MATRIX_SPLASH
+};
+
+// The hue goes all the way round the colour wheel from 0 to 255
+typedef struct {
+    bool    enable;
+    uint8_t mode;
+    uint8_t hue;
+    uint8_t sat;
+    uint8_t val;
+} rgb_matrix_config_t;
+
+void rgb_matrix_init(void);
+// Called on each scan, renders the next RGB_MATRIX_LED_PROCESS_LIMIT LEDs
+void rgb_matrix_task(void);
+// Called by action_exec for each key press
+void rgb_matrix_record_key(keyevent_t event);
+
+void rgb_matrix_toggle(void);
+void rgb_matrix_enable(void);
+void rgb_matrix_disable(void);
+void rgb_matrix_mode(uint8_t mode);
+uint8_t rgb_matrix_get_mode(void);
+void rgb_matrix_step(void);
+void rgb_matrix_step_reverse(void);
+void rgb_matrix_sethsv(uint8_t hue, uint8_t sat, uint8_t val);
+void rgb_matrix_increase_hue(void);
+void rgb_matrix_decrease_hue(void);
+void rgb_matrix_increase_sat(void);
+void rgb_matrix_decrease_sat(void);
+void rgb_matrix_increase_val(void);
+void rgb_matrix_decrease_val(void);
+const rgb_matrix_config_t *rgb_matrix_get_config(void);
+
+// The LED under a key, or RGB_MATRIX_NO_LED
+uint8_t rgb_matrix_key_to_led(uint8_t row, uint8_t col);
+
+// Implemented by the keyboard. rgb_matrix_driver_write is called with runs of
+// LEDs that have changed since they were last written, spread over several
+// scans, and rgb_matrix_driver_flush once the whole frame has been written.
+void rgb_matrix_driver_init(void);
+void rgb_matrix_driver_write(uint8_t first, const LED_TYPE *leds, uint8_t count);
+void rgb_matrix_driver_flush(void);
+
+#endif
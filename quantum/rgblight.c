@@ -14,9 +14,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <math.h>
-#include <avr/eeprom.h>
-#include <avr/interrupt.h>
-#include <util/delay.h>
+#include <string.h>
+#include "eeprom.h"
+#include "wait.h"
 #include "progmem.h"
 #include "timer.h"
 #include "rgblight.h"
@@ -43,8 +43,110 @@ LED_TYPE led[RGBLED_NUM];
 uint8_t rgblight_inited = 0;
 bool rgblight_timer_enabled = false;
 
-void sethsv(uint16_t hue, uint8_t sat, uint8_t val, LED_TYPE *led1) {
-  uint8_t r = 0, g = 0, b = 0, base, color;
+/*
+ * The effects, numbered from mode 1 in the order of the table
+ *
+ * Each effect takes as many modes as it has variants, which select its speed
+ * and direction. Animated effects draw a frame each time their interval has
+ * passed, the others are drawn when the color changes.
+ */
+#define RGBLIGHT_EFFECT_ANIMATED  (1 << 0)
+// the intervals are indexed by speed, which is variant / 2, the lowest bit
+// of the variant is the direction
+#define RGBLIGHT_EFFECT_DIRECTION (1 << 1)
+// the effect animates the value or hue, so changes to them are ignored
+#define RGBLIGHT_EFFECT_KEEP_VAL  (1 << 2)
+#define RGBLIGHT_EFFECT_KEEP_HUE  (1 << 3)
+
+typedef void (*rgblight_frame_func_t)(uint8_t variant);
+
+typedef struct {
+  uint8_t variants;
+  uint8_t flags;
+  // frame intervals in ms by speed, or NULL to use the fixed interval
+  const uint8_t *intervals;
+  uint16_t interval;
+  rgblight_frame_func_t frame;
+} rgblight_effect_t;
+
+static void rgblight_effect_static_light(uint8_t variant);
+#ifdef RGBLIGHT_ANIMATIONS
+static void rgblight_effect_static_gradient(uint8_t variant);
+#endif
+
+static const rgblight_effect_t rgblight_effects[] PROGMEM = {
+  {1, 0, NULL, 0, rgblight_effect_static_light},
+#ifdef RGBLIGHT_ANIMATIONS
+  {4, RGBLIGHT_EFFECT_ANIMATED | RGBLIGHT_EFFECT_KEEP_VAL,
+    RGBLED_BREATHING_INTERVALS, 0, rgblight_effect_breathing},
+  {3, RGBLIGHT_EFFECT_ANIMATED | RGBLIGHT_EFFECT_KEEP_HUE,
+    RGBLED_RAINBOW_MOOD_INTERVALS, 0, rgblight_effect_rainbow_mood},
+  {6, RGBLIGHT_EFFECT_ANIMATED | RGBLIGHT_EFFECT_DIRECTION | RGBLIGHT_EFFECT_KEEP_HUE,
+    RGBLED_RAINBOW_SWIRL_INTERVALS, 0, rgblight_effect_rainbow_swirl},
+  {6, RGBLIGHT_EFFECT_ANIMATED | RGBLIGHT_EFFECT_DIRECTION,
+    RGBLED_SNAKE_INTERVALS, 0, rgblight_effect_snake},
+  {3, RGBLIGHT_EFFECT_ANIMATED,
+    RGBLED_KNIGHT_INTERVALS, 0, rgblight_effect_knight},
+  {1, RGBLIGHT_EFFECT_ANIMATED,
+    NULL, RGBLIGHT_EFFECT_CHRISTMAS_INTERVAL, rgblight_effect_christmas},
+  {10, 0, NULL, 0, rgblight_effect_static_gradient},
+#endif
+};
+
+#define RGBLIGHT_EFFECTS (sizeof(rgblight_effects) / sizeof(rgblight_effects[0]))
+
+#ifdef RGBLIGHT_ANIMATIONS
+// The frame clock, shared by all the animated effects
+static rgblight_frame_func_t rgblight_frame = NULL;
+static uint8_t rgblight_frame_variant = 0;
+static uint16_t rgblight_frame_interval = 0;
+static uint16_t rgblight_frame_timer = 0;
+// set for the first frame after the mode changes, the effects start over
+static bool rgblight_frame_restart = false;
+#endif
+
+static const rgblight_effect_t *rgblight_find_effect(uint8_t mode, uint8_t *variant) {
+  const rgblight_effect_t *effect = rgblight_effects;
+  uint8_t index = mode - 1;
+  if (mode < 1 || mode > RGBLIGHT_MODES) {
+    index = 0;
+  }
+  while (index >= pgm_read_byte(&effect->variants) && effect < &rgblight_effects[RGBLIGHT_EFFECTS - 1]) {
+    index -= pgm_read_byte(&effect->variants);
+    effect++;
+  }
+  *variant = index;
+  return effect;
+}
+
+#ifdef RGBLIGHT_GAMMA_IN_RAM
+// Reading the table from flash is slower than from RAM on some ARM boards
+static uint8_t gamma_table[256];
+static bool gamma_table_loaded = false;
+
+static const uint8_t *rgblight_gamma_table(void) {
+  if (!gamma_table_loaded) {
+    for (uint16_t i = 0; i < 256; i++) {
+      gamma_table[i] = pgm_read_byte(&CIE1931_CURVE[i]);
+    }
+    gamma_table_loaded = true;
+  }
+  return gamma_table;
+}
+#define GAMMA(table, x) ((table)[x])
+#else
+#define rgblight_gamma_table() CIE1931_CURVE
+#define GAMMA(table, x) pgm_read_byte(&(table)[x])
+#endif
+
+// x / 60 for x up to 255 * 59, multiplying by 2^21 / 60 rounded up is exact
+// in that range
+#define DIV60(x) ((uint8_t)(((uint32_t)(x) * 34953) >> 21))
+
+void sethsv_strip(uint16_t hue, int16_t hue_step, uint8_t sat, uint8_t val, LED_TYPE *leds, uint16_t count) {
+  uint8_t base, span, sector, offset, sector_step, offset_step;
+  const uint8_t *gamma = rgblight_gamma_table();
+  uint16_t i;
 
   #ifdef RGBLIGHT_LIMIT_VAL
     if (val > RGBLIGHT_LIMIT_VAL) {
@@ -53,51 +155,81 @@ void sethsv(uint16_t hue, uint8_t sat, uint8_t val, LED_TYPE *led1) {
   #endif
 
   if (sat == 0) { // Acromatic color (gray). Hue doesn't mind.
-    r = val;
-    g = val;
-    b = val;
+    base = val;
+    span = 0;
   } else {
     base = ((255 - sat) * val) >> 8;
-    color = (val - base) * (hue % 60) / 60;
+    span = val - base;
+  }
 
-    switch (hue / 60) {
+  // The hue is kept as the sector of 60 degrees and the offset into it, so
+  // that stepping it doesn't need any division
+  hue %= 360;
+  sector = hue / 60;
+  offset = hue % 60;
+  hue_step %= 360;
+  if (hue_step < 0) {
+    hue_step += 360;
+  }
+  sector_step = hue_step / 60;
+  offset_step = hue_step % 60;
+
+  for (i = 0; i < count; i++) {
+    uint8_t color = DIV60(span * offset);
+    LED_TYPE *led1 = &leds[i];
+    switch (sector) {
       case 0:
-        r = val;
-        g = base + color;
-        b = base;
+        led1->r = base + span;
+        led1->g = base + color;
+        led1->b = base;
         break;
       case 1:
-        r = val - color;
-        g = val;
-        b = base;
+        led1->r = base + span - color;
+        led1->g = base + span;
+        led1->b = base;
         break;
       case 2:
-        r = base;
-        g = val;
-        b = base + color;
+        led1->r = base;
+        led1->g = base + span;
+        led1->b = base + color;
         break;
       case 3:
-        r = base;
-        g = val - color;
-        b = val;
+        led1->r = base;
+        led1->g = base + span - color;
+        led1->b = base + span;
         break;
       case 4:
-        r = base + color;
-        g = base;
-        b = val;
+        led1->r = base + color;
+        led1->g = base;
+        led1->b = base + span;
         break;
-      case 5:
-        r = val;
-        g = base;
-        b = val - color;
+      default:
+        led1->r = base + span;
+        led1->g = base;
+        led1->b = base + span - color;
         break;
     }
+    offset += offset_step;
+    sector += sector_step;
+    if (offset >= 60) {
+      offset -= 60;
+      sector++;
+    }
+    if (sector >= 6) {
+      sector -= 6;
+    }
   }
-  r = pgm_read_byte(&CIE1931_CURVE[r]);
-  g = pgm_read_byte(&CIE1931_CURVE[g]);
-  b = pgm_read_byte(&CIE1931_CURVE[b]);
 
-  setrgb(r, g, b, led1);
+  // and the gamma correction is done in one go
+  for (i = 0; i < count; i++) {
+    leds[i].r = GAMMA(gamma, leds[i].r);
+    leds[i].g = GAMMA(gamma, leds[i].g);
+    leds[i].b = GAMMA(gamma, leds[i].b);
+  }
+}
+
+void sethsv(uint16_t hue, uint8_t sat, uint8_t val, LED_TYPE *led1) {
+  sethsv_strip(hue, 0, sat, val, led1, 1);
 }
 
 void setrgb(uint8_t r, uint8_t g, uint8_t b, LED_TYPE *led1) {
@@ -224,29 +356,26 @@ void rgblight_mode(uint8_t mode) {
   }
   eeconfig_update_rgblight(rgblight_config.raw);
   xprintf("rgblight mode: %u\n", rgblight_config.mode);
-  if (rgblight_config.mode == 1) {
-    #ifdef RGBLIGHT_ANIMATIONS
-      rgblight_timer_disable();
-    #endif
-  } else if (rgblight_config.mode >= 2 && rgblight_config.mode <= 24) {
-    // MODE 2-5, breathing
-    // MODE 6-8, rainbow mood
-    // MODE 9-14, rainbow swirl
-    // MODE 15-20, snake
-    // MODE 21-23, knight
-    // MODE 24, xmas
-    // MODE 25-34, static rainbow
-
-    #ifdef RGBLIGHT_ANIMATIONS
+  #ifdef RGBLIGHT_ANIMATIONS
+    const rgblight_effect_t *effect = rgblight_find_effect(rgblight_config.mode, &rgblight_frame_variant);
+    uint8_t flags = pgm_read_byte(&effect->flags);
+    if (flags & RGBLIGHT_EFFECT_ANIMATED) {
+      const uint8_t *intervals = (const uint8_t *)pgm_read_ptr(&effect->intervals);
+      if (intervals) {
+        uint8_t speed = (flags & RGBLIGHT_EFFECT_DIRECTION) ? rgblight_frame_variant / 2 : rgblight_frame_variant;
+        rgblight_frame_interval = pgm_read_byte(&intervals[speed]);
+      } else {
+        rgblight_frame_interval = pgm_read_word(&effect->interval);
+      }
+      rgblight_frame = (rgblight_frame_func_t)pgm_read_ptr(&effect->frame);
+      // draw the first frame straight away
+      rgblight_frame_timer = timer_read() - rgblight_frame_interval;
+      rgblight_frame_restart = true;
       rgblight_timer_enable();
-    #endif
-  } else if (rgblight_config.mode >= 25 && rgblight_config.mode <= 34) {
-    // MODE 25-34, static gradient
-
-    #ifdef RGBLIGHT_ANIMATIONS
+    } else {
       rgblight_timer_disable();
-    #endif
-  }
+    }
+  #endif
   rgblight_sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val);
 }
 
@@ -274,7 +403,7 @@ void rgblight_disable(void) {
   #ifdef RGBLIGHT_ANIMATIONS
     rgblight_timer_disable();
   #endif
-  _delay_ms(50);
+  wait_ms(50);
   rgblight_set();
 }
 
@@ -344,33 +473,23 @@ void rgblight_sethsv_noeeprom(uint16_t hue, uint8_t sat, uint8_t val) {
 }
 void rgblight_sethsv(uint16_t hue, uint8_t sat, uint8_t val) {
   if (rgblight_config.enable) {
-    if (rgblight_config.mode == 1) {
-      // same static color
-      rgblight_sethsv_noeeprom(hue, sat, val);
-    } else {
-      // all LEDs in same color
-      if (rgblight_config.mode >= 2 && rgblight_config.mode <= 5) {
-        // breathing mode, ignore the change of val, use in memory value instead
-        val = rgblight_config.val;
-      } else if (rgblight_config.mode >= 6 && rgblight_config.mode <= 14) {
-        // rainbow mood and rainbow swirl, ignore the change of hue
-        hue = rgblight_config.hue;
-      } else if (rgblight_config.mode >= 25 && rgblight_config.mode <= 34) {
-        // static gradient
-        uint16_t _hue;
-        int8_t direction = ((rgblight_config.mode - 25) % 2) ? -1 : 1;
-        uint16_t range = pgm_read_word(&RGBLED_GRADIENT_RANGES[(rgblight_config.mode - 25) / 2]);
-        for (uint8_t i = 0; i < RGBLED_NUM; i++) {
-          _hue = (range / RGBLED_NUM * i * direction + hue + 360) % 360;
-          dprintf("rgblight rainbow set hsv: %u,%u,%d,%u\n", i, _hue, direction, range);
-          sethsv(_hue, sat, val, (LED_TYPE *)&led[i]);
-        }
-        rgblight_set();
-      }
+    uint8_t variant;
+    const rgblight_effect_t *effect = rgblight_find_effect(rgblight_config.mode, &variant);
+    uint8_t flags = pgm_read_byte(&effect->flags);
+    if (flags & RGBLIGHT_EFFECT_KEEP_VAL) {
+      val = rgblight_config.val;
+    }
+    if (flags & RGBLIGHT_EFFECT_KEEP_HUE) {
+      hue = rgblight_config.hue;
     }
     rgblight_config.hue = hue;
     rgblight_config.sat = sat;
     rgblight_config.val = val;
+    // animated effects pick up the new color on their next frame
+    if (!(flags & RGBLIGHT_EFFECT_ANIMATED)) {
+      rgblight_frame_func_t frame = (rgblight_frame_func_t)pgm_read_ptr(&effect->frame);
+      frame(variant);
+    }
     eeconfig_update_rgblight(rgblight_config.raw);
     xprintf("rgblight set hsv [EEPROM]: %u,%u,%u\n", rgblight_config.hue, rgblight_config.sat, rgblight_config.val);
   }
@@ -416,26 +535,34 @@ void rgblight_sethsv_at(uint16_t hue, uint8_t sat, uint8_t val, uint8_t index) {
   rgblight_setrgb_at(tmp_led.r, tmp_led.g, tmp_led.b, index);
 }
 
+static void rgblight_effect_static_light(uint8_t variant) {
+  rgblight_sethsv_noeeprom(rgblight_config.hue, rgblight_config.sat, rgblight_config.val);
+}
+
 #ifndef RGBLIGHT_CUSTOM_DRIVER
+// What the LEDs are showing, so that a frame that didn't change anything
+// isn't sent again
+static LED_TYPE led_sent[RGBLED_NUM];
+static bool led_sent_valid = false;
+
 void rgblight_set(void) {
-  if (rgblight_config.enable) {
-    #ifdef RGBW
-      ws2812_setleds_rgbw(led, RGBLED_NUM);
-    #else
-      ws2812_setleds(led, RGBLED_NUM);
-    #endif
-  } else {
+  if (!rgblight_config.enable) {
     for (uint8_t i = 0; i < RGBLED_NUM; i++) {
       led[i].r = 0;
       led[i].g = 0;
       led[i].b = 0;
     }
-    #ifdef RGBW
-      ws2812_setleds_rgbw(led, RGBLED_NUM);
-    #else
-      ws2812_setleds(led, RGBLED_NUM);
-    #endif
   }
+  if (led_sent_valid && memcmp(led_sent, led, sizeof(led)) == 0) {
+    return;
+  }
+  memcpy(led_sent, led, sizeof(led));
+  led_sent_valid = true;
+  #ifdef RGBW
+    ws2812_setleds_rgbw(led, RGBLED_NUM);
+  #else
+    ws2812_setleds(led, RGBLED_NUM);
+  #endif
 }
 #endif
 
@@ -480,71 +607,65 @@ void rgblight_show_solid_color(uint8_t r, uint8_t g, uint8_t b) {
 }
 
 void rgblight_task(void) {
-  if (rgblight_timer_enabled) {
-    // mode = 1, static light, do nothing here
-    if (rgblight_config.mode >= 2 && rgblight_config.mode <= 5) {
-      // mode = 2 to 5, breathing mode
-      rgblight_effect_breathing(rgblight_config.mode - 2);
-    } else if (rgblight_config.mode >= 6 && rgblight_config.mode <= 8) {
-      // mode = 6 to 8, rainbow mood mod
-      rgblight_effect_rainbow_mood(rgblight_config.mode - 6);
-    } else if (rgblight_config.mode >= 9 && rgblight_config.mode <= 14) {
-      // mode = 9 to 14, rainbow swirl mode
-      rgblight_effect_rainbow_swirl(rgblight_config.mode - 9);
-    } else if (rgblight_config.mode >= 15 && rgblight_config.mode <= 20) {
-      // mode = 15 to 20, snake mode
-      rgblight_effect_snake(rgblight_config.mode - 15);
-    } else if (rgblight_config.mode >= 21 && rgblight_config.mode <= 23) {
-      // mode = 21 to 23, knight mode
-      rgblight_effect_knight(rgblight_config.mode - 21);
-    } else if (rgblight_config.mode == 24) {
-      // mode = 24, christmas mode
-      rgblight_effect_christmas();
-    }
+  if (rgblight_timer_enabled && rgblight_frame && timer_elapsed(rgblight_frame_timer) >= rgblight_frame_interval) {
+    rgblight_frame_timer = timer_read();
+    rgblight_frame(rgblight_frame_variant);
+    rgblight_frame_restart = false;
   }
 }
 
 // Effects
+
+// exp(sin(x)) for the first half of the breath, from 0 at exp(0) to 255 at e
+// http://sean.voisen.org/blog/2011/10/breathing-led-with-arduino/
+static const uint8_t BREATHING_CURVE[] PROGMEM = {
+  0, 2, 4, 6, 7, 9, 11, 13, 15, 17, 19, 21, 24, 26, 28, 30,
+  32, 34, 37, 39, 41, 43, 46, 48, 50, 53, 55, 57, 60, 62, 65, 67,
+  69, 72, 74, 77, 80, 82, 85, 87, 90, 92, 95, 98, 100, 103, 105, 108,
+  111, 113, 116, 119, 121, 124, 127, 129, 132, 135, 137, 140, 143, 145, 148, 151,
+  153, 156, 158, 161, 164, 166, 169, 171, 174, 176, 179, 181, 184, 186, 188, 191,
+  193, 195, 198, 200, 202, 204, 207, 209, 211, 213, 215, 217, 219, 221, 223, 224,
+  226, 228, 229, 231, 233, 234, 236, 237, 239, 240, 241, 242, 244, 245, 246, 247,
+  248, 249, 249, 250, 251, 252, 252, 253, 253, 254, 254, 254, 255, 255, 255, 255,
+};
+
+// val = (exp(sin(x)) - CENTER / e) * MAX / (e - 1 / e) is linear in the curve,
+// the compiler works out the scale and offset in 1/256ths
+#define BREATHING_SCALE ((int32_t)(RGBLIGHT_EFFECT_BREATHE_MAX * (M_E - 1) / (M_E - 1 / M_E) * 256 / 255 + 0.5))
+#define BREATHING_OFFSET ((int32_t)(RGBLIGHT_EFFECT_BREATHE_MAX * (1 - RGBLIGHT_EFFECT_BREATHE_CENTER / M_E) / (M_E - 1 / M_E) * 256))
+
 void rgblight_effect_breathing(uint8_t interval) {
   static uint8_t pos = 0;
-  static uint16_t last_timer = 0;
-  float val;
-
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_BREATHING_INTERVALS[interval])) {
-    return;
+  if (rgblight_frame_restart) {
+    pos = 0;
   }
-  last_timer = timer_read();
-
+  uint8_t curve = pgm_read_byte(&BREATHING_CURVE[pos < 128 ? pos : 255 - pos]);
+  int32_t val = curve * BREATHING_SCALE + BREATHING_OFFSET;
 
-  // http://sean.voisen.org/blog/2011/10/breathing-led-with-arduino/
-  val = (exp(sin((pos/255.0)*M_PI)) - RGBLIGHT_EFFECT_BREATHE_CENTER/M_E)*(RGBLIGHT_EFFECT_BREATHE_MAX/(M_E-1/M_E));
-  rgblight_sethsv_noeeprom(rgblight_config.hue, rgblight_config.sat, val);
-  pos = (pos + 1) % 256;
+  if (val < 0) {
+    val = 0;
+  } else if (val > 255 * 256) {
+    val = 255 * 256;
+  }
+  rgblight_sethsv_noeeprom(rgblight_config.hue, rgblight_config.sat, val >> 8);
+  pos++;
 }
 void rgblight_effect_rainbow_mood(uint8_t interval) {
   static uint16_t current_hue = 0;
-  static uint16_t last_timer = 0;
 
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_RAINBOW_MOOD_INTERVALS[interval])) {
-    return;
+  if (rgblight_frame_restart) {
+    current_hue = 0;
   }
-  last_timer = timer_read();
   rgblight_sethsv_noeeprom(current_hue, rgblight_config.sat, rgblight_config.val);
   current_hue = (current_hue + 1) % 360;
 }
 void rgblight_effect_rainbow_swirl(uint8_t interval) {
   static uint16_t current_hue = 0;
-  static uint16_t last_timer = 0;
-  uint16_t hue;
-  uint8_t i;
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_RAINBOW_SWIRL_INTERVALS[interval / 2])) {
-    return;
-  }
-  last_timer = timer_read();
-  for (i = 0; i < RGBLED_NUM; i++) {
-    hue = (360 / RGBLED_NUM * i + current_hue) % 360;
-    sethsv(hue, rgblight_config.sat, rgblight_config.val, (LED_TYPE *)&led[i]);
+
+  if (rgblight_frame_restart) {
+    current_hue = 0;
   }
+  sethsv_strip(current_hue, 360 / RGBLED_NUM, rgblight_config.sat, rgblight_config.val, led, RGBLED_NUM);
   rgblight_set();
 
   if (interval % 2) {
@@ -559,29 +680,25 @@ void rgblight_effect_rainbow_swirl(uint8_t interval) {
 }
 void rgblight_effect_snake(uint8_t interval) {
   static uint8_t pos = 0;
-  static uint16_t last_timer = 0;
-  uint8_t i, j;
+  uint8_t j;
   int8_t k;
   int8_t increment = 1;
   if (interval % 2) {
     increment = -1;
   }
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_SNAKE_INTERVALS[interval / 2])) {
-    return;
+  if (rgblight_frame_restart) {
+    pos = 0;
   }
-  last_timer = timer_read();
-  for (i = 0; i < RGBLED_NUM; i++) {
-    led[i].r = 0;
-    led[i].g = 0;
-    led[i].b = 0;
-    for (j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
-      k = pos + j * increment;
-      if (k < 0) {
-        k = k + RGBLED_NUM;
-      }
-      if (i == k) {
-        sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val*(RGBLIGHT_EFFECT_SNAKE_LENGTH-j)/RGBLIGHT_EFFECT_SNAKE_LENGTH), (LED_TYPE *)&led[i]);
-      }
+
+  memset(led, 0, sizeof(led));
+  // only the head and the tail of the snake are drawn
+  for (j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
+    k = pos + j * increment;
+    if (k < 0) {
+      k = k + RGBLED_NUM;
+    }
+    if (k < RGBLED_NUM) {
+      sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val*(RGBLIGHT_EFFECT_SNAKE_LENGTH-j)/RGBLIGHT_EFFECT_SNAKE_LENGTH), (LED_TYPE *)&led[k]);
     }
   }
   rgblight_set();
@@ -596,33 +713,23 @@ void rgblight_effect_snake(uint8_t interval) {
   }
 }
 void rgblight_effect_knight(uint8_t interval) {
-  static uint16_t last_timer = 0;
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_KNIGHT_INTERVALS[interval])) {
-    return;
-  }
-  last_timer = timer_read();
-
   static int8_t low_bound = 0;
   static int8_t high_bound = RGBLIGHT_EFFECT_KNIGHT_LENGTH - 1;
   static int8_t increment = 1;
-  uint8_t i, cur;
-
-  // Set all the LEDs to 0
-  for (i = 0; i < RGBLED_NUM; i++) {
-    led[i].r = 0;
-    led[i].g = 0;
-    led[i].b = 0;
-  }
-  // Determine which LEDs should be lit up
-  for (i = 0; i < RGBLIGHT_EFFECT_KNIGHT_LED_NUM; i++) {
-    cur = (i + RGBLIGHT_EFFECT_KNIGHT_OFFSET) % RGBLED_NUM;
-
-    if (i >= low_bound && i <= high_bound) {
-      sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, (LED_TYPE *)&led[cur]);
-    } else {
-      led[cur].r = 0;
-      led[cur].g = 0;
-      led[cur].b = 0;
+  LED_TYPE color = {0};
+  int8_t i;
+
+  if (rgblight_frame_restart) {
+    low_bound = 0;
+    high_bound = RGBLIGHT_EFFECT_KNIGHT_LENGTH - 1;
+    increment = 1;
+  }
+  sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, &color);
+  // Set all the LEDs to 0, and light up the ones between the bounds
+  memset(led, 0, sizeof(led));
+  for (i = low_bound; i <= high_bound; i++) {
+    if (i >= 0 && i < RGBLIGHT_EFFECT_KNIGHT_LED_NUM) {
+      led[(i + RGBLIGHT_EFFECT_KNIGHT_OFFSET) % RGBLED_NUM] = color;
     }
   }
   rgblight_set();
@@ -638,20 +745,37 @@ void rgblight_effect_knight(uint8_t interval) {
 }
 
 
-void rgblight_effect_christmas(void) {
-  static uint16_t current_offset = 0;
-  static uint16_t last_timer = 0;
-  uint16_t hue;
-  uint8_t i;
-  if (timer_elapsed(last_timer) < RGBLIGHT_EFFECT_CHRISTMAS_INTERVAL) {
-    return;
+void rgblight_effect_christmas(uint8_t interval) {
+  static uint8_t current_offset = 0;
+  LED_TYPE colors[2] = {{0}};
+  uint8_t i, color, step;
+
+  if (rgblight_frame_restart) {
+    current_offset = 0;
   }
-  last_timer = timer_read();
-  current_offset = (current_offset + 1) % 2;
+  current_offset = !current_offset;
+  // red and green, alternating every RGBLIGHT_EFFECT_CHRISTMAS_STEP LEDs
+  sethsv(0, rgblight_config.sat, rgblight_config.val, &colors[0]);
+  sethsv(120, rgblight_config.sat, rgblight_config.val, &colors[1]);
+  color = current_offset;
+  step = 0;
   for (i = 0; i < RGBLED_NUM; i++) {
-    hue = 0 + ((i/RGBLIGHT_EFFECT_CHRISTMAS_STEP + current_offset) % 2) * 120;
-    sethsv(hue, rgblight_config.sat, rgblight_config.val, (LED_TYPE *)&led[i]);
+    led[i] = colors[color];
+    if (++step == RGBLIGHT_EFFECT_CHRISTMAS_STEP) {
+      step = 0;
+      color = !color;
+    }
+  }
+  rgblight_set();
+}
+
+static void rgblight_effect_static_gradient(uint8_t variant) {
+  int16_t step = pgm_read_word(&RGBLED_GRADIENT_RANGES[variant / 2]) / RGBLED_NUM;
+
+  if (variant % 2) {
+    step = -step;
   }
+  sethsv_strip(rgblight_config.hue, step, rgblight_config.sat, rgblight_config.val, led, RGBLED_NUM);
   rgblight_set();
 }
 
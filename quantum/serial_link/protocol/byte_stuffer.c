@@ -26,6 +26,7 @@ SOFTWARE.
 #include "serial_link/protocol/frame_validator.h"
 #include "serial_link/protocol/physical.h"
 #include <stdbool.h>
+#include <string.h>
 
 // This implements the "Consistent overhead byte stuffing protocol"
 // https://en.wikipedia.org/wiki/Consistent_Overhead_Byte_Stuffing
@@ -102,41 +103,110 @@ void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
     }
 }
 
-static void send_block(uint8_t link, uint8_t* start, uint8_t* end, uint8_t num_non_zero) {
-    send_data(link, &num_non_zero, 1);
-    if (end > start) {
-        send_data(link, start, end-start);
+// Decodes a frame in place, the data ends just before the zero delimiter
+// Returns the size of the frame, or 0 if it's invalid or empty
+static uint16_t decode_in_place(uint8_t* data, uint16_t size) {
+    const uint8_t* in = data;
+    const uint8_t* end = data + size;
+    uint8_t* out = data;
+    while (in < end) {
+        uint8_t code = *in++;
+        if (code - 1 > end - in) {
+            // The block runs past the end of the frame
+            return 0;
+        }
+        // The blocks are short, as frames are mostly zeros
+        uint8_t num_non_zero = code - 1;
+        while (num_non_zero--) {
+            *out++ = *in++;
+        }
+        // The zero that the code replaced, long blocks don't have one
+        if (in < end && code != 0xFF) {
+            *out++ = 0;
+        }
     }
+    return out - data;
 }
 
-void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
-    const uint8_t zero = 0;
-    if (size > 0) {
-        uint16_t num_non_zero = 1;
-        uint8_t* end = data + size;
-        uint8_t* start = data;
-        while (data < end) {
-            if (num_non_zero == 0xFF) {
-                // There's more data after big non-zero block
-                // So send it, and start a new block
-                send_block(link, start, data, num_non_zero);
-                start = data;
-                num_non_zero = 1;
-            }
-            else {
-                if (*data == 0) {
-                    // A zero encountered, so send the block
-                    send_block(link, start, data, num_non_zero);
-                    start = data + 1;
-                    num_non_zero = 1;
-                }
-                else {
-                    num_non_zero++;
-                }
-                ++data;
+static void recv_bytes(uint8_t link, const uint8_t* data, uint16_t size) {
+    while (size--) {
+        byte_stuffer_recv_byte(link, *data++);
+    }
+}
+
+void byte_stuffer_recv(uint8_t link, uint8_t* data, uint16_t size) {
+    byte_stuffer_state_t* state = &states[link];
+    uint8_t* end = data + size;
+    // Finish the frame that started in an earlier buffer
+    if (state->next_zero != 0) {
+        uint8_t* zero = memchr(data, 0, size);
+        if (!zero) {
+            recv_bytes(link, data, size);
+            return;
+        }
+        recv_bytes(link, data, zero - data + 1);
+        data = zero + 1;
+    }
+    // Every zero now ends a frame
+    while (data < end) {
+        uint8_t* zero = memchr(data, 0, end - data);
+        if (!zero) {
+            // The rest of the frame comes in a later buffer
+            recv_bytes(link, data, end - data);
+            return;
+        }
+        if (zero - data > MAX_FRAME_SIZE + 1) {
+            // Might be too big to receive, which only the byte by byte
+            // decoder handles
+            recv_bytes(link, data, zero - data + 1);
+        }
+        else {
+            uint16_t frame_size = decode_in_place(data, zero - data);
+            if (frame_size > 0) {
+                validator_recv_frame(link, data, frame_size);
             }
         }
-        send_block(link, start, data, num_non_zero);
-        send_data(link, &zero, 1);
+        data = zero + 1;
+    }
+}
+
+uint16_t byte_stuffer_encode(const uint8_t* data, uint16_t size, uint8_t* encoded) {
+    const uint8_t* end = data + size;
+    uint8_t* out = encoded;
+    // The code of the current block is written when the block ends
+    uint8_t* code = out++;
+    uint8_t num_non_zero = 1;
+    while (data < end) {
+        if (num_non_zero == 0xFF) {
+            // There's more data after big non-zero block
+            // So start a new block
+            *code = num_non_zero;
+            code = out++;
+            num_non_zero = 1;
+        }
+        if (*data == 0) {
+            *code = num_non_zero;
+            code = out++;
+            num_non_zero = 1;
+        }
+        else {
+            *out++ = *data;
+            num_non_zero++;
+        }
+        ++data;
+    }
+    *code = num_non_zero;
+    *out++ = 0;
+    return out - encoded;
+}
+
+void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
+    // Frames are only sent from serialThread in serial_link.c, both the
+    // objects from update_transport and the frames forwarded by the router,
+    // so one buffer is enough
+    static uint8_t encoded[BYTE_STUFFER_ENCODED_SIZE(MAX_FRAME_SIZE)];
+    // The receiver can't handle bigger frames either
+    if (size > 0 && size <= MAX_FRAME_SIZE) {
+        send_data(link, encoded, byte_stuffer_encode(data, size, encoded));
     }
 }
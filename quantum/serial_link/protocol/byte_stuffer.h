@@ -29,9 +29,17 @@ SOFTWARE.
 
 #define MAX_FRAME_SIZE 1024
 #define NUM_LINKS 2
+// A code byte for every 254 bytes, and the one at the start and the zero at the end
+#define BYTE_STUFFER_ENCODED_SIZE(size) ((size) + (size) / 254 + 2)
 
 void init_byte_stuffer(void);
 void byte_stuffer_recv_byte(uint8_t link, uint8_t data);
+// Receives a buffer of bytes, frames that are completely in the buffer are
+// decoded in place, which modifies the buffer
+void byte_stuffer_recv(uint8_t link, uint8_t* data, uint16_t size);
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size);
+// Encodes a whole frame, including the terminating zero, into a buffer of
+// BYTE_STUFFER_ENCODED_SIZE(size) bytes, and returns the encoded size
+uint16_t byte_stuffer_encode(const uint8_t* data, uint16_t size, uint8_t* encoded);
 
 #endif
@@ -27,8 +27,17 @@ SOFTWARE.
 
 #include <stdint.h>
 
+// Frames end with a CRC-32, or a CRC-16 with SERIAL_LINK_CRC16, which is
+// calculated by the CRC unit of the MCU with SERIAL_LINK_HW_CRC
+#ifdef SERIAL_LINK_CRC16
+#define VALIDATOR_CRC_SIZE 2
+#else
+#define VALIDATOR_CRC_SIZE 4
+#endif
+
 void validator_recv_frame(uint8_t link, uint8_t* data, uint16_t size);
-// The buffer pointed to by the data needs 4 additional bytes
+// The buffer pointed to by the data needs VALIDATOR_CRC_SIZE additional bytes
 void validator_send_frame(uint8_t link, uint8_t* data, uint16_t size);
+uint32_t validator_crc(const uint8_t* data, uint16_t size);
 
 #endif
@@ -25,102 +25,270 @@ SOFTWARE.
 #include "serial_link/protocol/transport.h"
 #include "serial_link/protocol/frame_router.h"
 #include "serial_link/protocol/triple_buffered_object.h"
+#include "serial_link/protocol/byte_stuffer.h"
 #include <string.h>
+#include <stdbool.h>
 
-#define MAX_REMOTE_OBJECTS 16
-static remote_object_t* remote_objects[MAX_REMOTE_OBJECTS];
+static remote_object_t* remote_objects[SERIAL_LINK_MAX_OBJECTS];
 static uint32_t num_remote_objects = 0;
+// The buffers of all objects, one after another
+static uint8_t arena[SERIAL_LINK_ARENA_SIZE] __attribute__((aligned(4)));
+static uint16_t arena_used = 0;
+// A bit for each object written since the last update_transport
+static uint32_t pending_objects = 0;
+
+// Frames end with the sequence number and the object id, the top bit of the
+// sequence number marks a delta frame
+// keyframe: object, sequence, id
+// delta:    changed chunks, mask of changed chunks, sequence, id
+#define DELTA_FRAME 0x80
+#define SEQUENCE_MASK 0x7F
+#define NUM_CHUNKS(size) (((size) + DELTA_CHUNK_SIZE - 1) / DELTA_CHUNK_SIZE)
+#define CHUNK_MASK_SIZE(size) ((NUM_CHUNKS(size) + 7) / 8)
+
+static delta_stream_t* local_stream(uint8_t* start, uint16_t object_size) {
+    return (delta_stream_t*)(start + sizeof(triple_buffer_object_t) + (object_size + LOCAL_OBJECT_EXTRA) * 3);
+}
+
+static delta_stream_t* remote_stream(uint8_t* start, uint16_t object_size) {
+    return (delta_stream_t*)(start + sizeof(triple_buffer_object_t) + object_size * 3);
+}
+
+static uint8_t* stream_object(delta_stream_t* stream) {
+    return (uint8_t*)(stream + 1);
+}
+
+static uint16_t chunk_size(uint16_t object_size, uint16_t pos) {
+    return object_size - pos < DELTA_CHUNK_SIZE ? object_size - pos : DELTA_CHUNK_SIZE;
+}
+
+static void init_local_object(uint8_t* start, uint16_t object_size) {
+    triple_buffer_init((triple_buffer_object_t*)start);
+    delta_stream_t* stream = local_stream(start, object_size);
+    stream->sequence = 0;
+    // Start with a keyframe
+    stream->state = 0;
+}
+
+static void init_remote_object(uint8_t* start, uint16_t object_size) {
+    triple_buffer_init((triple_buffer_object_t*)start);
+    delta_stream_t* stream = remote_stream(start, object_size);
+    stream->sequence = 0;
+    stream->state = false;
+}
+
+static uint16_t object_storage_size(remote_object_t* obj) {
+    uint16_t local_size = LOCAL_OBJECT_SIZE(obj->object_size);
+    uint16_t remote_size = REMOTE_OBJECT_SIZE(obj->object_size);
+    if (obj->object_type == MASTER_TO_ALL_SLAVES) {
+        return local_size + remote_size;
+    }
+    else if(obj->object_type == MASTER_TO_SINGLE_SLAVE) {
+        return NUM_SLAVES * local_size + remote_size;
+    }
+    else {
+        return local_size + NUM_SLAVES * remote_size;
+    }
+}
 
 void reinitialize_serial_link_transport(void) {
     num_remote_objects = 0;
+    arena_used = 0;
+    pending_objects = 0;
 }
 
-void add_remote_objects(remote_object_t** _remote_objects, uint32_t _num_remote_objects) {
+bool add_remote_objects(remote_object_t** _remote_objects, uint32_t _num_remote_objects) {
     unsigned int i;
     for(i=0;i<_num_remote_objects;i++) {
         remote_object_t* obj = _remote_objects[i];
+        uint16_t size = object_storage_size(obj);
+        if (num_remote_objects == SERIAL_LINK_MAX_OBJECTS || size > SERIAL_LINK_ARENA_SIZE - arena_used) {
+            return false;
+        }
+        obj->id = num_remote_objects;
+        obj->buffer = arena + arena_used;
+        arena_used += size;
         remote_objects[num_remote_objects++] = obj;
+        uint8_t* start = obj->buffer;
         if (obj->object_type == MASTER_TO_ALL_SLAVES) {
-            triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer;
-            triple_buffer_init(tb);
-            uint8_t* start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
-            tb = (triple_buffer_object_t*)start;
-            triple_buffer_init(tb);
+            init_local_object(start, obj->object_size);
+            start += LOCAL_OBJECT_SIZE(obj->object_size);
+            init_remote_object(start, obj->object_size);
         }
         else if(obj->object_type == MASTER_TO_SINGLE_SLAVE) {
-            uint8_t* start = obj->buffer;
             unsigned int j;
             for (j=0;j<NUM_SLAVES;j++) {
-                triple_buffer_object_t* tb = (triple_buffer_object_t*)start;
-                triple_buffer_init(tb);
+                init_local_object(start, obj->object_size);
                 start += LOCAL_OBJECT_SIZE(obj->object_size);
             }
-            triple_buffer_object_t* tb = (triple_buffer_object_t*)start;
-            triple_buffer_init(tb);
+            init_remote_object(start, obj->object_size);
         }
         else {
-            uint8_t* start = obj->buffer;
-            triple_buffer_object_t* tb = (triple_buffer_object_t*)start;
-            triple_buffer_init(tb);
+            init_local_object(start, obj->object_size);
             start += LOCAL_OBJECT_SIZE(obj->object_size);
             unsigned int j;
             for (j=0;j<NUM_SLAVES;j++) {
-                tb = (triple_buffer_object_t*)start;
-                triple_buffer_init(tb);
+                init_remote_object(start, obj->object_size);
                 start += REMOTE_OBJECT_SIZE(obj->object_size);
             }
         }
     }
+    return true;
+}
+
+void transport_object_written(remote_object_t* obj) {
+    serial_link_lock();
+    pending_objects |= (uint32_t)1 << obj->id;
+    serial_link_unlock();
+    signal_data_written();
+}
+
+// Applies a frame, without the id, to the last object received
+static bool decode_frame(uint8_t* data, uint16_t size, uint16_t object_size, delta_stream_t* stream) {
+    if (size == 0) {
+        return false;
+    }
+    uint8_t sequence = data[--size];
+    uint8_t* object = stream_object(stream);
+    if (sequence & DELTA_FRAME) {
+        sequence &= SEQUENCE_MASK;
+        uint16_t mask_size = CHUNK_MASK_SIZE(object_size);
+        // A frame was lost, so wait for the next keyframe
+        if (!stream->state || sequence != ((stream->sequence + 1) & SEQUENCE_MASK) || size < mask_size) {
+            stream->state = false;
+            return false;
+        }
+        size -= mask_size;
+        const uint8_t* mask = data + size;
+        uint16_t pos;
+        uint16_t chunk;
+        uint16_t changed_size = 0;
+        for (pos = 0, chunk = 0; pos < object_size; pos += DELTA_CHUNK_SIZE, chunk++) {
+            if (mask[chunk / 8] & (1 << (chunk % 8))) {
+                changed_size += chunk_size(object_size, pos);
+            }
+        }
+        if (changed_size != size) {
+            stream->state = false;
+            return false;
+        }
+        for (pos = 0, chunk = 0; pos < object_size; pos += DELTA_CHUNK_SIZE, chunk++) {
+            if (mask[chunk / 8] & (1 << (chunk % 8))) {
+                uint16_t len = chunk_size(object_size, pos);
+                memcpy(object + pos, data, len);
+                data += len;
+            }
+        }
+    }
+    else {
+        if (size != object_size) {
+            return false;
+        }
+        memcpy(object, data, size);
+    }
+    stream->sequence = sequence;
+    stream->state = true;
+    return true;
 }
 
 void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size) {
+    if (size == 0) {
+        return;
+    }
     uint8_t id = data[size-1];
     if (id < num_remote_objects) {
         remote_object_t* obj = remote_objects[id];
-        if (obj->object_size == size - 1) {
-            uint8_t* start;
-            if (obj->object_type == MASTER_TO_ALL_SLAVES) {
-                start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
-            }
-            else if(obj->object_type == SLAVE_TO_MASTER) {
-                start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
-                start += (from - 1) * REMOTE_OBJECT_SIZE(obj->object_size);
-            }
-            else {
-                start = obj->buffer + NUM_SLAVES * LOCAL_OBJECT_SIZE(obj->object_size);
+        uint8_t* start = obj->buffer;
+        if (obj->object_type == MASTER_TO_ALL_SLAVES) {
+            start += LOCAL_OBJECT_SIZE(obj->object_size);
+        }
+        else if(obj->object_type == SLAVE_TO_MASTER) {
+            if (from == 0 || from > NUM_SLAVES) {
+                return;
             }
+            start += LOCAL_OBJECT_SIZE(obj->object_size);
+            start += (from - 1) * REMOTE_OBJECT_SIZE(obj->object_size);
+        }
+        else {
+            start += NUM_SLAVES * LOCAL_OBJECT_SIZE(obj->object_size);
+        }
+        delta_stream_t* stream = remote_stream(start, obj->object_size);
+        if (decode_frame(data, size - 1, obj->object_size, stream)) {
             triple_buffer_object_t* tb = (triple_buffer_object_t*)start;
             void* ptr = triple_buffer_begin_write_internal(obj->object_size, tb);
-            memcpy(ptr, data, size - 1);
+            memcpy(ptr, stream_object(stream), obj->object_size);
             triple_buffer_end_write_internal(tb);
         }
     }
 }
 
+// Turns the object into a frame in place, without the id, and returns its size
+static uint16_t encode_frame(uint8_t* data, uint16_t object_size, delta_stream_t* stream) {
+    uint8_t* last = stream_object(stream);
+    stream->sequence = (stream->sequence + 1) & SEQUENCE_MASK;
+    if (stream->state > 0 && object_size <= MAX_FRAME_SIZE) {
+        uint8_t mask[CHUNK_MASK_SIZE(MAX_FRAME_SIZE)];
+        uint16_t mask_size = CHUNK_MASK_SIZE(object_size);
+        memset(mask, 0, mask_size);
+        // Move the changed chunks to the front
+        uint16_t size = 0;
+        uint16_t pos;
+        uint16_t chunk;
+        for (pos = 0, chunk = 0; pos < object_size; pos += DELTA_CHUNK_SIZE, chunk++) {
+            uint16_t len = chunk_size(object_size, pos);
+            if (memcmp(data + pos, last + pos, len) != 0) {
+                mask[chunk / 8] |= 1 << (chunk % 8);
+                memcpy(last + pos, data + pos, len);
+                memmove(data + size, data + pos, len);
+                size += len;
+            }
+        }
+        if (size + mask_size < object_size) {
+            memcpy(data + size, mask, mask_size);
+            size += mask_size;
+            data[size++] = stream->sequence | DELTA_FRAME;
+            stream->state--;
+            return size;
+        }
+        // The delta isn't any smaller, so send the whole object
+        memcpy(data, last, object_size);
+    }
+    else {
+        memcpy(last, data, object_size);
+    }
+    data[object_size] = stream->sequence;
+    stream->state = SERIAL_LINK_KEYFRAME_INTERVAL - 1;
+    return object_size + 1;
+}
+
+static void send_object(uint8_t id, uint8_t destination, remote_object_t* obj, uint8_t* start) {
+    triple_buffer_object_t* tb = (triple_buffer_object_t*)start;
+    uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size + LOCAL_OBJECT_EXTRA, tb);
+    if (ptr) {
+        uint16_t size = encode_frame(ptr, obj->object_size, local_stream(start, obj->object_size));
+        ptr[size] = id;
+        router_send_frame(destination, ptr, size + 1);
+    }
+}
+
 void update_transport(void) {
-    unsigned int i;
-    for(i=0;i<num_remote_objects;i++) {
+    serial_link_lock();
+    uint32_t pending = pending_objects;
+    pending_objects = 0;
+    serial_link_unlock();
+    while (pending) {
+        uint8_t i = __builtin_ctz(pending);
+        pending &= pending - 1;
         remote_object_t* obj = remote_objects[i];
+        uint8_t* start = obj->buffer;
         if (obj->object_type == MASTER_TO_ALL_SLAVES || obj->object_type == SLAVE_TO_MASTER) {
-            triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer;
-            uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size + LOCAL_OBJECT_EXTRA, tb);
-            if (ptr) {
-                ptr[obj->object_size] = i;
-                uint8_t dest = obj->object_type == MASTER_TO_ALL_SLAVES ? 0xFF : 0;
-                router_send_frame(dest, ptr, obj->object_size + 1);
-            }
+            uint8_t dest = obj->object_type == MASTER_TO_ALL_SLAVES ? 0xFF : 0;
+            send_object(i, dest, obj, start);
         }
         else {
-            uint8_t* start = obj->buffer;
             unsigned int j;
             for (j=0;j<NUM_SLAVES;j++) {
-                triple_buffer_object_t* tb = (triple_buffer_object_t*)start;
-                uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size + LOCAL_OBJECT_EXTRA, tb);
-                if (ptr) {
-                    ptr[obj->object_size] = i;
-                    uint8_t dest = j + 1;
-                    router_send_frame(dest, ptr, obj->object_size + 1);
-                }
+                send_object(i, j + 1, obj, start);
                 start += LOCAL_OBJECT_SIZE(obj->object_size);
             }
         }
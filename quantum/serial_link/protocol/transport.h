@@ -28,7 +28,24 @@ SOFTWARE.
 #include "serial_link/protocol/triple_buffered_object.h"
 #include "serial_link/system/serial_link.h"
 
-#define NUM_SLAVES 8
+// The number of slaves that can be chained after the master
+#ifndef SERIAL_LINK_NUM_SLAVES
+#define SERIAL_LINK_NUM_SLAVES 8
+#endif
+#define NUM_SLAVES SERIAL_LINK_NUM_SLAVES
+
+// The objects are registered with add_remote_objects, which allocates their
+// buffers from an arena of SERIAL_LINK_ARENA_SIZE bytes
+#ifndef SERIAL_LINK_MAX_OBJECTS
+#define SERIAL_LINK_MAX_OBJECTS 16
+#endif
+#if SERIAL_LINK_MAX_OBJECTS > 32
+#error "SERIAL_LINK_MAX_OBJECTS can be at most 32"
+#endif
+#ifndef SERIAL_LINK_ARENA_SIZE
+#define SERIAL_LINK_ARENA_SIZE (512 + 256 * SERIAL_LINK_NUM_SLAVES)
+#endif
+
 #define LOCAL_OBJECT_EXTRA 16
 
 // master -> slave = 1 local(target all), 1 remote object
@@ -43,99 +60,102 @@ typedef enum {
 typedef struct {
     remote_object_type object_type;
     uint16_t object_size;
-    uint8_t buffer[] __attribute__((aligned(4)));
+    // Set by add_remote_objects
+    uint8_t id;
+    uint8_t* buffer;
 } remote_object_t;
 
+// Objects are sent as delta frames, with only the chunks that changed since
+// the previous frame, and a full keyframe every SERIAL_LINK_KEYFRAME_INTERVAL
+// frames, so that a receiver that lost a frame gets back in sync
+#ifndef SERIAL_LINK_KEYFRAME_INTERVAL
+#define SERIAL_LINK_KEYFRAME_INTERVAL 16
+#endif
+#define DELTA_CHUNK_SIZE 4
+
+// Each stream of an object remembers the last object sent or received,
+// which the deltas are relative to
+typedef struct {
+    uint8_t sequence;
+    // frames left until the next keyframe when sending,
+    // whether the object is in sync when receiving
+    uint8_t state;
+} delta_stream_t;
+
+// Keeps the triple buffers aligned
+#define REMOTE_OBJECT_ALIGN(size) (((size) + 3) & ~3)
+#define DELTA_STREAM_SIZE(objectsize) \
+    (sizeof(delta_stream_t) + objectsize)
 #define REMOTE_OBJECT_SIZE(objectsize) \
-    (sizeof(triple_buffer_object_t) + objectsize * 3)
+    REMOTE_OBJECT_ALIGN(sizeof(triple_buffer_object_t) + objectsize * 3 + DELTA_STREAM_SIZE(objectsize))
 #define LOCAL_OBJECT_SIZE(objectsize) \
-    (sizeof(triple_buffer_object_t) + (objectsize + LOCAL_OBJECT_EXTRA) * 3)
+    REMOTE_OBJECT_ALIGN(sizeof(triple_buffer_object_t) + (objectsize + LOCAL_OBJECT_EXTRA) * 3 + DELTA_STREAM_SIZE(objectsize))
 
-#define REMOTE_OBJECT_HELPER(name, type, num_local, num_remote) \
-typedef struct { \
-    remote_object_t object; \
-    uint8_t buffer[ \
-        num_remote * REMOTE_OBJECT_SIZE(sizeof(type)) + \
-        num_local * LOCAL_OBJECT_SIZE(sizeof(type))]; \
-} remote_object_##name##_t;
+#define REMOTE_OBJECT_HELPER(name, type, object_type_) \
+    remote_object_t remote_object_##name = { \
+        .object_type = object_type_, \
+        .object_size = sizeof(type), \
+    };
 
 #define MASTER_TO_ALL_SLAVES_OBJECT(name, type) \
-    REMOTE_OBJECT_HELPER(name, type, 1, 1) \
-    remote_object_##name##_t remote_object_##name = { \
-        .object = { \
-            .object_type = MASTER_TO_ALL_SLAVES, \
-            .object_size = sizeof(type), \
-        } \
-    }; \
+    REMOTE_OBJECT_HELPER(name, type, MASTER_TO_ALL_SLAVES) \
     type* begin_write_##name(void) { \
-        remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
+        remote_object_t* obj = &remote_object_##name; \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer; \
         return (type*)triple_buffer_begin_write_internal(sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
     }\
     void end_write_##name(void) { \
-        remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
+        remote_object_t* obj = &remote_object_##name; \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer; \
         triple_buffer_end_write_internal(tb); \
-        signal_data_written(); \
+        transport_object_written(obj); \
     }\
     type* read_##name(void) { \
-        remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
+        remote_object_t* obj = &remote_object_##name; \
         uint8_t* start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);\
         triple_buffer_object_t* tb = (triple_buffer_object_t*)start; \
         return (type*)triple_buffer_read_internal(obj->object_size, tb); \
     }
 
 #define MASTER_TO_SINGLE_SLAVE_OBJECT(name, type) \
-    REMOTE_OBJECT_HELPER(name, type, NUM_SLAVES, 1) \
-    remote_object_##name##_t remote_object_##name = { \
-        .object = { \
-            .object_type = MASTER_TO_SINGLE_SLAVE, \
-            .object_size = sizeof(type), \
-        } \
-    }; \
+    REMOTE_OBJECT_HELPER(name, type, MASTER_TO_SINGLE_SLAVE) \
     type* begin_write_##name(uint8_t slave) { \
-        remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
+        remote_object_t* obj = &remote_object_##name; \
         uint8_t* start = obj->buffer;\
         start += slave * LOCAL_OBJECT_SIZE(obj->object_size); \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)start; \
         return (type*)triple_buffer_begin_write_internal(sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
     }\
     void end_write_##name(uint8_t slave) { \
-        remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
+        remote_object_t* obj = &remote_object_##name; \
         uint8_t* start = obj->buffer;\
         start += slave * LOCAL_OBJECT_SIZE(obj->object_size); \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)start; \
         triple_buffer_end_write_internal(tb); \
-        signal_data_written(); \
+        transport_object_written(obj); \
     }\
     type* read_##name() { \
-        remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
+        remote_object_t* obj = &remote_object_##name; \
         uint8_t* start = obj->buffer + NUM_SLAVES * LOCAL_OBJECT_SIZE(obj->object_size);\
         triple_buffer_object_t* tb = (triple_buffer_object_t*)start; \
         return (type*)triple_buffer_read_internal(obj->object_size, tb); \
     }
 
 #define SLAVE_TO_MASTER_OBJECT(name, type) \
-    REMOTE_OBJECT_HELPER(name, type, 1, NUM_SLAVES) \
-    remote_object_##name##_t remote_object_##name = { \
-        .object = { \
-            .object_type = SLAVE_TO_MASTER, \
-            .object_size = sizeof(type), \
-        } \
-    }; \
+    REMOTE_OBJECT_HELPER(name, type, SLAVE_TO_MASTER) \
     type* begin_write_##name(void) { \
-        remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
+        remote_object_t* obj = &remote_object_##name; \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer; \
         return (type*)triple_buffer_begin_write_internal(sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
     }\
     void end_write_##name(void) { \
-        remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
+        remote_object_t* obj = &remote_object_##name; \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)obj->buffer; \
         triple_buffer_end_write_internal(tb); \
-        signal_data_written(); \
+        transport_object_written(obj); \
     }\
     type* read_##name(uint8_t slave) { \
-        remote_object_t* obj = (remote_object_t*)&remote_object_##name; \
+        remote_object_t* obj = &remote_object_##name; \
         uint8_t* start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);\
         start+=slave * REMOTE_OBJECT_SIZE(obj->object_size); \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)start; \
@@ -144,8 +164,11 @@ typedef struct { \
 
 #define REMOTE_OBJECT(name) (remote_object_t*)&remote_object_##name
 
-void add_remote_objects(remote_object_t** remote_objects, uint32_t num_remote_objects);
+// Returns false if the objects don't all fit, the ones that don't fit aren't added
+bool add_remote_objects(remote_object_t** remote_objects, uint32_t num_remote_objects);
 void reinitialize_serial_link_transport(void);
+// Marks the object to be sent by the next update_transport
+void transport_object_written(remote_object_t* obj);
 void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size);
 void update_transport(void);
 
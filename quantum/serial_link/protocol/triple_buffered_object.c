@@ -27,52 +27,86 @@ SOFTWARE.
 #include <stdbool.h>
 #include <stddef.h>
 
-#define GET_READ_INDEX() object->state & 3
-#define GET_WRITE_INDEX() (object->state >> 2) & 3
-#define GET_SHARED_INDEX() (object->state >> 4) & 3
-#define GET_DATA_AVAILABLE() (object->state >> 6) & 1
+/*
+ * The whole state is a single byte, so the index swaps are done with a compare
+ * and swap loop instead of taking the system lock. The writer only ever changes
+ * the write and shared index, and the reader the read and shared index, so a
+ * failed exchange just means that the other side swapped the shared buffer.
+ *
+ * Parts without byte sized exclusive access, like the Cortex-M0, fall back to
+ * the serial link lock.
+ */
+#if __GCC_ATOMIC_CHAR_LOCK_FREE == 2
+#define TRIPLE_BUFFER_ATOMIC
+#endif
+
+#define READ_INDEX(state) ((state) & 3)
+#define WRITE_INDEX(state) (((state) >> 2) & 3)
+#define SHARED_INDEX(state) (((state) >> 4) & 3)
+#define DATA_AVAILABLE (1 << 6)
+
+#define MAKE_STATE(read, write, shared) ((read) | ((write) << 2) | ((shared) << 4))
+
+static inline uint8_t load_state(triple_buffer_object_t* object) {
+#ifdef TRIPLE_BUFFER_ATOMIC
+    return __atomic_load_n(&object->state, __ATOMIC_ACQUIRE);
+#else
+    return object->state;
+#endif
+}
+
+// Replaces expected with desired, or updates expected with the current
+// state and returns false if the other side has changed it
+static inline bool exchange_state(triple_buffer_object_t* object, uint8_t* expected, uint8_t desired) {
+#ifdef TRIPLE_BUFFER_ATOMIC
+    return __atomic_compare_exchange_n(&object->state, expected, desired, true,
+        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#else
+    // the state is only changed under the lock, so this always succeeds
+    object->state = desired;
+    return true;
+#endif
+}
 
-#define SET_READ_INDEX(i) object->state = ((object->state & ~3) | i)
-#define SET_WRITE_INDEX(i) object->state = ((object->state & ~(3 << 2)) | (i << 2))
-#define SET_SHARED_INDEX(i) object->state = ((object->state & ~(3 << 4)) | (i << 4))
-#define SET_DATA_AVAILABLE(i) object->state = ((object->state & ~(1 << 6)) | (i << 6))
+#ifdef TRIPLE_BUFFER_ATOMIC
+#define triple_buffer_lock()
+#define triple_buffer_unlock()
+#else
+#define triple_buffer_lock() serial_link_lock()
+#define triple_buffer_unlock() serial_link_unlock()
+#endif
 
 void triple_buffer_init(triple_buffer_object_t* object) {
-    object->state = 0;
-    SET_WRITE_INDEX(0);
-    SET_READ_INDEX(1);
-    SET_SHARED_INDEX(2);
-    SET_DATA_AVAILABLE(0);
+    object->state = MAKE_STATE(1, 0, 2);
 }
 
 void* triple_buffer_read_internal(uint16_t object_size, triple_buffer_object_t* object) {
-    serial_link_lock();
-    if (GET_DATA_AVAILABLE()) {
-        uint8_t shared_index = GET_SHARED_INDEX();
-        uint8_t read_index = GET_READ_INDEX();
-        SET_READ_INDEX(shared_index);
-        SET_SHARED_INDEX(read_index);
-        SET_DATA_AVAILABLE(false);
-        serial_link_unlock();
-        return object->buffer + object_size * shared_index;
-    }
-    else {
-        serial_link_unlock();
-        return NULL;
-    }
+    triple_buffer_lock();
+    uint8_t state = load_state(object);
+    uint8_t new_state;
+    do {
+        if (!(state & DATA_AVAILABLE)) {
+            triple_buffer_unlock();
+            return NULL;
+        }
+        new_state = MAKE_STATE(SHARED_INDEX(state), WRITE_INDEX(state), READ_INDEX(state));
+    } while (!exchange_state(object, &state, new_state));
+    triple_buffer_unlock();
+    return object->buffer + object_size * READ_INDEX(new_state);
 }
 
 void* triple_buffer_begin_write_internal(uint16_t object_size, triple_buffer_object_t* object) {
-    uint8_t write_index = GET_WRITE_INDEX();
+    // only the writer changes the write index
+    uint8_t write_index = WRITE_INDEX(load_state(object));
     return object->buffer + object_size * write_index;
 }
 
 void triple_buffer_end_write_internal(triple_buffer_object_t* object) {
-    serial_link_lock();
-    uint8_t shared_index = GET_SHARED_INDEX();
-    uint8_t write_index = GET_WRITE_INDEX();
-    SET_SHARED_INDEX(write_index);
-    SET_WRITE_INDEX(shared_index);
-    SET_DATA_AVAILABLE(true);
-    serial_link_unlock();
+    triple_buffer_lock();
+    uint8_t state = load_state(object);
+    uint8_t new_state;
+    do {
+        new_state = MAKE_STATE(READ_INDEX(state), SHARED_INDEX(state), WRITE_INDEX(state)) | DATA_AVAILABLE;
+    } while (!exchange_state(object, &state, new_state));
+    triple_buffer_unlock();
 }
@@ -66,16 +66,13 @@ static SerialConfig config = {
 
 //#define DEBUG_LINK_ERRORS
 
+// Big enough for a few matrix frames, which are decoded in place
+#define SERIAL_LINK_READ_BUFFER_SIZE 128
+
 static uint32_t read_from_serial(SerialDriver* driver, uint8_t link) {
-    const uint32_t buffer_size = 16;
-    uint8_t buffer[buffer_size];
-    uint32_t bytes_read = sdAsynchronousRead(driver, buffer, buffer_size);
-    uint8_t* current = buffer;
-    uint8_t* end = current + bytes_read;
-    while(current < end) {
-        byte_stuffer_recv_byte(link, *current);
-        current++;
-    }
+    static uint8_t buffer[SERIAL_LINK_READ_BUFFER_SIZE];
+    uint32_t bytes_read = sdAsynchronousRead(driver, buffer, sizeof(buffer));
+    byte_stuffer_recv(link, buffer, bytes_read);
     return bytes_read;
 }
 
@@ -137,7 +134,8 @@ static THD_FUNCTION(serialThread, arg) {
         eventflags_t flags1 = 0;
         eventflags_t flags2 = 0;
         if (need_wait) {
-            eventmask_t mask = chEvtWaitAnyTimeout(ALL_EVENTS, MS2ST(1000));
+            // Woken up by received data, or an object written by the keyboard
+            eventmask_t mask = chEvtWaitAny(ALL_EVENTS);
             if (mask & EVENT_MASK(1)) {
                 flags1 = chEvtGetAndClearFlags(&sd1_listener);
                 print_error("DOWNLINK", flags1, &SD1);
@@ -187,7 +185,9 @@ static remote_object_t* remote_objects[] = {
 void init_serial_link(void) {
     serial_link_connected = false;
     init_serial_link_hal();
-    add_remote_objects(remote_objects, sizeof(remote_objects)/sizeof(remote_object_t*));
+    if (!add_remote_objects(remote_objects, sizeof(remote_objects)/sizeof(remote_object_t*))) {
+        chSysHalt("serial link objects don't fit in SERIAL_LINK_ARENA_SIZE");
+    }
     init_byte_stuffer();
     sdStart(&SD1, &config);
     sdStart(&SD2, &config);
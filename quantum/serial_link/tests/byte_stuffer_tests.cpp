@@ -26,6 +26,7 @@ SOFTWARE.
 #include "gmock/gmock.h"
 #include <vector>
 #include <algorithm>
+#include <cstdlib>
 extern "C" {
 #include "serial_link/protocol/byte_stuffer.h"
 #include "serial_link/protocol/frame_validator.h"
@@ -51,8 +52,10 @@ public:
 
     void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
         std::copy(data, data + size, std::back_inserter(sent_data));
+        num_sends++;
     }
     std::vector<uint8_t> sent_data;
+    unsigned num_sends = 0;
 
     static ByteStuffer* Instance;
 };
@@ -481,3 +484,116 @@ TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_254_bytes_and_then_zero) {
        byte_stuffer_recv_byte(1, d);
     }
 }
+
+TEST_F(ByteStuffer, sends_a_frame_with_a_single_write) {
+    uint8_t data[] = {1, 0, 0, 2, 0, 0, 0, 3, 0};
+    byte_stuffer_send_frame(0, data, sizeof(data));
+    uint8_t expected[] = {2, 1, 1, 2, 2, 1, 1, 2, 3, 1, 0};
+    EXPECT_THAT(sent_data, ElementsAreArray(expected));
+    EXPECT_EQ(num_sends, 1);
+}
+
+TEST_F(ByteStuffer, does_not_send_frames_bigger_than_the_receiver_can_handle) {
+    std::vector<uint8_t> data(MAX_FRAME_SIZE + 1, 1);
+    byte_stuffer_send_frame(0, data.data(), data.size());
+    EXPECT_EQ(num_sends, 0);
+}
+
+// The straightforward block by block encoding
+static std::vector<uint8_t> reference_encode(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> block;
+    for (auto d : data) {
+        if (block.size() == 254) {
+            encoded.push_back(0xFF);
+            encoded.insert(encoded.end(), block.begin(), block.end());
+            block.clear();
+        }
+        if (d == 0) {
+            encoded.push_back(block.size() + 1);
+            encoded.insert(encoded.end(), block.begin(), block.end());
+            block.clear();
+        } else {
+            block.push_back(d);
+        }
+    }
+    encoded.push_back(block.size() + 1);
+    encoded.insert(encoded.end(), block.begin(), block.end());
+    encoded.push_back(0);
+    return encoded;
+}
+
+TEST_F(ByteStuffer, encodes_random_frames_like_the_reference) {
+    std::srand(1234);
+    for (int i = 0; i < 500; i++) {
+        std::vector<uint8_t> data(1 + std::rand() % MAX_FRAME_SIZE);
+        // Mostly zeros, with runs of non-zero bytes of any length
+        int zeros = std::rand() % 4;
+        for (auto& d : data) {
+            d = std::rand() % 4 < zeros ? 0 : 1 + std::rand() % 255;
+        }
+        sent_data.clear();
+        byte_stuffer_send_frame(0, data.data(), data.size());
+        ASSERT_EQ(sent_data, reference_encode(data));
+        ASSERT_LE(sent_data.size(), BYTE_STUFFER_ENCODED_SIZE(data.size()));
+        EXPECT_CALL(*this, validator_recv_frame(_, _, _))
+            .With(Args<1, 2>(ElementsAreArray(data)));
+        for (auto& d : sent_data) {
+            byte_stuffer_recv_byte(1, d);
+        }
+        testing::Mock::VerifyAndClearExpectations(this);
+    }
+}
+
+TEST_F(ByteStuffer, receives_in_bulk_like_byte_by_byte) {
+    std::srand(5678);
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 300; i++) {
+        int kind = std::rand() % 10;
+        std::vector<uint8_t> data;
+        if (kind < 7) {
+            // A valid frame
+            data.resize(1 + std::rand() % 600);
+            for (auto& d : data) {
+                d = std::rand() % 3 ? 0 : std::rand();
+            }
+        } else if (kind < 9) {
+            // Noise
+            data.resize(1 + std::rand() % 20);
+            for (auto& d : data) {
+                d = std::rand();
+            }
+            stream.insert(stream.end(), data.begin(), data.end());
+            continue;
+        } else {
+            // Too big to receive
+            data.resize(MAX_FRAME_SIZE + std::rand() % 3, 0x55);
+        }
+        std::vector<uint8_t> encoded(BYTE_STUFFER_ENCODED_SIZE(data.size()));
+        encoded.resize(byte_stuffer_encode(data.data(), data.size(), encoded.data()));
+        stream.insert(stream.end(), encoded.begin(), encoded.end());
+    }
+
+    std::vector<std::vector<uint8_t>> byte_frames;
+    std::vector<std::vector<uint8_t>> bulk_frames;
+    std::vector<std::vector<uint8_t>>* frames = &byte_frames;
+    EXPECT_CALL(*this, validator_recv_frame(_, _, _))
+        .WillRepeatedly(testing::Invoke([&frames](uint8_t link, uint8_t* data, uint16_t size) {
+            frames->emplace_back(data, data + size);
+        }));
+    for (auto d : stream) {
+        byte_stuffer_recv_byte(0, d);
+    }
+    frames = &bulk_frames;
+    std::vector<uint8_t> copy = stream;
+    uint8_t* data = copy.data();
+    uint32_t left = copy.size();
+    while (left > 0) {
+        uint16_t size = std::min<uint32_t>(left, 1 + std::rand() % 200);
+        byte_stuffer_recv(1, data, size);
+        data += size;
+        left -= size;
+    }
+    EXPECT_GT(byte_frames.size(), 150);
+    EXPECT_EQ(bulk_frames, byte_frames);
+}
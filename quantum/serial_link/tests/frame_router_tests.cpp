@@ -25,6 +25,7 @@ SOFTWARE.
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <array>
+#include <cstring>
 extern "C" {
     #include "serial_link/protocol/transport.h"
     #include "serial_link/protocol/byte_stuffer.h"
@@ -60,6 +61,18 @@ public:
         }
     }
 
+    // Receives the data in buffers of a serial read, like serial_link.c
+    void receive_data_in_bulk(uint8_t link, const uint8_t* data, uint32_t size) {
+        uint8_t buffer[128];
+        while (size > 0) {
+            uint16_t n = size < sizeof(buffer) ? size : sizeof(buffer);
+            memcpy(buffer, data, n);
+            byte_stuffer_recv(link, buffer, n);
+            data += n;
+            size -= n;
+        }
+    }
+
     void activate_router(uint8_t num) {
         current_router_buffer = router_buffers + num;
         router_set_master(num==0);
@@ -102,6 +115,9 @@ typedef struct {
 } frame_buffer_t;
 
 
+// Set by the stress test, which doesn't need the mock
+static unsigned* frames_received = nullptr;
+
 extern "C" {
     void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
         FrameRouter::Instance->send_data(link, data, size);
@@ -109,6 +125,10 @@ extern "C" {
 
 
     void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size) {
+        if (frames_received) {
+            (*frames_received)++;
+            return;
+        }
         FrameRouter::Instance->transport_recv_frame(from, data, size);
     }
 }
@@ -227,3 +247,50 @@ TEST_F(FrameRouter, master_receives_on_uplink_does_nothing) {
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
 }
+
+TEST_F(FrameRouter, bulk_receive_delivers_the_same_frames) {
+    frame_buffer_t data;
+    data.data = {0xAB, 0x00, 0x00, 0xBB};
+    activate_router(1);
+    router_send_frame(0, (uint8_t*)&data, 4);
+    data.data = {0x00, 0x01, 0x02, 0x00};
+    router_send_frame(0, (uint8_t*)&data, 4);
+    auto stream = router_buffers[1].send_buffers[UP_LINK];
+    activate_router(0);
+    EXPECT_CALL(*this, transport_recv_frame(1, _, _))
+        .With(Args<1, 2>(ElementsAreArray({0xAB, 0x00, 0x00, 0xBB})));
+    EXPECT_CALL(*this, transport_recv_frame(1, _, _))
+        .With(Args<1, 2>(ElementsAreArray(data.data)))
+        .RetiresOnSaturation();
+    // Split in the middle of the second frame
+    byte_stuffer_recv(DOWN_LINK, stream.data(), stream.size() - 3);
+    byte_stuffer_recv(DOWN_LINK, stream.data() + stream.size() - 3, 3);
+}
+
+TEST_F(FrameRouter, receives_a_long_stream_in_bulk_and_byte_by_byte) {
+    // A slave sends matrix frames to the master
+    const unsigned num_frames = 1000;
+    activate_router(1);
+    for (unsigned i = 0; i < num_frames; i++) {
+        struct {
+            uint8_t rows[32];
+            uint8_t extra[16];
+        } matrix = {};
+        matrix.rows[i % 32] = 1 << (i % 8);
+        matrix.rows[(i * 7) % 32] |= 0x80;
+        router_send_frame(0, matrix.rows, sizeof(matrix.rows));
+    }
+    const std::vector<uint8_t> stream = router_buffers[1].send_buffers[UP_LINK];
+    activate_router(0);
+
+    unsigned received = 0;
+    frames_received = &received;
+    receive_data_in_bulk(DOWN_LINK, stream.data(), stream.size());
+    EXPECT_EQ(received, num_frames);
+
+    received = 0;
+    std::vector<uint8_t> copy = stream;
+    receive_data(DOWN_LINK, copy.data(), copy.size());
+    frames_received = nullptr;
+    EXPECT_EQ(received, num_frames);
+}
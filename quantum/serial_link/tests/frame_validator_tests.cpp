@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <cstdlib>
+#include <vector>
 extern "C" {
 #include "serial_link/protocol/frame_validator.h"
 }
@@ -60,6 +62,7 @@ void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
 }
 }
 
+#ifndef SERIAL_LINK_CRC16
 TEST_F(FrameValidator, doesnt_validate_frames_under_5_bytes) {
     EXPECT_CALL(*this, route_incoming_frame(_, _, _))
         .Times(0);
@@ -113,3 +116,101 @@ TEST_F(FrameValidator, sends_five_bytes_with_correct_crc) {
         .With(Args<1, 2>(ElementsAreArray(expected)));
     validator_send_frame(0, original, 5);
 }
+#else
+TEST_F(FrameValidator, doesnt_validate_frames_under_3_bytes) {
+    EXPECT_CALL(*this, route_incoming_frame(_, _, _))
+        .Times(0);
+    uint8_t data[] = {1, 2};
+    validator_recv_frame(0, 0, 1);
+    validator_recv_frame(0, data, 2);
+}
+
+TEST_F(FrameValidator, validates_one_byte_frame_with_correct_crc) {
+    uint8_t data[] = {0x44, 0x58, 0xF4};
+    EXPECT_CALL(*this, route_incoming_frame(_, _, _))
+        .With(Args<1, 2>(ElementsAreArray(data, 1)));
+    validator_recv_frame(0, data, 3);
+}
+
+TEST_F(FrameValidator, does_not_validate_one_byte_frame_with_incorrect_crc) {
+    uint8_t data[] = {0x44, 0, 0};
+    EXPECT_CALL(*this, route_incoming_frame(_, _, _))
+        .Times(0);
+    validator_recv_frame(1, data, 3);
+}
+
+TEST_F(FrameValidator, validates_four_byte_frame_with_correct_crc) {
+    uint8_t data[] = {0x44, 0x10, 0xFF, 0x00, 0xD0, 0xE2};
+    EXPECT_CALL(*this, route_incoming_frame(_, _, _))
+        .With(Args<1, 2>(ElementsAreArray(data, 4)));
+    validator_recv_frame(1, data, 6);
+}
+
+TEST_F(FrameValidator, sends_five_bytes_with_correct_crc) {
+    uint8_t original[] = {1, 2, 3, 4, 5, 0, 0};
+    uint8_t expected[] = {1, 2, 3, 4, 5, 0xEC, 0x22};
+    EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expected)));
+    validator_send_frame(0, original, 5);
+}
+#endif
+
+// Bit by bit, straight from the definition of the reflected CRC
+static uint32_t reference_crc(const uint8_t* data, uint16_t size) {
+#ifdef SERIAL_LINK_CRC16
+    const uint32_t poly = 0x8408;
+    const uint32_t mask = 0xFFFF;
+#else
+    const uint32_t poly = 0xEDB88320;
+    const uint32_t mask = 0xFFFFFFFF;
+#endif
+    uint32_t crc = mask;
+    for (uint16_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = crc & 1 ? (crc >> 1) ^ poly : crc >> 1;
+        }
+    }
+    return ~crc & mask;
+}
+
+TEST_F(FrameValidator, crc_of_the_check_string) {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+#ifdef SERIAL_LINK_CRC16
+    EXPECT_EQ(validator_crc(check, sizeof(check)), 0x906E);
+#else
+    EXPECT_EQ(validator_crc(check, sizeof(check)), 0xCBF43926);
+#endif
+    EXPECT_EQ(validator_crc(check, sizeof(check)), reference_crc(check, sizeof(check)));
+}
+
+TEST_F(FrameValidator, crc_matches_the_reference_for_every_length_and_alignment) {
+    uint8_t data[128];
+    std::srand(4321);
+    for (auto& d : data) {
+        d = std::rand();
+    }
+    for (unsigned offset = 0; offset < 8; offset++) {
+        for (unsigned size = 0; size <= sizeof(data) - offset; size++) {
+            ASSERT_EQ(validator_crc(data + offset, size), reference_crc(data + offset, size))
+                << "offset " << offset << " size " << size;
+        }
+    }
+}
+
+TEST_F(FrameValidator, sent_frames_validate) {
+    std::vector<uint8_t> frame;
+    EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _))
+        .WillOnce(testing::Invoke([&frame](uint8_t link, uint8_t* data, uint16_t size) {
+            frame.assign(data, data + size);
+        }));
+    uint8_t original[33 + VALIDATOR_CRC_SIZE];
+    for (unsigned i = 0; i < sizeof(original); i++) {
+        original[i] = i * 7;
+    }
+    validator_send_frame(0, original, 33);
+    ASSERT_EQ(frame.size(), 33 + VALIDATOR_CRC_SIZE);
+    EXPECT_CALL(*this, route_incoming_frame(_, _, _))
+        .With(Args<1, 2>(ElementsAreArray(original, 33)));
+    validator_recv_frame(0, frame.data(), frame.size());
+}
@@ -6,6 +6,11 @@ serial_link_frame_validator_SRC := \
 	$(SERIAL_PATH)/tests/frame_validator_tests.cpp \
 	$(SERIAL_PATH)/protocol/frame_validator.c 
 
+serial_link_frame_validator_crc16_DEFS := -DSERIAL_LINK_CRC16
+serial_link_frame_validator_crc16_SRC := \
+	$(SERIAL_PATH)/tests/frame_validator_tests.cpp \
+	$(SERIAL_PATH)/protocol/frame_validator.c
+
 serial_link_frame_router_SRC := \
 	$(SERIAL_PATH)/tests/frame_router_tests.cpp \
 	$(SERIAL_PATH)/protocol/byte_stuffer.c \
@@ -16,6 +21,7 @@ serial_link_triple_buffered_object_SRC := \
 	$(SERIAL_PATH)/tests/triple_buffered_object_tests.cpp \
 	$(SERIAL_PATH)/protocol/triple_buffered_object.c 
 
+serial_link_transport_DEFS := -DSERIAL_LINK_NUM_SLAVES=4 -DSERIAL_LINK_ARENA_SIZE=2048
 serial_link_transport_SRC := \
 	$(SERIAL_PATH)/tests/transport_tests.cpp \
 	$(SERIAL_PATH)/protocol/transport.c \
@@ -25,9 +25,13 @@ SOFTWARE.
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <cstdlib>
+#include <cstring>
+
 using testing::_;
 using testing::ElementsAreArray;
 using testing::Args;
+using testing::AnyNumber;
 
 extern "C" {
 #include "serial_link/protocol/transport.h"
@@ -42,21 +46,28 @@ struct test_object2 {
     uint32_t test2;
 };
 
+// Like a keyboard matrix
+struct test_object3 {
+    uint32_t rows[16];
+};
+
 MASTER_TO_ALL_SLAVES_OBJECT(master_to_slave, test_object1);
 MASTER_TO_SINGLE_SLAVE_OBJECT(master_to_single_slave, test_object1);
 SLAVE_TO_MASTER_OBJECT(slave_to_master, test_object1);
+SLAVE_TO_MASTER_OBJECT(matrix, test_object3);
 
 static remote_object_t* test_remote_objects[] = {
     REMOTE_OBJECT(master_to_slave),
     REMOTE_OBJECT(master_to_single_slave),
     REMOTE_OBJECT(slave_to_master),
+    REMOTE_OBJECT(matrix),
 };
 
 class Transport : public testing::Test {
 public:
     Transport() {
         Instance = this;
-        add_remote_objects(test_remote_objects, sizeof(test_remote_objects) / sizeof(remote_object_t*));
+        EXPECT_TRUE(add_remote_objects(test_remote_objects, sizeof(test_remote_objects) / sizeof(remote_object_t*)));
     }
 
     ~Transport() {
@@ -186,3 +197,201 @@ TEST_F(Transport, ignores_object_with_size_too_big) {
     test_object1* obj2 = read_master_to_slave();
     EXPECT_EQ(obj2, nullptr);
 }
+
+TEST_F(Transport, objects_are_laid_out_one_after_another) {
+    EXPECT_EQ(remote_object_master_to_single_slave.buffer,
+        remote_object_master_to_slave.buffer +
+        LOCAL_OBJECT_SIZE(sizeof(test_object1)) + REMOTE_OBJECT_SIZE(sizeof(test_object1)));
+    // Only storage for the configured number of slaves
+    EXPECT_EQ(remote_object_slave_to_master.buffer,
+        remote_object_master_to_single_slave.buffer +
+        NUM_SLAVES * LOCAL_OBJECT_SIZE(sizeof(test_object1)) + REMOTE_OBJECT_SIZE(sizeof(test_object1)));
+}
+
+struct too_big_object {
+    uint8_t data[SERIAL_LINK_ARENA_SIZE];
+};
+
+SLAVE_TO_MASTER_OBJECT(too_big, too_big_object);
+
+TEST_F(Transport, objects_that_dont_fit_are_not_added) {
+    remote_object_t* objects[] = {
+        REMOTE_OBJECT(too_big),
+    };
+    EXPECT_FALSE(add_remote_objects(objects, 1));
+}
+
+TEST_F(Transport, ignores_frames_from_slaves_that_dont_exist) {
+    test_object1* obj = begin_write_slave_to_master();
+    obj->test = 7;
+    EXPECT_CALL(*this, signal_data_written());
+    end_write_slave_to_master();
+    EXPECT_CALL(*this, router_send_frame(0));
+    update_transport();
+    transport_recv_frame(NUM_SLAVES + 1, sent_data.data(), sent_data.size());
+    for (int i = 0; i < NUM_SLAVES; i++) {
+        EXPECT_EQ(read_slave_to_master(i), nullptr);
+    }
+}
+
+TEST_F(Transport, only_written_objects_are_sent) {
+    test_object1* obj = begin_write_master_to_slave();
+    obj->test = 1;
+    EXPECT_CALL(*this, signal_data_written());
+    end_write_master_to_slave();
+    EXPECT_CALL(*this, router_send_frame(0xFF)).Times(1);
+    update_transport();
+    EXPECT_CALL(*this, router_send_frame(_)).Times(0);
+    update_transport();
+}
+
+class DeltaTransport : public Transport {
+public:
+    DeltaTransport() {
+        EXPECT_CALL(*this, signal_data_written()).Times(AnyNumber());
+        EXPECT_CALL(*this, router_send_frame(_)).Times(AnyNumber());
+        memset(&matrix, 0, sizeof(matrix));
+        update_transport();
+    }
+
+    // Writes the matrix and returns the frame it's sent as
+    std::vector<uint8_t> send_matrix() {
+        test_object3* obj = begin_write_matrix();
+        *obj = matrix;
+        end_write_matrix();
+        sent_data.clear();
+        update_transport();
+        return sent_data;
+    }
+
+    // Returns true if the receiver updated the matrix
+    bool receive_matrix(std::vector<uint8_t> frame) {
+        transport_recv_frame(1, frame.data(), frame.size());
+        test_object3* obj = read_matrix(0);
+        if (obj) {
+            received = *obj;
+        }
+        return obj != nullptr;
+    }
+
+    bool in_sync() {
+        return memcmp(&received, &matrix, sizeof(matrix)) == 0;
+    }
+
+    test_object3 matrix;
+    test_object3 received;
+};
+
+// sequence and id
+static const unsigned frame_overhead = 2;
+// one bit for each of the 16 chunks
+static const unsigned mask_size = 2;
+
+TEST_F(DeltaTransport, the_first_frame_is_a_keyframe) {
+    matrix.rows[3] = 0x10;
+    auto frame = send_matrix();
+    EXPECT_EQ(frame.size(), sizeof(test_object3) + frame_overhead);
+    EXPECT_TRUE(receive_matrix(frame));
+    EXPECT_TRUE(in_sync());
+}
+
+TEST_F(DeltaTransport, only_the_changed_chunks_are_sent) {
+    EXPECT_TRUE(receive_matrix(send_matrix()));
+    matrix.rows[5] = 0x1234;
+    auto frame = send_matrix();
+    EXPECT_EQ(frame.size(), sizeof(uint32_t) + mask_size + frame_overhead);
+    EXPECT_TRUE(receive_matrix(frame));
+    EXPECT_TRUE(in_sync());
+    matrix.rows[0] = 1;
+    matrix.rows[15] = 2;
+    frame = send_matrix();
+    EXPECT_EQ(frame.size(), 2 * sizeof(uint32_t) + mask_size + frame_overhead);
+    EXPECT_TRUE(receive_matrix(frame));
+    EXPECT_TRUE(in_sync());
+}
+
+TEST_F(DeltaTransport, an_unchanged_object_is_still_sent) {
+    EXPECT_TRUE(receive_matrix(send_matrix()));
+    auto frame = send_matrix();
+    EXPECT_EQ(frame.size(), mask_size + frame_overhead);
+    EXPECT_TRUE(receive_matrix(frame));
+    EXPECT_TRUE(in_sync());
+}
+
+TEST_F(DeltaTransport, a_keyframe_is_sent_when_most_of_the_object_changes) {
+    EXPECT_TRUE(receive_matrix(send_matrix()));
+    for (int i = 0; i < 16; i++) {
+        matrix.rows[i] = i + 1;
+    }
+    auto frame = send_matrix();
+    EXPECT_EQ(frame.size(), sizeof(test_object3) + frame_overhead);
+    EXPECT_TRUE(receive_matrix(frame));
+    EXPECT_TRUE(in_sync());
+}
+
+TEST_F(DeltaTransport, keyframes_are_sent_periodically) {
+    for (int i = 0; i < 3 * SERIAL_LINK_KEYFRAME_INTERVAL; i++) {
+        auto frame = send_matrix();
+        if (i % SERIAL_LINK_KEYFRAME_INTERVAL == 0) {
+            EXPECT_EQ(frame.size(), sizeof(test_object3) + frame_overhead) << "frame " << i;
+        } else {
+            EXPECT_EQ(frame.size(), mask_size + frame_overhead) << "frame " << i;
+        }
+    }
+}
+
+TEST_F(DeltaTransport, a_lost_frame_is_recovered_at_the_next_keyframe) {
+    EXPECT_TRUE(receive_matrix(send_matrix()));
+    matrix.rows[1] = 1;
+    // lost
+    send_matrix();
+    matrix.rows[2] = 2;
+    for (int i = 2; i < SERIAL_LINK_KEYFRAME_INTERVAL; i++) {
+        EXPECT_FALSE(receive_matrix(send_matrix())) << "frame " << i;
+    }
+    EXPECT_TRUE(receive_matrix(send_matrix()));
+    EXPECT_TRUE(in_sync());
+}
+
+TEST_F(DeltaTransport, a_receiver_that_missed_the_keyframe_waits_for_the_next_one) {
+    matrix.rows[7] = 7;
+    send_matrix();
+    for (int i = 1; i < SERIAL_LINK_KEYFRAME_INTERVAL; i++) {
+        EXPECT_FALSE(receive_matrix(send_matrix()));
+    }
+    EXPECT_TRUE(receive_matrix(send_matrix()));
+    EXPECT_TRUE(in_sync());
+}
+
+TEST_F(DeltaTransport, a_delta_is_not_applied_twice) {
+    EXPECT_TRUE(receive_matrix(send_matrix()));
+    matrix.rows[1] = 1;
+    auto frame = send_matrix();
+    EXPECT_TRUE(receive_matrix(frame));
+    EXPECT_FALSE(receive_matrix(frame));
+}
+
+TEST_F(DeltaTransport, never_shows_a_wrong_object_on_a_lossy_link) {
+    std::srand(99);
+    unsigned bytes = 0;
+    unsigned updates = 0;
+    const unsigned num_frames = 5000;
+    for (unsigned i = 0; i < num_frames; i++) {
+        // A key changes now and then
+        if (std::rand() % 4 == 0) {
+            matrix.rows[std::rand() % 16] ^= 1 << (std::rand() % 32);
+        }
+        auto frame = send_matrix();
+        bytes += frame.size();
+        // One frame in fifty is lost
+        if (std::rand() % 50 != 0) {
+            if (receive_matrix(frame)) {
+                ASSERT_TRUE(in_sync()) << "frame " << i;
+                updates++;
+            }
+        }
+    }
+    EXPECT_GT(updates, num_frames * 3 / 4);
+    // The deltas keep the frames well below the size of the object
+    EXPECT_LT(bytes / num_frames, sizeof(test_object3) / 2);
+}
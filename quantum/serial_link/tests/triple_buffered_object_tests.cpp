@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 #include "gtest/gtest.h"
+#include <pthread.h>
+#include <sched.h>
 extern "C" {
 #include "serial_link/protocol/triple_buffered_object.h"
 }
@@ -82,3 +84,67 @@ TEST_F(TripleBufferedObject, performs_two_writes_in_the_middle_of_read) {
     EXPECT_EQ(*triple_buffer_read(&test_object), 3);
     EXPECT_EQ(triple_buffer_read(&test_object), nullptr);
 }
+
+// Large enough that a torn read would mix words from different writes
+struct stress_payload {
+    uint32_t sequence;
+    uint32_t words[31];
+};
+
+struct stress_object {
+    uint8_t state;
+    stress_payload buffer[3] __attribute__((aligned(4)));
+};
+
+static stress_object stress_object;
+static const uint32_t stress_writes = 1000000;
+
+static void* stress_writer(void*) {
+    for (uint32_t i = 1; i <= stress_writes; i++) {
+        stress_payload* payload = triple_buffer_begin_write(&stress_object);
+        payload->sequence = i;
+        for (auto& word : payload->words) {
+            word = i * 2654435761u;
+        }
+        triple_buffer_end_write(&stress_object);
+        // let a reader on the same core in now and then
+        if (i % 64 == 0) {
+            sched_yield();
+        }
+    }
+    return nullptr;
+}
+
+TEST(TripleBufferedObjectStress, reader_never_sees_torn_or_old_objects) {
+    triple_buffer_init((triple_buffer_object_t*)&stress_object);
+    pthread_t writer;
+    ASSERT_EQ(pthread_create(&writer, nullptr, stress_writer, nullptr), 0);
+    uint32_t last = 0;
+    uint32_t reads = 0;
+    uint32_t torn = 0;
+    uint32_t out_of_order = 0;
+    while (last != stress_writes) {
+        stress_payload* payload = triple_buffer_read(&stress_object);
+        if (!payload) {
+            sched_yield();
+            continue;
+        }
+        reads++;
+        const uint32_t sequence = payload->sequence;
+        for (auto& word : payload->words) {
+            if (word != sequence * 2654435761u) {
+                torn++;
+                break;
+            }
+        }
+        if (sequence <= last) {
+            out_of_order++;
+        }
+        last = sequence;
+    }
+    pthread_join(writer, nullptr);
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(out_of_order, 0);
+    EXPECT_GT(reads, 0);
+    EXPECT_EQ(triple_buffer_read(&stress_object), nullptr);
+}
@@ -5,8 +5,10 @@
 #include <util/twi.h>
 #include <stdbool.h>
 #include "i2c.h"
+#include "transport.h"
 
-#ifdef USE_I2C
+// The master functions are also used by OLEDs, even when the halves use the serial
+#if defined(USE_I2C) || defined(SPLIT_PHY_I2C)
 
 // Limits the amount of we wait for any one i2c transaction.
 // Since were running SCL line 100kHz (=> 10μs/bit), and each transactions is
@@ -16,13 +18,6 @@
 // poll loop takes at least 8 clock cycles to execute
 #define I2C_LOOP_TIMEOUT (9+1)*(F_CPU/SCL_CLOCK)/8
 
-#define BUFFER_POS_INC() (slave_buffer_pos = (slave_buffer_pos+1)%SLAVE_BUFFER_SIZE)
-
-volatile uint8_t i2c_slave_buffer[SLAVE_BUFFER_SIZE];
-
-static volatile uint8_t slave_buffer_pos;
-static volatile bool slave_has_register_set = false;
-
 // Wait for an i2c operation to finish
 inline static
 void i2c_delay(void) {
@@ -113,6 +108,57 @@ void i2c_slave_init(uint8_t address) {
   TWCR = (1<<TWIE) | (1<<TWEA) | (1<<TWINT) | (1<<TWEN);
 }
 
+#ifdef SPLIT_PHY_I2C
+
+// The slave collects the request until the master sends a stop, and then
+// prepares the reply, length first, for the master to read.
+static uint8_t slave_request[SPLIT_REQUEST_MAX_SIZE];
+static uint8_t slave_reply[1 + SPLIT_REPLY_MAX_SIZE];
+static volatile uint8_t slave_request_len;
+static volatile uint8_t slave_reply_pos;
+
+// The slave handles the request after the stop, so the first attempt to read
+// the reply might not be acknowledged
+#define I2C_REPLY_RETRIES 3
+
+void split_phy_master_init(void) {
+  i2c_master_init();
+}
+
+void split_phy_slave_init(void) {
+  i2c_slave_init(SLAVE_I2C_ADDRESS);
+}
+
+bool split_phy_master_exchange(const uint8_t* request, uint8_t request_len, uint8_t* reply, uint8_t* reply_len) {
+  if (i2c_master_start(SLAVE_I2C_ADDRESS + I2C_WRITE)) goto i2c_error;
+  for (uint8_t i = 0; i < request_len; i++) {
+    if (i2c_master_write(request[i])) goto i2c_error;
+  }
+  i2c_master_stop();
+
+  uint8_t retries = I2C_REPLY_RETRIES;
+  while (i2c_master_start(SLAVE_I2C_ADDRESS + I2C_READ)) {
+    if (!--retries) goto i2c_error;
+  }
+  uint8_t len = i2c_master_read(I2C_ACK);
+  if (len == 0 || len > *reply_len) {
+    i2c_master_read(I2C_NACK);
+    i2c_master_stop();
+    return false;
+  }
+  for (uint8_t i = 0; i < len - 1; i++) {
+    reply[i] = i2c_master_read(I2C_ACK);
+  }
+  reply[len - 1] = i2c_master_read(I2C_NACK);
+  i2c_master_stop();
+  *reply_len = len;
+  return true;
+
+i2c_error: // the cable is disconnceted, or something else went wrong
+  i2c_reset_state();
+  return false;
+}
+
 ISR(TWI_vect);
 
 ISR(TWI_vect) {
@@ -120,35 +166,33 @@ ISR(TWI_vect) {
   switch(TW_STATUS) {
     case TW_SR_SLA_ACK:
       // this device has been addressed as a slave receiver
-      slave_has_register_set = false;
+      slave_request_len = 0;
       break;
 
     case TW_SR_DATA_ACK:
       // this device has received data as a slave receiver
-      // The first byte that we receive in this transaction sets the location
-      // of the read/write location of the slaves memory that it exposes over
-      // i2c.  After that, bytes will be written at slave_buffer_pos, incrementing
-      // slave_buffer_pos after each write.
-      if(!slave_has_register_set) {
-        slave_buffer_pos = TWDR;
-        // don't acknowledge the master if this memory loctaion is out of bounds
-        if ( slave_buffer_pos >= SLAVE_BUFFER_SIZE ) {
-          ack = 0;
-          slave_buffer_pos = 0;
-        }
-        slave_has_register_set = true;
+      if (slave_request_len < sizeof(slave_request)) {
+        slave_request[slave_request_len++] = TWDR;
       } else {
-        i2c_slave_buffer[slave_buffer_pos] = TWDR;
-        BUFFER_POS_INC();
+        // don't acknowledge the master if the request is too long
+        ack = 0;
       }
       break;
 
+    case TW_SR_STOP:
+      // the whole request has been received
+      slave_reply[0] = split_transport_slave_handle(slave_request, slave_request_len, &slave_reply[1]);
+      slave_reply_pos = 0;
+      break;
+
     case TW_ST_SLA_ACK:
     case TW_ST_DATA_ACK:
       // master has addressed this device as a slave transmitter and is
       // requesting data.
-      TWDR = i2c_slave_buffer[slave_buffer_pos];
-      BUFFER_POS_INC();
+      TWDR = slave_reply[slave_reply_pos];
+      if (slave_reply_pos < sizeof(slave_reply) - 1) {
+        slave_reply_pos++;
+      }
       break;
 
     case TW_BUS_ERROR: // something went wrong, reset twi state
@@ -160,3 +204,4 @@ ISR(TWI_vect) {
   TWCR |= (1<<TWIE) | (1<<TWINT) | (ack<<TWEA) | (1<<TWEN);
 }
 #endif
+#endif
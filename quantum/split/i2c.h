@@ -13,12 +13,14 @@
 #define I2C_ACK 1
 #define I2C_NACK 0
 
-#define SLAVE_BUFFER_SIZE 0x10
+#ifndef SLAVE_I2C_ADDRESS
+#define SLAVE_I2C_ADDRESS 0x32
+#endif
 
 // i2c SCL clock frequency
+#ifndef SCL_CLOCK
 #define SCL_CLOCK  100000L
-
-extern volatile uint8_t i2c_slave_buffer[SLAVE_BUFFER_SIZE];
+#endif
 
 void i2c_master_init(void);
 uint8_t i2c_master_start(uint8_t address);
@@ -0,0 +1,60 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "transport.h"
+#include "loopback.h"
+
+split_loopback_stats_t split_loopback_stats;
+
+static split_loopback_fault_t fault;
+
+void split_loopback_set_fault(split_loopback_fault_t f) {
+    fault = f;
+}
+
+void split_loopback_reset(void) {
+    memset(&split_loopback_stats, 0, sizeof(split_loopback_stats));
+    fault = NULL;
+}
+
+void split_phy_master_init(void) {
+}
+
+void split_phy_slave_init(void) {
+}
+
+bool split_phy_master_exchange(const uint8_t* request, uint8_t request_len, uint8_t* reply, uint8_t* reply_len) {
+    uint8_t wire[SPLIT_REQUEST_MAX_SIZE];
+    uint8_t slave_reply[SPLIT_REPLY_MAX_SIZE];
+
+    split_loopback_stats.transactions++;
+    split_loopback_stats.request_bytes += request_len;
+    memcpy(wire, request, request_len);
+    if (fault && !fault(wire, request_len, true)) {
+        split_loopback_stats.failed++;
+        return false;
+    }
+    uint8_t len = split_transport_slave_handle(wire, request_len, slave_reply);
+    split_loopback_stats.reply_bytes += len;
+    if (len == 0 || len > *reply_len || (fault && !fault(slave_reply, len, false))) {
+        split_loopback_stats.failed++;
+        return false;
+    }
+    memcpy(reply, slave_reply, len);
+    *reply_len = len;
+    return true;
+}
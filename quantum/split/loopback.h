@@ -0,0 +1,46 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPLIT_LOOPBACK_H
+#define SPLIT_LOOPBACK_H
+
+/*
+ * Physical layer for the native build, where both halves run in the same
+ * process and the slave handles each request directly. It counts what went
+ * over the wire, so that the cost of a transaction on the real physical
+ * layers can be estimated, and lets the tests corrupt or drop frames.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t failed;
+    uint32_t request_bytes;
+    uint32_t reply_bytes;
+} split_loopback_stats_t;
+
+extern split_loopback_stats_t split_loopback_stats;
+
+/* called with every frame before it's delivered, to_slave tells the direction,
+ * return false to drop the frame, or modify it to corrupt it */
+typedef bool (*split_loopback_fault_t)(uint8_t* frame, uint8_t len, bool to_slave);
+
+void split_loopback_set_fault(split_loopback_fault_t fault);
+void split_loopback_reset(void);
+
+#endif
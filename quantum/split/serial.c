@@ -0,0 +1,311 @@
+/*
+ * Bit-banged single wire physical layer for the split transport
+ *
+ * See serial_timing.h for the protocol. The master only disables
+ * interrupts while it transfers a single byte, so USB keeps being served
+ * during the transaction.
+ *
+ * WARNING: be careful changing this code, it is very timing dependent
+ */
+
+#ifndef F_CPU
+#define F_CPU 16000000
+#endif
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include <stdbool.h>
+#include "transport.h"
+#include "serial_timing.h"
+
+#ifdef SPLIT_PHY_SERIAL
+
+// SERIAL_PIN_INT is the number of the external interrupt on the pin
+#ifndef SERIAL_PIN_DDR
+#   define SERIAL_PIN_DDR DDRD
+#   define SERIAL_PIN_PORT PORTD
+#   define SERIAL_PIN_INPUT PIND
+#   ifdef USE_SERIAL_PD2
+#       define SERIAL_PIN_MASK _BV(PD2)
+#       define SERIAL_PIN_INT 2
+#       define SERIAL_PIN_INTERRUPT INT2_vect
+#   else
+#       define SERIAL_PIN_MASK _BV(PD0)
+#       define SERIAL_PIN_INT 0
+#       define SERIAL_PIN_INTERRUPT INT0_vect
+#   endif
+#endif
+
+#define SERIAL_BIT_CYCLES (SERIAL_BIT_US * (F_CPU / 1000000))
+// The bit loops spend about this many cycles outside of the delay, which is
+// taken off the delay so that the bit period stays SERIAL_BIT_US
+#define SERIAL_LOOP_CYCLES 8
+// One iteration of serial_wait_for
+#ifndef SERIAL_POLL_CYCLES
+#   define SERIAL_POLL_CYCLES 6
+#endif
+#define SERIAL_POLLS(bits) ((uint16_t)((bits) * SERIAL_BIT_CYCLES / SERIAL_POLL_CYCLES))
+#define SERIAL_SLAVE_POLLS ((uint16_t)(SERIAL_SLAVE_TIMEOUT_US * (F_CPU / 1000000) / SERIAL_POLL_CYCLES))
+// A request the slave doesn't answer lasts the pulse and the start timeout
+#define SERIAL_REPLY_POLLS (SERIAL_REPLY_TIMEOUT_US / ((1 + SERIAL_START_TIMEOUT_BITS + SERIAL_REPLY_POLL_BITS) * SERIAL_BIT_US))
+
+inline static
+void serial_delay(void) {
+  __builtin_avr_delay_cycles(SERIAL_BIT_CYCLES - SERIAL_LOOP_CYCLES);
+}
+
+inline static
+void serial_delay_half(void) {
+  __builtin_avr_delay_cycles(SERIAL_BIT_CYCLES / 2);
+}
+
+inline static
+void serial_output(void) {
+  SERIAL_PIN_DDR |= SERIAL_PIN_MASK;
+}
+
+// make the serial pin an input with pull-up resistor
+inline static
+void serial_input(void) {
+  SERIAL_PIN_DDR  &= ~SERIAL_PIN_MASK;
+  SERIAL_PIN_PORT |= SERIAL_PIN_MASK;
+}
+
+inline static
+uint8_t serial_read_pin(void) {
+  return !!(SERIAL_PIN_INPUT & SERIAL_PIN_MASK);
+}
+
+inline static
+void serial_low(void) {
+  SERIAL_PIN_PORT &= ~SERIAL_PIN_MASK;
+}
+
+inline static
+void serial_high(void) {
+  SERIAL_PIN_PORT |= SERIAL_PIN_MASK;
+}
+
+// Waits for the line to reach the level, returns false on timeout
+inline static
+bool serial_wait_for(uint8_t level, uint16_t polls) {
+  while (serial_read_pin() != level) {
+    if (!polls--) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Drives the line low for a number of bits, and then releases it
+static
+void serial_pulse(uint8_t bits) {
+  serial_output();
+  serial_low();
+  while (bits--) {
+    serial_delay();
+  }
+  serial_high();
+  serial_input();
+}
+
+// Sends a start bit, the byte LSB first and a stop bit
+static
+void serial_write_byte(uint8_t data) {
+  serial_output();
+  serial_low();
+  serial_delay();
+  for (uint8_t i = 0; i < 8; ++i) {
+    if (data & 1) {
+      serial_high();
+    } else {
+      serial_low();
+    }
+    data >>= 1;
+    serial_delay();
+  }
+  serial_high();
+  serial_delay();
+}
+
+// Reads a byte whose start bit has just begun, and returns in the middle of
+// the last bit
+static
+uint8_t serial_sample_byte(void) {
+  uint8_t byte = 0;
+  serial_delay();
+  serial_delay_half();
+  for (uint8_t i = 0;;) {
+    byte = (byte >> 1) | (serial_read_pin() << 7);
+    if (++i == 8) {
+      break;
+    }
+    serial_delay();
+  }
+  return byte;
+}
+
+void split_phy_master_init(void) {
+  serial_output();
+  serial_high();
+}
+
+void split_phy_slave_init(void) {
+  serial_input();
+
+  // Enable the interrupt of the pin
+  EIMSK |= _BV(SERIAL_PIN_INT);
+  // Trigger on the falling edge, ISCn0 and ISCn1 are both 0
+  EICRA &= ~(3 << (SERIAL_PIN_INT * 2));
+}
+
+/*
+ * Slave, which has interrupts disabled for the whole transaction
+ */
+
+static
+bool slave_read_byte(uint8_t* data) {
+  // the last bit of the previous byte might still be low
+  if (!serial_wait_for(1, SERIAL_SLAVE_POLLS) || !serial_wait_for(0, SERIAL_SLAVE_POLLS)) {
+    return false;
+  }
+  *data = serial_sample_byte();
+  return true;
+}
+
+static
+bool slave_write_byte(uint8_t data) {
+  // wait for a whole request pulse, one that started while the slave was
+  // busy has already timed out on the master
+  if (!serial_wait_for(1, SERIAL_SLAVE_POLLS) ||
+      !serial_wait_for(0, SERIAL_SLAVE_POLLS) ||
+      !serial_wait_for(1, SERIAL_SLAVE_POLLS)) {
+    return false;
+  }
+  serial_write_byte(data);
+  serial_input();
+  return true;
+}
+
+// interrupt handle to be used by the slave device
+ISR(SERIAL_PIN_INTERRUPT) {
+  static uint8_t request[SPLIT_REQUEST_MAX_SIZE];
+  static uint8_t reply[SPLIT_REPLY_MAX_SIZE];
+  uint8_t request_len;
+
+  // answer the wake pulse once it ends
+  if (!serial_wait_for(1, SERIAL_SLAVE_POLLS)) {
+    goto end;
+  }
+  serial_pulse(SERIAL_ACK_BITS);
+
+  if (!slave_read_byte(&request_len) || request_len > sizeof(request)) {
+    goto end;
+  }
+  for (uint8_t i = 0; i < request_len; ++i) {
+    if (!slave_read_byte(&request[i])) {
+      goto end;
+    }
+  }
+
+  uint8_t reply_len = split_transport_slave_handle(request, request_len, reply);
+
+  if (!slave_write_byte(reply_len)) {
+    goto end;
+  }
+  for (uint8_t i = 0; i < reply_len; ++i) {
+    if (!slave_write_byte(reply[i])) {
+      goto end;
+    }
+  }
+
+end:
+  serial_input();
+  // the transaction itself has triggered the interrupt again
+  EIFR = _BV(SERIAL_PIN_INT);
+}
+
+/*
+ * Master, every function here runs with interrupts disabled
+ */
+
+static
+bool master_wake(void) {
+  serial_pulse(1);
+  if (!serial_wait_for(0, SERIAL_POLLS(SERIAL_ACK_TIMEOUT_BITS)) ||
+      !serial_wait_for(1, SERIAL_POLLS(SERIAL_ACK_BITS + 1))) {
+    return false;
+  }
+  // let the slave release the line
+  serial_delay();
+  return true;
+}
+
+static
+bool master_read_byte(uint8_t* data) {
+  serial_pulse(1);
+  if (!serial_wait_for(0, SERIAL_POLLS(SERIAL_START_TIMEOUT_BITS))) {
+    return false;
+  }
+  *data = serial_sample_byte();
+  // the slave drives the stop bit until its end, so wait that out and half
+  // a bit more before the next request pulse pulls the line low
+  serial_delay();
+  serial_delay();
+  return true;
+}
+
+// Sends the request to the slave and reads back its reply
+//
+// Returns false if the slave did not respond
+bool split_phy_master_exchange(const uint8_t* request, uint8_t request_len, uint8_t* reply, uint8_t* reply_len) {
+  bool ok;
+
+  cli();
+  ok = master_wake();
+  sei();
+  if (!ok) {
+    goto end;
+  }
+
+  cli();
+  serial_write_byte(request_len);
+  sei();
+  for (uint8_t i = 0; i < request_len; ++i) {
+    cli();
+    serial_write_byte(request[i]);
+    sei();
+  }
+  serial_input();
+
+  // the slave isn't listening until it has prepared the reply
+  uint8_t len;
+  for (uint16_t polls = SERIAL_REPLY_POLLS; ; --polls) {
+    cli();
+    ok = master_read_byte(&len);
+    sei();
+    if (ok || !polls) {
+      break;
+    }
+    _delay_us(SERIAL_REPLY_POLL_BITS * SERIAL_BIT_US);
+  }
+  if (!ok || len == 0 || len > *reply_len) {
+    ok = false;
+    goto end;
+  }
+  for (uint8_t i = 0; i < len && ok; ++i) {
+    cli();
+    ok = master_read_byte(&reply[i]);
+    sei();
+  }
+  *reply_len = len;
+
+end:
+  // always, release the line when not in use
+  serial_output();
+  serial_high();
+  return ok;
+}
+
+#endif
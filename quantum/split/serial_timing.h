@@ -0,0 +1,74 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPLIT_SERIAL_TIMING_H
+#define SPLIT_SERIAL_TIMING_H
+
+/*
+ * Timing of the soft serial in serial.c
+ *
+ * The master only disables interrupts for one step at a time, so the
+ * longest step bounds how late a USB interrupt can be served. The slave
+ * has no USB connection and keeps interrupts disabled for the whole
+ * transaction, which lets it wait for the master between the steps.
+ *
+ * wake:  the master pulls the line low for a bit, and waits for the
+ *        slave to answer with a low pulse of SERIAL_ACK_BITS
+ * write: start bit, 8 data bits LSB first and a stop bit
+ * read:  the master asks for a byte with a low pulse of a bit, and the
+ *        slave answers with a start bit, 8 data bits and a stop bit, if
+ *        it's ready. The master samples the middle of each bit, and waits
+ *        for the end of the stop bit before it asks for the next byte.
+ */
+
+/* bit period in microseconds */
+#ifndef SERIAL_BIT_US
+#define SERIAL_BIT_US 8
+#endif
+
+/* how long the slave holds the line low to answer the wake pulse */
+#define SERIAL_ACK_BITS 2
+/* how long the master waits for the slave to answer, the slave might be
+ * in an interrupt itself */
+#ifndef SERIAL_ACK_TIMEOUT_BITS
+#define SERIAL_ACK_TIMEOUT_BITS 6
+#endif
+/* how long the master waits for the start bit after asking for a byte */
+#define SERIAL_START_TIMEOUT_BITS 2
+/* how long the master keeps asking for the reply while the slave prepares it */
+#ifndef SERIAL_REPLY_TIMEOUT_US
+#define SERIAL_REPLY_TIMEOUT_US 500
+#endif
+/* how long the master serves interrupts between asking for the reply */
+#define SERIAL_REPLY_POLL_BITS 4
+/* how long the slave waits for the master between bytes, the master can be
+ * serving interrupts */
+#ifndef SERIAL_SLAVE_TIMEOUT_US
+#define SERIAL_SLAVE_TIMEOUT_US 2000
+#endif
+
+/* each includes a bit at the end for the slave to release the line, a read
+ * ends half a bit after the stop bit */
+#define SERIAL_WAKE_BITS (1 + SERIAL_ACK_TIMEOUT_BITS + SERIAL_ACK_BITS + 1)
+#define SERIAL_WRITE_BITS (1 + 8 + 1)
+#define SERIAL_READ_BITS (1 + SERIAL_START_TIMEOUT_BITS + 1 + 8 + 1 + 1)
+
+#define SERIAL_MAX(a, b) ((a) > (b) ? (a) : (b))
+/* the longest time the master has interrupts disabled */
+#define SERIAL_MAX_CRITICAL_BITS SERIAL_MAX(SERIAL_WAKE_BITS, SERIAL_MAX(SERIAL_WRITE_BITS, SERIAL_READ_BITS))
+#define SERIAL_MAX_CRITICAL_US (SERIAL_MAX_CRITICAL_BITS * SERIAL_BIT_US)
+
+#endif
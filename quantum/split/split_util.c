@@ -0,0 +1,134 @@
+#include <avr/io.h>
+#include <avr/wdt.h>
+#include <avr/power.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include <avr/eeprom.h>
+#include "split_util.h"
+#include "transport.h"
+#include "matrix.h"
+#include "keyboard.h"
+#include "action_layer.h"
+#include "host.h"
+#include "led.h"
+#include "config.h"
+#include "timer.h"
+
+#ifdef BACKLIGHT_ENABLE
+#  include "backlight.h"
+#endif
+#ifdef RGBLIGHT_ENABLE
+#  include "rgblight.h"
+extern rgblight_config_t rgblight_config;
+#endif
+
+volatile bool isLeftHand = true;
+static bool isMaster = true;
+
+static void setup_handedness(void) {
+  #ifdef EE_HANDS
+    isLeftHand = eeprom_read_byte(EECONFIG_HANDEDNESS);
+  #else
+    // I2C_MASTER_RIGHT is deprecated, use MASTER_RIGHT instead, since this works for both serial and i2c
+    #if defined(I2C_MASTER_RIGHT) || defined(MASTER_RIGHT)
+      isLeftHand = !has_usb();
+    #else
+      isLeftHand = has_usb();
+    #endif
+  #endif
+}
+
+static void keyboard_master_setup(void) {
+    split_transport_master_init();
+#if defined(USE_I2C) && defined(SSD1306OLED)
+    matrix_master_OLED_init ();
+#endif
+}
+
+static void keyboard_slave_setup(void) {
+    timer_init();
+    split_transport_slave_init();
+}
+
+bool has_usb(void) {
+   USBCON |= (1 << OTGPADE); //enables VBUS pad
+   _delay_us(5);
+   return (USBSTA & (1<<VBUS));  //checks state of VBUS
+}
+
+void split_keyboard_setup(void) {
+   setup_handedness();
+
+   isMaster = has_usb();
+   if (isMaster) {
+      keyboard_master_setup();
+   } else {
+      keyboard_slave_setup();
+   }
+   sei();
+}
+
+bool is_keyboard_master(void) {
+   return isMaster;
+}
+
+void keyboard_slave_loop(void) {
+   matrix_init();
+
+   while (1) {
+      matrix_slave_scan();
+#ifdef SPLIT_SLAVE_SCAN_HOOKS
+      // for displays and animations on the slave half
+      matrix_scan_quantum();
+#endif
+   }
+}
+
+// this code runs before the usb and keyboard is initialized
+void matrix_setup(void) {
+    split_keyboard_setup();
+
+    if (!isMaster) {
+        keyboard_slave_loop();
+    }
+}
+
+#if SPLIT_SHARED_STATE
+void split_get_shared_state(split_shared_state_t* state) {
+#if SPLIT_SHARED_LAYER
+    state->layer_state = layer_state;
+#endif
+#if SPLIT_SHARED_LEDS
+    state->leds = host_keyboard_leds();
+#endif
+#if SPLIT_SHARED_BACKLIGHT
+    state->backlight = get_backlight_level();
+#endif
+#if SPLIT_SHARED_RGB
+    state->rgb = rgblight_config.raw;
+#endif
+}
+
+void split_apply_shared_state(uint8_t flags, const split_shared_state_t* state) {
+#if SPLIT_SHARED_LAYER
+    if (flags & SPLIT_STATE_LAYER) {
+        layer_state_set(state->layer_state);
+    }
+#endif
+#if SPLIT_SHARED_LEDS
+    if (flags & SPLIT_STATE_LEDS) {
+        led_set(state->leds);
+    }
+#endif
+#if SPLIT_SHARED_BACKLIGHT
+    if (flags & SPLIT_STATE_BACKLIGHT) {
+        backlight_set(state->backlight);
+    }
+#endif
+#if SPLIT_SHARED_RGB
+    if (flags & SPLIT_STATE_RGB) {
+        rgblight_update_dword(state->rgb);
+    }
+#endif
+}
+#endif
@@ -4,8 +4,6 @@
 #include <stdbool.h>
 #include "eeconfig.h"
 
-#define SLAVE_I2C_ADDRESS           0x32
-
 extern volatile bool isLeftHand;
 
 // slave version of matix scan, defined in matrix.c
@@ -13,6 +11,8 @@ void matrix_slave_scan(void);
 
 void split_keyboard_setup(void);
 bool has_usb(void);
+// whether this half is connected to USB, as found by split_keyboard_setup
+bool is_keyboard_master(void);
 void keyboard_slave_loop(void);
 
 void matrix_master_OLED_init (void);
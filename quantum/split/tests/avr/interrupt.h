@@ -0,0 +1,29 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPLIT_TESTS_AVR_INTERRUPT_H
+#define SPLIT_TESTS_AVR_INTERRUPT_H
+
+/* The slave interrupt becomes a plain function that the simulated slave
+ * calls on a falling edge */
+
+#include "soft_serial_sim.h"
+
+#define ISR(vector) void vector(void)
+#define cli() soft_serial_sim_cli()
+#define sei() soft_serial_sim_sei()
+
+#endif
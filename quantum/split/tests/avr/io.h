@@ -0,0 +1,37 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPLIT_TESTS_AVR_IO_H
+#define SPLIT_TESTS_AVR_IO_H
+
+/* Just enough of avr/io.h for serial.c, on the simulated line */
+
+#include "soft_serial_sim.h"
+
+#define _BV(bit) (1 << (bit))
+
+#define PD0 0
+#define PD2 2
+
+#define DDRD (*soft_serial_sim_register(0))
+#define PORTD (*soft_serial_sim_register(1))
+#define PIND soft_serial_sim_read_pins()
+
+extern uint8_t EIMSK;
+extern uint8_t EICRA;
+extern uint8_t EIFR;
+
+#endif
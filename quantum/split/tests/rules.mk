@@ -0,0 +1,5 @@
+split_soft_serial_DEFS := -DF_CPU=16000000 -DMATRIX_ROWS=8 -DMATRIX_COLS=6 -DSERIAL_POLL_CYCLES=2
+split_soft_serial_INC := $(QUANTUM_PATH)/split/tests
+split_soft_serial_SRC := \
+	$(QUANTUM_PATH)/split/tests/soft_serial_tests.cpp \
+	$(QUANTUM_PATH)/split/serial.c
@@ -0,0 +1,45 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPLIT_TESTS_SOFT_SERIAL_SIM_H
+#define SPLIT_TESTS_SOFT_SERIAL_SIM_H
+
+/*
+ * The simulated line that serial.c runs on in the native tests, see
+ * soft_serial_tests.cpp. The master and the slave each run in their own
+ * thread with their own pin registers, and take turns so that the side
+ * that is behind in time always runs first.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* DDRD and PORTD of the side that is running, each access takes a sbi/cbi */
+uint8_t* soft_serial_sim_register(uint8_t index);
+/* PIND, the level of the line, takes SERIAL_POLL_CYCLES */
+uint8_t soft_serial_sim_read_pins(void);
+void soft_serial_sim_delay(uint32_t cycles);
+void soft_serial_sim_cli(void);
+void soft_serial_sim_sei(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,282 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <avr/io.h>
+#include "split/transport.h"
+#include "split/serial_timing.h"
+
+void INT0_vect(void);
+
+uint8_t EIMSK;
+uint8_t EICRA;
+uint8_t EIFR;
+}
+
+static const uint32_t cycles_per_us = F_CPU / 1000000;
+// sbi and cbi take two cycles
+static const uint32_t register_cycles = 2;
+static const uint8_t pin = 1 << PD0;
+
+// USB start of frame, a full speed host polls the keyboard at most this often
+static const unsigned sof_period_us = 1000;
+
+/*
+ * The line between the halves, driven by serial.c on both sides
+ */
+
+enum { MASTER, SLAVE };
+
+struct Side {
+    uint8_t ddr;
+    uint8_t port;
+    uint64_t time;
+    // the cost of the last register access, added when the side goes on
+    uint32_t pending;
+
+    bool drives(uint8_t level) const {
+        return (ddr & pin) && !!(port & pin) == level;
+    }
+};
+
+static Side sides[2];
+static thread_local int self = MASTER;
+static std::mutex sim_mutex;
+static std::condition_variable sim_turn;
+static int running;
+static bool slave_attached;
+static bool stopping;
+
+static bool contended;
+static uint64_t contended_since;
+static uint64_t contention_cycles;
+
+static uint64_t critical_since;
+static uint64_t worst_critical_cycles;
+
+static uint8_t line_level() {
+    return !(sides[MASTER].drives(0) || sides[SLAVE].drives(0));
+}
+
+// Keeps track of how long the sides drive the line to different levels
+static void observe(uint64_t now) {
+    bool contention = (sides[MASTER].drives(0) && sides[SLAVE].drives(1)) ||
+        (sides[MASTER].drives(1) && sides[SLAVE].drives(0));
+    if (contention && !contended) {
+        contended_since = now;
+    } else if (!contention && contended) {
+        contention_cycles += now - contended_since;
+    }
+    contended = contention;
+}
+
+// Moves the running side on, and lets the other one catch up when it's behind
+static void advance(uint32_t cycles) {
+    Side& side = sides[self];
+    observe(side.time);
+    side.time += side.pending + cycles;
+    side.pending = 0;
+    if (!slave_attached || stopping) {
+        return;
+    }
+    const int other = self == MASTER ? SLAVE : MASTER;
+    if (sides[other].time < side.time) {
+        std::unique_lock<std::mutex> lock(sim_mutex);
+        running = other;
+        sim_turn.notify_all();
+        sim_turn.wait(lock, [] { return running == self || stopping; });
+    }
+}
+
+extern "C" {
+uint8_t* soft_serial_sim_register(uint8_t index) {
+    advance(0);
+    sides[self].pending += register_cycles;
+    return index == 0 ? &sides[self].ddr : &sides[self].port;
+}
+
+uint8_t soft_serial_sim_read_pins(void) {
+    advance(0);
+    sides[self].pending += SERIAL_POLL_CYCLES;
+    return line_level() ? pin : 0;
+}
+
+void soft_serial_sim_delay(uint32_t cycles) {
+    advance(cycles);
+}
+
+void soft_serial_sim_cli(void) {
+    advance(0);
+    critical_since = sides[self].time;
+}
+
+void soft_serial_sim_sei(void) {
+    advance(0);
+    worst_critical_cycles = std::max(worst_critical_cycles, sides[self].time - critical_since);
+}
+}
+
+/*
+ * The transport on the slave, which replies with whatever the test set up
+ */
+
+static std::vector<uint8_t> received_request;
+static std::vector<uint8_t> next_reply;
+static uint32_t slave_prepare_us;
+
+extern "C" uint8_t split_transport_slave_handle(const uint8_t* request, uint8_t request_len, uint8_t* reply) {
+    received_request.assign(request, request + request_len);
+    soft_serial_sim_delay(slave_prepare_us * cycles_per_us);
+    std::copy(next_reply.begin(), next_reply.end(), reply);
+    return next_reply.size();
+}
+
+// The slave waits for falling edges in its main loop, and handles them with
+// the interrupt of serial.c
+static void slave_main() {
+    self = SLAVE;
+    {
+        std::unique_lock<std::mutex> lock(sim_mutex);
+        sim_turn.wait(lock, [] { return running == SLAVE || stopping; });
+    }
+    split_phy_slave_init();
+    uint8_t previous = 1;
+    while (!stopping) {
+        uint8_t level = soft_serial_sim_read_pins();
+        if (previous && !level) {
+            INT0_vect();
+            level = soft_serial_sim_read_pins();
+        }
+        previous = level;
+    }
+}
+
+// The previous soft serial disabled interrupts for the whole transaction,
+// sending each byte as 8 bits of 24us followed by a sync pulse. It sent every
+// row with a checksum one way, and an acknowledgement with a checksum back.
+static unsigned old_soft_serial_us() {
+    const unsigned bytes = ROWS_PER_HAND * sizeof(matrix_row_t) + 1 + 2;
+    return (bytes * 9 + 1) * 24;
+}
+
+// On the slave split_transport_slave_handle takes a few tens of microseconds
+static const unsigned typical_slave_prepare_us = 40;
+
+class SoftSerial : public testing::Test {
+public:
+    SoftSerial() {
+        sides[MASTER] = Side();
+        sides[SLAVE] = Side();
+        self = MASTER;
+        running = MASTER;
+        stopping = false;
+        contended = false;
+        contention_cycles = 0;
+        worst_critical_cycles = 0;
+        slave_prepare_us = typical_slave_prepare_us;
+        split_phy_master_init();
+        slave_attached = true;
+        slave = std::thread(slave_main);
+    }
+
+    ~SoftSerial() {
+        {
+            std::lock_guard<std::mutex> lock(sim_mutex);
+            stopping = true;
+            sim_turn.notify_all();
+        }
+        slave.join();
+        slave_attached = false;
+    }
+
+    // Runs one exchange, and returns how long the master took in microseconds
+    unsigned exchange(const std::vector<uint8_t>& request, bool expect_ok = true) {
+        uint8_t reply[SPLIT_REPLY_MAX_SIZE];
+        uint8_t reply_len = sizeof(reply);
+        received_request.clear();
+        const uint64_t start = sides[MASTER].time;
+        bool ok = split_phy_master_exchange(request.data(), request.size(), reply, &reply_len);
+        const unsigned us = (sides[MASTER].time - start) / cycles_per_us;
+        EXPECT_EQ(ok, expect_ok);
+        if (ok) {
+            EXPECT_EQ(received_request, request);
+            EXPECT_EQ(std::vector<uint8_t>(reply, reply + reply_len), next_reply);
+        }
+        // the keyboard scans in between
+        soft_serial_sim_delay(100 * cycles_per_us);
+        return us;
+    }
+
+    std::vector<uint8_t> random_bytes(size_t len) {
+        std::vector<uint8_t> bytes(len);
+        for (auto& byte : bytes) {
+            byte = rng();
+        }
+        return bytes;
+    }
+
+    std::thread slave;
+    std::mt19937 rng;
+};
+
+TEST_F(SoftSerial, RepliesOfEveryLengthGetThrough) {
+    for (uint8_t len = 1; len <= SPLIT_REPLY_MAX_SIZE; len++) {
+        next_reply = random_bytes(len);
+        exchange(random_bytes(1 + len % SPLIT_REQUEST_MAX_SIZE));
+    }
+}
+
+TEST_F(SoftSerial, TheLineIsOnlyDrivenFromOneSideAtATime) {
+    for (int i = 0; i < 20; i++) {
+        next_reply = random_bytes(SPLIT_REPLY_MAX_SIZE);
+        exchange(random_bytes(SPLIT_REQUEST_MAX_SIZE));
+    }
+    EXPECT_EQ(contention_cycles, 0);
+}
+
+TEST_F(SoftSerial, InterruptsAreDisabledForAtMostOneByte) {
+    // The first transaction sends every row, and the slave is slow
+    slave_prepare_us = SERIAL_REPLY_TIMEOUT_US * 3 / 4;
+    next_reply = random_bytes(SPLIT_REPLY_MAX_SIZE);
+    exchange(random_bytes(SPLIT_REQUEST_MAX_SIZE));
+    EXPECT_LE(worst_critical_cycles, SERIAL_MAX_CRITICAL_US * cycles_per_us);
+    EXPECT_LT(SERIAL_MAX_CRITICAL_US, sof_period_us / 4);
+    EXPECT_GT(old_soft_serial_us(), sof_period_us);
+}
+
+TEST_F(SoftSerial, ATypicalTransactionIsFaster) {
+    // While typing the master only acknowledges, and the slave sends the one
+    // row that changed
+    next_reply = random_bytes(1 + SPLIT_ROW_MASK_SIZE + sizeof(matrix_row_t) + 1);
+    unsigned us = exchange(random_bytes(3));
+    EXPECT_LT(us, old_soft_serial_us());
+}
+
+TEST_F(SoftSerial, ASlowSlaveTimesOut) {
+    slave_prepare_us = SERIAL_REPLY_TIMEOUT_US * 2;
+    next_reply = random_bytes(3);
+    unsigned us = exchange(random_bytes(3), false);
+    EXPECT_LE(us, SERIAL_REPLY_TIMEOUT_US + sof_period_us / 2);
+    EXPECT_LE(worst_critical_cycles, SERIAL_MAX_CRITICAL_US * cycles_per_us);
+}
@@ -0,0 +1,25 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPLIT_TESTS_UTIL_DELAY_H
+#define SPLIT_TESTS_UTIL_DELAY_H
+
+#include "soft_serial_sim.h"
+
+#define __builtin_avr_delay_cycles(cycles) soft_serial_sim_delay(cycles)
+#define _delay_us(us) soft_serial_sim_delay((uint32_t)((us) * (F_CPU / 1000000)))
+
+#endif
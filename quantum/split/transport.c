@@ -0,0 +1,303 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "transport.h"
+
+#ifdef __AVR__
+#   include <util/atomic.h>
+#   include <util/crc16.h>
+#   define SPLIT_ATOMIC ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#else
+#   define SPLIT_ATOMIC
+#endif
+
+static uint8_t crc8(const uint8_t* data, uint8_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+#ifdef __AVR__
+        crc = _crc8_ccitt_update(crc, *data++);
+#else
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+#endif
+    }
+    return crc;
+}
+
+static uint8_t* put_row(uint8_t* p, matrix_row_t row) {
+    for (uint8_t i = 0; i < sizeof(matrix_row_t); i++) {
+        *p++ = row >> (i * 8);
+    }
+    return p;
+}
+
+static const uint8_t* get_row(const uint8_t* p, matrix_row_t* row) {
+    *row = 0;
+    for (uint8_t i = 0; i < sizeof(matrix_row_t); i++) {
+        *row |= (matrix_row_t)*p++ << (i * 8);
+    }
+    return p;
+}
+
+#if SPLIT_SHARED_STATE
+static uint8_t* put_u32(uint8_t* p, uint32_t value) {
+    for (uint8_t i = 0; i < 4; i++) {
+        *p++ = value >> (i * 8);
+    }
+    return p;
+}
+
+static const uint8_t* get_u32(const uint8_t* p, uint32_t* value) {
+    *value = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        *value |= (uint32_t)*p++ << (i * 8);
+    }
+    return p;
+}
+
+static uint8_t state_size(uint8_t flags) {
+    return (flags & SPLIT_STATE_LAYER ? 4 : 0) +
+        (flags & SPLIT_STATE_LEDS ? 1 : 0) +
+        (flags & SPLIT_STATE_BACKLIGHT ? 1 : 0) +
+        (flags & SPLIT_STATE_RGB ? 4 : 0);
+}
+
+static uint8_t* put_state(uint8_t* p, uint8_t flags, const split_shared_state_t* state) {
+    if (flags & SPLIT_STATE_LAYER) {
+        p = put_u32(p, state->layer_state);
+    }
+    if (flags & SPLIT_STATE_LEDS) {
+        *p++ = state->leds;
+    }
+    if (flags & SPLIT_STATE_BACKLIGHT) {
+        *p++ = state->backlight;
+    }
+    if (flags & SPLIT_STATE_RGB) {
+        p = put_u32(p, state->rgb);
+    }
+    return p;
+}
+
+static void get_state(const uint8_t* p, uint8_t flags, split_shared_state_t* state) {
+    if (flags & SPLIT_STATE_LAYER) {
+        p = get_u32(p, &state->layer_state);
+    }
+    if (flags & SPLIT_STATE_LEDS) {
+        state->leds = *p++;
+    }
+    if (flags & SPLIT_STATE_BACKLIGHT) {
+        state->backlight = *p++;
+    }
+    if (flags & SPLIT_STATE_RGB) {
+        get_u32(p, &state->rgb);
+    }
+}
+
+/* the sections of the state that differ, or that the other side doesn't have yet */
+static uint8_t state_changes(uint8_t valid, const split_shared_state_t* old, const split_shared_state_t* new) {
+    uint8_t flags = SPLIT_SHARED_STATE & ~valid;
+    if (old->layer_state != new->layer_state) {
+        flags |= SPLIT_SHARED_STATE & SPLIT_STATE_LAYER;
+    }
+    if (old->leds != new->leds) {
+        flags |= SPLIT_SHARED_STATE & SPLIT_STATE_LEDS;
+    }
+    if (old->backlight != new->backlight) {
+        flags |= SPLIT_SHARED_STATE & SPLIT_STATE_BACKLIGHT;
+    }
+    if (old->rgb != new->rgb) {
+        flags |= SPLIT_SHARED_STATE & SPLIT_STATE_RGB;
+    }
+    return flags;
+}
+#else
+#define state_size(flags) 0
+#endif
+
+/* the top bit of the sequence number marks a reply with every row */
+#define SEQ_FULL 0x80
+#define SEQ_MASK 0x7F
+
+/*
+ * Master
+ */
+
+/* sequence number of the last reply applied, 0 when the master knows nothing */
+static uint8_t master_ack;
+#if SPLIT_SHARED_STATE
+/* the state the slave is known to have */
+static uint8_t confirmed_flags;
+static split_shared_state_t confirmed_state;
+#endif
+
+void split_transport_master_init(void) {
+    split_transport_master_reset();
+    split_phy_master_init();
+}
+
+void split_transport_master_reset(void) {
+    master_ack = 0;
+#if SPLIT_SHARED_STATE
+    confirmed_flags = 0;
+#endif
+}
+
+bool split_transport_master_update(matrix_row_t slave_rows[]) {
+    uint8_t request[SPLIT_REQUEST_MAX_SIZE];
+    uint8_t reply[SPLIT_REPLY_MAX_SIZE];
+    uint8_t* p = request;
+    uint8_t flags = 0;
+    *p++ = master_ack;
+#if SPLIT_SHARED_STATE
+    split_shared_state_t state;
+    memset(&state, 0, sizeof(state));
+    split_get_shared_state(&state);
+    flags = state_changes(confirmed_flags, &confirmed_state, &state);
+    *p++ = flags;
+    p = put_state(p, flags, &state);
+#else
+    *p++ = flags;
+#endif
+    *p = crc8(request, p - request);
+    p++;
+
+    uint8_t reply_len = sizeof(reply);
+    if (!split_phy_master_exchange(request, p - request, reply, &reply_len)) {
+        return false;
+    }
+    if (reply_len < 2 + SPLIT_ROW_MASK_SIZE || crc8(reply, reply_len - 1) != reply[reply_len - 1]) {
+        return false;
+    }
+    const uint8_t* mask = &reply[1];
+    uint8_t num_rows = 0;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        num_rows += (mask[row / 8] >> (row % 8)) & 1;
+    }
+    if (reply_len != 2 + SPLIT_ROW_MASK_SIZE + num_rows * sizeof(matrix_row_t)) {
+        return false;
+    }
+    const uint8_t* data = &reply[1 + SPLIT_ROW_MASK_SIZE];
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        if (mask[row / 8] & (1 << (row % 8))) {
+            data = get_row(data, &slave_rows[row]);
+        }
+    }
+    master_ack = reply[0] & SEQ_MASK;
+
+    /* a valid reply means the slave got the whole request, but if it had to
+     * send everything it might have been reset, and lost the rest of the state */
+#if SPLIT_SHARED_STATE
+    if (reply[0] & SEQ_FULL) {
+        confirmed_flags = 0;
+    }
+    if (flags) {
+        confirmed_flags |= flags;
+        confirmed_state = state;
+    }
+#endif
+    return true;
+}
+
+/*
+ * Slave
+ */
+
+/* the latest scan, written by the main loop */
+static matrix_row_t slave_rows[ROWS_PER_HAND];
+/* the rows the master has acknowledged */
+static matrix_row_t acked_rows[ROWS_PER_HAND];
+static uint8_t acked_seq;
+/* the rows the master will have once it applies the last reply */
+static matrix_row_t pending_rows[ROWS_PER_HAND];
+static uint8_t pending_seq;
+#if SPLIT_SHARED_STATE
+/* state received since the last split_transport_slave_update */
+static uint8_t received_flags;
+static split_shared_state_t received_state;
+#endif
+
+void split_transport_slave_init(void) {
+    memset(slave_rows, 0, sizeof(slave_rows));
+    memset(acked_rows, 0, sizeof(acked_rows));
+    acked_seq = 0;
+    pending_seq = 0;
+#if SPLIT_SHARED_STATE
+    received_flags = 0;
+#endif
+    split_phy_slave_init();
+}
+
+void split_transport_slave_update(const matrix_row_t rows[]) {
+#if SPLIT_SHARED_STATE
+    uint8_t flags;
+    split_shared_state_t state;
+#endif
+    SPLIT_ATOMIC {
+        memcpy(slave_rows, rows, sizeof(slave_rows));
+#if SPLIT_SHARED_STATE
+        flags = received_flags;
+        state = received_state;
+        received_flags = 0;
+#endif
+    }
+#if SPLIT_SHARED_STATE
+    if (flags) {
+        split_apply_shared_state(flags, &state);
+    }
+#endif
+}
+
+uint8_t split_transport_slave_handle(const uint8_t* request, uint8_t request_len, uint8_t* reply) {
+    if (request_len < 3 || crc8(request, request_len - 1) != request[request_len - 1]) {
+        return 0;
+    }
+    uint8_t ack = request[0];
+    uint8_t flags = request[1];
+    if (request_len != 3 + state_size(flags)) {
+        return 0;
+    }
+#if SPLIT_SHARED_STATE
+    get_state(&request[2], flags, &received_state);
+    received_flags |= flags;
+#endif
+
+    if (ack != 0 && ack == pending_seq) {
+        memcpy(acked_rows, pending_rows, sizeof(acked_rows));
+        acked_seq = pending_seq;
+    }
+    /* if the master has neither of the last two replies, it needs everything */
+    bool full = ack == 0 || ack != acked_seq;
+    pending_seq = pending_seq % SEQ_MASK + 1;
+    memcpy(pending_rows, slave_rows, sizeof(pending_rows));
+
+    uint8_t* p = reply;
+    *p++ = pending_seq | (full ? SEQ_FULL : 0);
+    uint8_t* mask = p;
+    memset(mask, 0, SPLIT_ROW_MASK_SIZE);
+    p += SPLIT_ROW_MASK_SIZE;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        if (full || pending_rows[row] != acked_rows[row]) {
+            mask[row / 8] |= 1 << (row % 8);
+            p = put_row(p, pending_rows[row]);
+        }
+    }
+    *p = crc8(reply, p - reply);
+    p++;
+    return p - reply;
+}
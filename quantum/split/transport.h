@@ -0,0 +1,124 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPLIT_TRANSPORT_H
+#define SPLIT_TRANSPORT_H
+
+/*
+ * Transport between the two halves of a split keyboard
+ *
+ * The master, the half connected to USB, asks the slave for its rows once
+ * per scan. Every request acknowledges the last reply the master received,
+ * so the slave knows exactly which rows the master has, and only sends the
+ * rows that differ from that. When the master has lost track, for example
+ * after a reset, it acknowledges 0 and gets every row.
+ *
+ * request: ack, state flags, shared state, crc
+ * reply:   sequence number, row mask, changed rows, crc
+ *
+ * The shared state works the same way in the other direction, a section is
+ * only sent until a reply confirms that the slave has it. The top bit of the
+ * sequence number is set when the slave sent every row, which also tells the
+ * master that the slave might have been reset and needs the state again.
+ *
+ * The frames are moved by a physical layer, the soft serial in serial.c,
+ * the hardware USART in usart.c, I2C in i2c.c, or the loopback simulator
+ * used by the native tests in loopback.c.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+#define ROWS_PER_HAND (MATRIX_ROWS / 2)
+
+/* the physical layer, USE_I2C on its own moves the matrix over I2C, together
+ * with USE_SERIAL it only makes the I2C master available for an OLED */
+#if defined(USE_USART)
+#   define SPLIT_PHY_USART
+#elif defined(USE_MATRIX_I2C) || (defined(USE_I2C) && !defined(USE_SERIAL))
+#   define SPLIT_PHY_I2C
+#else
+#   define SPLIT_PHY_SERIAL
+#endif
+
+/* state of the master that can be shared with the slave */
+#define SPLIT_STATE_LAYER (1 << 0)
+#define SPLIT_STATE_LEDS (1 << 1)
+#define SPLIT_STATE_BACKLIGHT (1 << 2)
+#define SPLIT_STATE_RGB (1 << 3)
+
+#ifdef SPLIT_SHARE_LAYER_STATE
+#   define SPLIT_SHARED_LAYER SPLIT_STATE_LAYER
+#else
+#   define SPLIT_SHARED_LAYER 0
+#endif
+#ifdef SPLIT_SHARE_LED_STATE
+#   define SPLIT_SHARED_LEDS SPLIT_STATE_LEDS
+#else
+#   define SPLIT_SHARED_LEDS 0
+#endif
+#ifdef BACKLIGHT_ENABLE
+#   define SPLIT_SHARED_BACKLIGHT SPLIT_STATE_BACKLIGHT
+#else
+#   define SPLIT_SHARED_BACKLIGHT 0
+#endif
+#if defined(RGBLIGHT_ENABLE) && defined(SPLIT_SHARE_RGB_STATE)
+#   define SPLIT_SHARED_RGB SPLIT_STATE_RGB
+#else
+#   define SPLIT_SHARED_RGB 0
+#endif
+
+#define SPLIT_SHARED_STATE (SPLIT_SHARED_LAYER | SPLIT_SHARED_LEDS | SPLIT_SHARED_BACKLIGHT | SPLIT_SHARED_RGB)
+
+typedef struct {
+    uint32_t layer_state;
+    uint8_t leds;
+    uint8_t backlight;
+    uint32_t rgb;
+} split_shared_state_t;
+
+#define SPLIT_STATE_MAX_SIZE 10
+#define SPLIT_ROW_MASK_SIZE ((ROWS_PER_HAND + 7) / 8)
+#define SPLIT_REQUEST_MAX_SIZE (2 + SPLIT_STATE_MAX_SIZE + 1)
+#define SPLIT_REPLY_MAX_SIZE (1 + SPLIT_ROW_MASK_SIZE + ROWS_PER_HAND * sizeof(matrix_row_t) + 1)
+
+/* master side, returns false if the slave didn't answer or the reply was corrupt,
+ * in which case slave_rows are left as they were */
+void split_transport_master_init(void);
+bool split_transport_master_update(matrix_row_t slave_rows[]);
+/* forget what the slave has, so that it sends every row and gets all the state again */
+void split_transport_master_reset(void);
+
+/* slave side, rows are the ROWS_PER_HAND rows of this half, to be called after every scan */
+void split_transport_slave_init(void);
+void split_transport_slave_update(const matrix_row_t rows[]);
+
+/* called by the physical layer of the slave for each request, possibly from an
+ * interrupt, returns the length of the reply, or 0 if the request was corrupt */
+uint8_t split_transport_slave_handle(const uint8_t* request, uint8_t request_len, uint8_t* reply);
+
+/* implemented by the physical layer, reply_len is the size of the reply
+ * buffer on entry, and the length of the reply on return */
+void split_phy_master_init(void);
+void split_phy_slave_init(void);
+bool split_phy_master_exchange(const uint8_t* request, uint8_t request_len, uint8_t* reply, uint8_t* reply_len);
+
+/* reads the state of the master and applies it on the slave, see split_util.c */
+void split_get_shared_state(split_shared_state_t* state);
+void split_apply_shared_state(uint8_t flags, const split_shared_state_t* state);
+
+#endif
@@ -0,0 +1,195 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Hardware USART physical layer for the split transport
+ *
+ * Uses USART1, TX on D3 and RX on D2. In full duplex mode TX of each half is
+ * wired to RX of the other. With SPLIT_USART_HALF_DUPLEX a single wire
+ * connects both halves, with D2 and D3 tied together on each side, and the
+ * transmitter is only enabled while sending.
+ *
+ * The frames use 9 bit characters, and the ninth bit marks the length byte
+ * that starts each frame, so that the slave can always find the start of
+ * the next request after a corrupt one. The slave receives and answers from
+ * interrupts, the master polls.
+ */
+
+#ifndef F_CPU
+#define F_CPU 16000000
+#endif
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include <stdbool.h>
+#include "transport.h"
+
+#ifdef SPLIT_PHY_USART
+
+#ifndef SPLIT_USART_BAUD
+#define SPLIT_USART_BAUD 500000
+#endif
+
+// How long the master waits for each byte of the reply, in microseconds
+#ifndef SPLIT_USART_TIMEOUT
+#define SPLIT_USART_TIMEOUT 1000
+#endif
+
+#define SPLIT_USART_UBRR ((F_CPU / 8 / SPLIT_USART_BAUD) - 1)
+
+static uint8_t tx_buffer[1 + SPLIT_REPLY_MAX_SIZE];
+static volatile uint8_t tx_pos;
+static volatile uint8_t tx_len;
+
+static void usart_init(void) {
+#ifdef SPLIT_USART_HALF_DUPLEX
+    // pull the line high while nobody is transmitting
+    DDRD &= ~(_BV(PD2) | _BV(PD3));
+    PORTD |= _BV(PD2) | _BV(PD3);
+#endif
+    UBRR1 = SPLIT_USART_UBRR;
+    UCSR1A = _BV(U2X1);
+    UCSR1C = _BV(UCSZ11) | _BV(UCSZ10);
+#ifdef SPLIT_USART_HALF_DUPLEX
+    UCSR1B = _BV(UCSZ12) | _BV(RXEN1);
+#else
+    UCSR1B = _BV(UCSZ12) | _BV(RXEN1) | _BV(TXEN1);
+#endif
+}
+
+// In half duplex mode the receiver would hear our own bytes
+inline static
+void usart_transmit_begin(void) {
+#ifdef SPLIT_USART_HALF_DUPLEX
+    UCSR1B = (UCSR1B & ~_BV(RXEN1)) | _BV(TXEN1);
+#endif
+}
+
+inline static
+void usart_transmit_end(void) {
+#ifdef SPLIT_USART_HALF_DUPLEX
+    UCSR1B = (UCSR1B & ~_BV(TXEN1)) | _BV(RXEN1);
+#endif
+}
+
+inline static
+void usart_set_frame_start(bool start) {
+    if (start) {
+        UCSR1B |= _BV(TXB81);
+    } else {
+        UCSR1B &= ~_BV(TXB81);
+    }
+}
+
+void split_phy_master_init(void) {
+    usart_init();
+}
+
+void split_phy_slave_init(void) {
+    usart_init();
+    UCSR1B |= _BV(RXCIE1);
+}
+
+static void master_send(uint8_t data, bool start) {
+    while (!(UCSR1A & _BV(UDRE1)));
+    usart_set_frame_start(start);
+    UDR1 = data;
+}
+
+static bool master_receive(uint8_t* data) {
+    for (uint16_t timeout = SPLIT_USART_TIMEOUT; !(UCSR1A & _BV(RXC1)); --timeout) {
+        if (!timeout) {
+            return false;
+        }
+        _delay_us(1);
+    }
+    bool error = UCSR1A & (_BV(FE1) | _BV(DOR1) | _BV(UPE1));
+    *data = UDR1;
+    return !error;
+}
+
+bool split_phy_master_exchange(const uint8_t* request, uint8_t request_len, uint8_t* reply, uint8_t* reply_len) {
+    // drop anything left over from an earlier failed transaction
+    while (UCSR1A & _BV(RXC1)) {
+        (void)UDR1;
+    }
+
+    usart_transmit_begin();
+    UCSR1A |= _BV(TXC1);
+    master_send(request_len, true);
+    for (uint8_t i = 0; i < request_len; i++) {
+        master_send(request[i], false);
+    }
+    while (!(UCSR1A & _BV(TXC1)));
+    usart_transmit_end();
+
+    uint8_t len;
+    if (!master_receive(&len) || len == 0 || len > *reply_len) {
+        return false;
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        if (!master_receive(&reply[i])) {
+            return false;
+        }
+    }
+    *reply_len = len;
+    return true;
+}
+
+ISR(USART1_RX_vect) {
+    static uint8_t request[SPLIT_REQUEST_MAX_SIZE];
+    static uint8_t request_len;
+    static uint8_t pos;
+
+    bool start = UCSR1B & _BV(RXB81);
+    uint8_t data = UDR1;
+    if (start) {
+        request_len = data <= sizeof(request) ? data : 0;
+        pos = 0;
+    } else if (pos < request_len) {
+        request[pos++] = data;
+        if (pos == request_len) {
+            tx_buffer[0] = split_transport_slave_handle(request, request_len, &tx_buffer[1]);
+            tx_len = tx_buffer[0] + 1;
+            tx_pos = 0;
+            request_len = 0;
+            usart_transmit_begin();
+            UCSR1B |= _BV(UDRIE1);
+        }
+    }
+}
+
+ISR(USART1_UDRE_vect) {
+    usart_set_frame_start(tx_pos == 0);
+    UDR1 = tx_buffer[tx_pos++];
+    if (tx_pos == tx_len) {
+        UCSR1B &= ~_BV(UDRIE1);
+#ifdef SPLIT_USART_HALF_DUPLEX
+        UCSR1A |= _BV(TXC1);
+        UCSR1B |= _BV(TXCIE1);
+#endif
+    }
+}
+
+#ifdef SPLIT_USART_HALF_DUPLEX
+ISR(USART1_TX_vect) {
+    UCSR1B &= ~_BV(TXCIE1);
+    usart_transmit_end();
+}
+#endif
+
+#endif
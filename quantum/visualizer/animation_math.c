@@ -0,0 +1,153 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "animation_math.h"
+
+// A quarter of a cosine in Q15, with 64 steps
+static const uint16_t cos_table[65] = {
+    32768, 32758, 32729, 32679, 32610, 32522, 32413, 32286,
+    32138, 31972, 31786, 31581, 31357, 31114, 30853, 30572,
+    30274, 29957, 29622, 29269, 28899, 28511, 28106, 27684,
+    27246, 26791, 26320, 25833, 25330, 24812, 24279, 23732,
+    23170, 22595, 22006, 21403, 20788, 20160, 19520, 18868,
+    18205, 17531, 16846, 16151, 15447, 14733, 14010, 13279,
+    12540, 11793, 11039, 10279, 9512, 8740, 7962, 7180,
+    6393, 5602, 4808, 4011, 3212, 2411, 1608, 804,
+    0,
+};
+
+// The CIE 1931 lightness curve, with 128 steps
+static const uint16_t cie_table[129] = {
+    0, 57, 113, 170, 227, 284, 340, 397,
+    454, 511, 567, 625, 686, 751, 821, 894,
+    972, 1054, 1141, 1232, 1328, 1429, 1535, 1646,
+    1762, 1883, 2010, 2143, 2281, 2425, 2575, 2731,
+    2894, 3062, 3237, 3419, 3607, 3802, 4004, 4213,
+    4429, 4652, 4883, 5121, 5367, 5621, 5882, 6152,
+    6429, 6715, 7009, 7312, 7623, 7943, 8272, 8610,
+    8956, 9312, 9677, 10052, 10436, 10830, 11234, 11647,
+    12071, 12505, 12949, 13403, 13868, 14344, 14830, 15327,
+    15835, 16355, 16885, 17427, 17980, 18545, 19122, 19710,
+    20311, 20923, 21548, 22185, 22834, 23496, 24171, 24858,
+    25558, 26272, 26998, 27738, 28491, 29258, 30038, 30832,
+    31640, 32462, 33298, 34148, 35013, 35892, 36786, 37694,
+    38618, 39556, 40509, 41477, 42461, 43460, 44475, 45506,
+    46552, 47614, 48692, 49787, 50897, 52024, 53168, 54328,
+    55505, 56699, 57909, 59137, 60382, 61645, 62925, 64222,
+    65535,
+};
+
+uint32_t animation_fraction(int32_t position, int32_t length) {
+    if (length <= 0 || position >= length) {
+        return ANIMATION_ONE;
+    }
+    if (position <= 0) {
+        return 0;
+    }
+    return ((uint32_t)position << 16) / (uint32_t)length;
+}
+
+int32_t animation_lerp(int32_t from, int32_t to, uint32_t fraction) {
+    if (to >= from) {
+        return from + (int32_t)(((uint64_t)(to - from) * fraction) >> 16);
+    }
+    else {
+        return from - (int32_t)(((uint64_t)(from - to) * fraction) >> 16);
+    }
+}
+
+// The cosine for angles from 0 to a quarter turn, interpolated between the
+// table entries
+static int32_t quarter_cos(uint16_t angle) {
+    if (angle >= ANIMATION_TURN / 4) {
+        return 0;
+    }
+    uint8_t index = angle >> 8;
+    uint8_t frac = angle & 0xFF;
+    int32_t a = cos_table[index];
+    int32_t b = cos_table[index + 1];
+    return a + (((b - a) * frac) >> 8);
+}
+
+int32_t animation_cos(uint16_t angle) {
+    uint16_t pos = angle & (ANIMATION_TURN / 4 - 1);
+    switch (angle >> 14) {
+    case 0:
+        return quarter_cos(pos);
+    case 1:
+        return -quarter_cos(ANIMATION_TURN / 4 - pos);
+    case 2:
+        return -quarter_cos(pos);
+    default:
+        return quarter_cos(ANIMATION_TURN / 4 - pos);
+    }
+}
+
+uint8_t animation_cos_luma(uint16_t angle) {
+    uint32_t v = animation_cos(angle) + 32768;
+    return (255 * v) >> 16;
+}
+
+// This code is based on Brian Neltner's blogpost and example code
+// "Why every LED light should be using HSI colorspace".
+// http://blog.saikoled.com/post/43693602826/why-every-led-light-should-be-using-hsi
+//
+// The intensity is the product of two 8 bit values, so 65025 is the full intensity
+void animation_hsi_to_rgb(uint8_t hue, uint8_t saturation, uint16_t intensity, uint16_t* r_out, uint16_t* g_out, uint16_t* b_out) {
+    // A hue of 255 is a full turn, just like 360 degrees
+    uint16_t angle = ((uint32_t)hue << 16) / 255;
+    const uint16_t third = ANIMATION_TURN / 3;
+    uint8_t sector = angle <= third ? 0 : (angle <= 2 * third ? 1 : 2);
+    angle -= third * sector;
+
+    // cos(h) / cos(60 - h), between -1 and 2 in Q15, cos(60 - h) is at least a half
+    int32_t ratio = (animation_cos(angle) * 32768) / animation_cos(ANIMATION_TURN / 6 - angle);
+    int32_t s = ((int32_t)saturation << 15) / 255;
+    int32_t s_ratio = (saturation * ratio) / 255;
+    uint32_t base = (65535u * intensity) / (65025u * 3u);
+
+    uint32_t c1 = (base * (uint32_t)(32768 + s_ratio)) >> 15;
+    uint32_t c2 = (base * (uint32_t)(32768 + s - s_ratio)) >> 15;
+    uint32_t c3 = (base * (uint32_t)(32768 - s)) >> 15;
+    c1 = c1 > 65535 ? 65535 : c1;
+    c2 = c2 > 65535 ? 65535 : c2;
+
+    switch (sector) {
+    case 0:
+        *r_out = c1;
+        *g_out = c2;
+        *b_out = c3;
+        break;
+    case 1:
+        *g_out = c1;
+        *b_out = c2;
+        *r_out = c3;
+        break;
+    default:
+        *b_out = c1;
+        *r_out = c2;
+        *g_out = c3;
+        break;
+    }
+}
+
+uint16_t animation_cie_lightness(uint16_t v) {
+    uint8_t index = v >> 9;
+    uint16_t frac = v & 0x1FF;
+    int32_t a = cie_table[index];
+    int32_t b = cie_table[index + 1];
+    return a + (((b - a) * frac) >> 9);
+}
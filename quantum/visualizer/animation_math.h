@@ -0,0 +1,43 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUANTUM_VISUALIZER_ANIMATION_MATH_H_
+#define QUANTUM_VISUALIZER_ANIMATION_MATH_H_
+
+#include <stdint.h>
+
+// Integer math for the keyframes, so that nothing is computed with floats,
+// and there are no divisions for each pixel.
+//
+// Fractions are Q16, ANIMATION_ONE is 1.0. Angles are 16 bit, where
+// ANIMATION_TURN is a full turn, so that they wrap around by themselves.
+#define ANIMATION_ONE 65536
+#define ANIMATION_TURN 65536
+
+// How far position is into length, between 0 and ANIMATION_ONE
+uint32_t animation_fraction(int32_t position, int32_t length);
+// Interpolates from from to to, rounding towards from
+int32_t animation_lerp(int32_t from, int32_t to, uint32_t fraction);
+// The cosine of the angle in Q15, between -32768 and 32768
+int32_t animation_cos(uint16_t angle);
+// (cos(angle) + 1) / 2 as a luma between 0 and 255
+uint8_t animation_cos_luma(uint16_t angle);
+// Converts HSI to 16 bit RGB, see animation_math.c
+void animation_hsi_to_rgb(uint8_t hue, uint8_t saturation, uint16_t intensity, uint16_t* r, uint16_t* g, uint16_t* b);
+// The CIE 1931 lightness curve, for gamma correcting 16 bit PWM values
+uint16_t animation_cie_lightness(uint16_t v);
+
+#endif /* QUANTUM_VISUALIZER_ANIMATION_MATH_H_ */
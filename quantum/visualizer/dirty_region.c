@@ -0,0 +1,64 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dirty_region.h"
+
+bool dirty_region_is_empty(const dirty_region_t* region) {
+    return region->x0 >= region->x1 || region->y0 >= region->y1;
+}
+
+void dirty_region_add(dirty_region_t* region, coord_t x, coord_t y, coord_t cx, coord_t cy) {
+    if (cx <= 0 || cy <= 0) {
+        return;
+    }
+    if (dirty_region_is_empty(region)) {
+        region->x0 = x;
+        region->y0 = y;
+        region->x1 = x + cx;
+        region->y1 = y + cy;
+    }
+    else {
+        region->x0 = x < region->x0 ? x : region->x0;
+        region->y0 = y < region->y0 ? y : region->y0;
+        region->x1 = x + cx > region->x1 ? x + cx : region->x1;
+        region->y1 = y + cy > region->y1 ? y + cy : region->y1;
+    }
+}
+
+uint32_t dirty_region_bytes(const dirty_region_t* region, uint8_t rows_per_byte) {
+    if (dirty_region_is_empty(region)) {
+        return 0;
+    }
+    uint32_t width = region->x1 - region->x0;
+    // a partly covered byte is flushed whole
+    uint32_t pages = (region->y1 + rows_per_byte - 1) / rows_per_byte - region->y0 / rows_per_byte;
+    return width * pages;
+}
+
+void flush_counter_add(flush_counter_t* counter, uint32_t bytes) {
+    counter->bytes += bytes;
+}
+
+bool flush_counter_update(flush_counter_t* counter, systemticks_t now, systemticks_t second) {
+    systemticks_t elapsed = now - counter->since;
+    if (elapsed < second) {
+        return false;
+    }
+    counter->per_second = (uint64_t)counter->bytes * second / elapsed;
+    counter->bytes = 0;
+    counter->since = now;
+    return true;
+}
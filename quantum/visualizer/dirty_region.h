@@ -0,0 +1,52 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUANTUM_VISUALIZER_DIRTY_REGION_H_
+#define QUANTUM_VISUALIZER_DIRTY_REGION_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gfx.h"
+
+// The part of a display that has changed since it was last flushed
+typedef struct {
+    coord_t x0;
+    coord_t y0;
+    coord_t x1;
+    coord_t y1;
+} dirty_region_t;
+
+#define EMPTY_REGION {.x0 = 0, .y0 = 0, .x1 = 0, .y1 = 0}
+
+bool dirty_region_is_empty(const dirty_region_t* region);
+// Grows the region so that it covers the rectangle too
+void dirty_region_add(dirty_region_t* region, coord_t x, coord_t y, coord_t cx, coord_t cy);
+// The display data the region covers, on a display that packs rows_per_byte
+// rows into each byte
+uint32_t dirty_region_bytes(const dirty_region_t* region, uint8_t rows_per_byte);
+
+// Counts the flushed display data over windows of a second
+typedef struct {
+    uint32_t bytes;
+    systemticks_t since;
+    uint32_t per_second;
+} flush_counter_t;
+
+void flush_counter_add(flush_counter_t* counter, uint32_t bytes);
+// Returns true when a window has ended, and per_second has a new value
+bool flush_counter_update(flush_counter_t* counter, systemticks_t now, systemticks_t second);
+
+#endif /* QUANTUM_VISUALIZER_DIRTY_REGION_H_ */
@@ -15,10 +15,12 @@
  */
 
 #include "lcd_backlight_keyframes.h"
+#include "animation_math.h"
 
 bool lcd_backlight_keyframe_animate_color(keyframe_animation_t* animation, visualizer_state_t* state) {
     int frame_length = animation->frame_lengths[animation->current_frame];
     int current_pos = frame_length - animation->time_left_in_frame;
+    uint32_t fraction = animation_fraction(current_pos, frame_length);
     uint8_t t_h = LCD_HUE(state->target_lcd_color);
     uint8_t t_s = LCD_SAT(state->target_lcd_color);
     uint8_t t_i = LCD_INT(state->target_lcd_color);
@@ -33,9 +35,9 @@ bool lcd_backlight_keyframe_animate_color(keyframe_animation_t* animation, visua
     int d_s = t_s - p_s;
     int d_i = t_i - p_i;
 
-    int hue = (d_h * current_pos) / frame_length;
-    int sat = (d_s * current_pos) / frame_length;
-    int intensity = (d_i * current_pos) / frame_length;
+    int hue = animation_lerp(0, d_h, fraction);
+    int sat = animation_lerp(0, d_s, fraction);
+    int intensity = animation_lerp(0, d_i, fraction);
     //dprintf("%X -> %X = %X\n", p_h, t_h, hue);
     hue += p_h;
     sat += p_s;
@@ -46,6 +48,7 @@ bool lcd_backlight_keyframe_animate_color(keyframe_animation_t* animation, visua
             LCD_SAT(state->current_lcd_color),
             LCD_INT(state->current_lcd_color));
 
+    visualizer_mark_nothing_drawn();
     return true;
 }
 
@@ -57,6 +60,7 @@ bool lcd_backlight_keyframe_set_color(keyframe_animation_t* animation, visualize
             LCD_HUE(state->current_lcd_color),
             LCD_SAT(state->current_lcd_color),
             LCD_INT(state->current_lcd_color));
+    visualizer_mark_nothing_drawn();
     return false;
 }
 
@@ -64,6 +68,7 @@ bool lcd_backlight_keyframe_disable(keyframe_animation_t* animation, visualizer_
     (void)animation;
     (void)state;
     lcd_backlight_hal_color(0, 0, 0);
+    visualizer_mark_nothing_drawn();
     return false;
 }
 
@@ -73,5 +78,6 @@ bool lcd_backlight_keyframe_enable(keyframe_animation_t* animation, visualizer_s
     lcd_backlight_color(LCD_HUE(state->current_lcd_color),
         LCD_SAT(state->current_lcd_color),
         LCD_INT(state->current_lcd_color));
+    visualizer_mark_nothing_drawn();
     return false;
 }
@@ -24,6 +24,7 @@ bool lcd_keyframe_display_layer_text(keyframe_animation_t* animation, visualizer
     (void)animation;
     gdispClear(White);
     gdispDrawString(0, 10, state->layer_text, state->font_dejavusansbold12, Black);
+    visualizer_mark_all_dirty(LCD_DISPLAY);
     return false;
 }
 
@@ -62,6 +63,7 @@ bool lcd_keyframe_display_layer_bitmap(keyframe_animation_t* animation, visualiz
     gdispDrawString(0, 10, layer_buffer, state->font_fixed5x8, Black);
     format_layer_bitmap_string(state->status.default_layer >> 16, state->status.layer >> 16, layer_buffer);
     gdispDrawString(0, 20, layer_buffer, state->font_fixed5x8, Black);
+    visualizer_mark_all_dirty(LCD_DISPLAY);
     return false;
 }
 
@@ -100,6 +102,7 @@ bool lcd_keyframe_display_mods_bitmap(keyframe_animation_t* animation, visualize
     format_mods_bitmap_string(state->status.mods, status_buffer);
     gdispDrawString(0, 20, status_buffer, state->font_fixed5x8, Black);
 
+    visualizer_mark_all_dirty(LCD_DISPLAY);
     return false;
 }
 
@@ -138,6 +141,7 @@ bool lcd_keyframe_display_led_states(keyframe_animation_t* animation, visualizer
     get_led_state_string(output, state);
     gdispClear(White);
     gdispDrawString(0, 10, output, state->font_dejavusansbold12, Black);
+    visualizer_mark_all_dirty(LCD_DISPLAY);
     return false;
 }
 
@@ -152,6 +156,7 @@ bool lcd_keyframe_display_layer_and_led_states(keyframe_animation_t* animation,
         y = 17;
     }
     gdispDrawString(0, y, state->layer_text, state->font_dejavusansbold12, Black);
+    visualizer_mark_all_dirty(LCD_DISPLAY);
     return false;
 }
 
@@ -169,6 +174,7 @@ bool lcd_keyframe_draw_logo(keyframe_animation_t* animation, visualizer_state_t*
     // if you have full screen image, then just use LCD_WIDTH and LCD_HEIGHT for both source and target dimensions
     gdispGBlitArea(GDISP, 0, 0, LCD_WIDTH, LCD_HEIGHT, 0, 0, LCD_WIDTH, (pixel_t*)resource_lcd_logo);
 
+    visualizer_mark_all_dirty(LCD_DISPLAY);
     return false;
 }
 
@@ -177,6 +183,7 @@ bool lcd_keyframe_disable(keyframe_animation_t* animation, visualizer_state_t* s
     (void)animation;
     (void)state;
     gdispSetPowerMode(powerOff);
+    visualizer_mark_nothing_drawn();
     return false;
 }
 
@@ -184,5 +191,6 @@ bool lcd_keyframe_enable(keyframe_animation_t* animation, visualizer_state_t* st
     (void)animation;
     (void)state;
     gdispSetPowerMode(powerOn);
+    visualizer_mark_nothing_drawn();
     return false;
 }
@@ -22,22 +22,19 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include "gfx.h"
-#include "math.h"
 #include "led_backlight_keyframes.h"
+#include "animation_math.h"
 
-static uint8_t fade_led_color(keyframe_animation_t* animation, int from, int to) {
+static uint32_t get_frame_fraction(keyframe_animation_t* animation) {
     int frame_length = animation->frame_lengths[animation->current_frame];
-    int current_pos = frame_length - animation->time_left_in_frame;
-    int delta = to - from;
-    int luma = (delta * current_pos) / frame_length;
-    luma += from;
-    return luma;
+    return animation_fraction(frame_length - animation->time_left_in_frame, frame_length);
 }
 
 static void keyframe_fade_all_leds_from_to(keyframe_animation_t* animation, uint8_t from, uint8_t to) {
-    uint8_t luma = fade_led_color(animation, from, to);
+    uint8_t luma = animation_lerp(from, to, get_frame_fraction(animation));
     color_t color = LUMA2COLOR(luma);
     gdispGClear(LED_DISPLAY, color);
+    visualizer_mark_all_dirty(LED_DISPLAY);
 }
 
 // TODO: Should be customizable per keyboard
@@ -47,13 +44,9 @@ static void keyframe_fade_all_leds_from_to(keyframe_animation_t* animation, uint
 static uint8_t crossfade_start_frame[NUM_ROWS][NUM_COLS];
 static uint8_t crossfade_end_frame[NUM_ROWS][NUM_COLS];
 
-static uint8_t compute_gradient_color(float t, float index, float num) {
-    const float two_pi = M_PI * 2.0f;
-    float normalized_index = (1.0f - index / (num - 1.0f)) * two_pi;
-    float x = t * two_pi + normalized_index;
-    float v = 0.5 * (cosf(x) + 1.0f);
-    return (uint8_t)(255.0f * v);
-}
+// The gradient is a cosine that moves a full turn during the frame, with
+// the first and last index a full turn apart
+#define GRADIENT_ANGLE(t, index, num) ((uint16_t)((t) - ((index) * ANIMATION_TURN) / ((num) - 1)))
 
 bool led_backlight_keyframe_fade_in_all(keyframe_animation_t* animation, visualizer_state_t* state) {
     (void)state;
@@ -69,25 +62,23 @@ bool led_backlight_keyframe_fade_out_all(keyframe_animation_t* animation, visual
 
 bool led_backlight_keyframe_left_to_right_gradient(keyframe_animation_t* animation, visualizer_state_t* state) {
     (void)state;
-    float frame_length = animation->frame_lengths[animation->current_frame];
-    float current_pos = frame_length - animation->time_left_in_frame;
-    float t = current_pos / frame_length;
+    uint32_t t = get_frame_fraction(animation);
     for (int i=0; i< NUM_COLS; i++) {
-        uint8_t color = compute_gradient_color(t, i, NUM_COLS);
+        uint8_t color = animation_cos_luma(GRADIENT_ANGLE(t, i, NUM_COLS));
         gdispGDrawLine(LED_DISPLAY, i, 0, i, NUM_ROWS - 1, LUMA2COLOR(color));
     }
+    visualizer_mark_all_dirty(LED_DISPLAY);
     return true;
 }
 
 bool led_backlight_keyframe_top_to_bottom_gradient(keyframe_animation_t* animation, visualizer_state_t* state) {
     (void)state;
-    float frame_length = animation->frame_lengths[animation->current_frame];
-    float current_pos = frame_length - animation->time_left_in_frame;
-    float t = current_pos / frame_length;
+    uint32_t t = get_frame_fraction(animation);
     for (int i=0; i< NUM_ROWS; i++) {
-        uint8_t color = compute_gradient_color(t, i, NUM_ROWS);
+        uint8_t color = animation_cos_luma(GRADIENT_ANGLE(t, i, NUM_ROWS));
         gdispGDrawLine(LED_DISPLAY, 0, i, NUM_COLS - 1, i, LUMA2COLOR(color));
     }
+    visualizer_mark_all_dirty(LED_DISPLAY);
     return true;
 }
 
@@ -105,12 +96,15 @@ bool led_backlight_keyframe_crossfade(keyframe_animation_t* animation, visualize
         run_next_keyframe(animation, state);
         copy_current_led_state(&crossfade_end_frame[0][0]);
     }
+    uint32_t fraction = get_frame_fraction(animation);
     for (int i=0;i<NUM_ROWS;i++) {
         for (int j=0;j<NUM_COLS;j++) {
-            color_t color  = LUMA2COLOR(fade_led_color(animation, crossfade_start_frame[i][j], crossfade_end_frame[i][j]));
+            uint8_t luma = animation_lerp(crossfade_start_frame[i][j], crossfade_end_frame[i][j], fraction);
+            color_t color  = LUMA2COLOR(luma);
             gdispGDrawPixel(LED_DISPLAY, j, i, color);
         }
     }
+    visualizer_mark_all_dirty(LED_DISPLAY);
     return true;
 }
 
@@ -118,6 +112,7 @@ bool led_backlight_keyframe_mirror_orientation(keyframe_animation_t* animation,
     (void)state;
     (void)animation;
     gdispGSetOrientation(LED_DISPLAY, GDISP_ROTATE_180);
+    visualizer_mark_nothing_drawn();
     return false;
 }
 
@@ -125,6 +120,7 @@ bool led_backlight_keyframe_normal_orientation(keyframe_animation_t* animation,
     (void)state;
     (void)animation;
     gdispGSetOrientation(LED_DISPLAY, GDISP_ROTATE_0);
+    visualizer_mark_nothing_drawn();
     return false;
 }
 
@@ -132,6 +128,7 @@ bool led_backlight_keyframe_disable(keyframe_animation_t* animation, visualizer_
     (void)state;
     (void)animation;
     gdispGSetPowerMode(LED_DISPLAY, powerOff);
+    visualizer_mark_nothing_drawn();
     return false;
 }
 
@@ -139,5 +136,6 @@ bool led_backlight_keyframe_enable(keyframe_animation_t* animation, visualizer_s
     (void)state;
     (void)animation;
     gdispGSetPowerMode(LED_DISPLAY, powerOn);
+    visualizer_mark_nothing_drawn();
     return false;
 }
@@ -0,0 +1,91 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "dirty_region.h"
+}
+
+static const systemticks_t second = 1000;
+
+static dirty_region_t region_of(coord_t x, coord_t y, coord_t cx, coord_t cy) {
+    dirty_region_t region = EMPTY_REGION;
+    dirty_region_add(&region, x, y, cx, cy);
+    return region;
+}
+
+TEST(DirtyRegion, AnEmptyRegionHasNoBytes) {
+    dirty_region_t region = EMPTY_REGION;
+    EXPECT_TRUE(dirty_region_is_empty(&region));
+    dirty_region_add(&region, 2, 2, 0, 3);
+    EXPECT_TRUE(dirty_region_is_empty(&region));
+    EXPECT_EQ(dirty_region_bytes(&region, 1), 0);
+    EXPECT_EQ(dirty_region_bytes(&region, 8), 0);
+}
+
+TEST(DirtyRegion, GrowsToCoverEveryRectangle) {
+    dirty_region_t region = region_of(2, 3, 1, 1);
+    dirty_region_add(&region, 0, 5, 4, 2);
+    EXPECT_EQ(region.x0, 0);
+    EXPECT_EQ(region.y0, 3);
+    EXPECT_EQ(region.x1, 4);
+    EXPECT_EQ(region.y1, 7);
+}
+
+TEST(DirtyRegion, LedsHaveAByteEach) {
+    dirty_region_t region = region_of(1, 2, 3, 4);
+    EXPECT_EQ(dirty_region_bytes(&region, 1), 12);
+}
+
+TEST(DirtyRegion, TheLcdFlushesWholePagesOfEightRows) {
+    dirty_region_t one_page = region_of(0, 8, 10, 8);
+    EXPECT_EQ(dirty_region_bytes(&one_page, 8), 10);
+    // rows 7 to 8 cross a page boundary
+    dirty_region_t two_pages = region_of(0, 7, 10, 2);
+    EXPECT_EQ(dirty_region_bytes(&two_pages, 8), 20);
+}
+
+TEST(FlushCounter, FollowsTheSizeOfTheFlushedRegions) {
+    flush_counter_t counter = {};
+    dirty_region_t key = region_of(3, 3, 1, 1);
+    dirty_region_t row = region_of(0, 3, 7, 1);
+    for (int i = 0; i < 10; i++) {
+        flush_counter_add(&counter, dirty_region_bytes(&key, 1));
+    }
+    EXPECT_FALSE(flush_counter_update(&counter, second - 1, second));
+    EXPECT_TRUE(flush_counter_update(&counter, second, second));
+    EXPECT_EQ(counter.per_second, 10);
+
+    for (int i = 0; i < 10; i++) {
+        flush_counter_add(&counter, dirty_region_bytes(&row, 1));
+    }
+    EXPECT_TRUE(flush_counter_update(&counter, 2 * second, second));
+    EXPECT_EQ(counter.per_second, 70);
+
+    // nothing was flushed
+    EXPECT_TRUE(flush_counter_update(&counter, 3 * second, second));
+    EXPECT_EQ(counter.per_second, 0);
+}
+
+TEST(FlushCounter, ALateUpdateIsScaledToASecond) {
+    flush_counter_t counter = {};
+    counter.since = 500;
+    flush_counter_add(&counter, 300);
+    EXPECT_TRUE(flush_counter_update(&counter, 500 + 3 * second / 2, second));
+    EXPECT_EQ(counter.per_second, 200);
+    EXPECT_EQ(counter.bytes, 0);
+}
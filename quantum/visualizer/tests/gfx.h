@@ -0,0 +1,51 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VISUALIZER_TESTS_GFX_H
+#define VISUALIZER_TESTS_GFX_H
+
+/*
+ * Just enough of uGFX for running the keyframes natively, the displays are
+ * implemented by the tests, with one luma byte per pixel
+ */
+
+#include <stdint.h>
+
+typedef int16_t coord_t;
+typedef uint8_t color_t;
+typedef uint32_t systemticks_t;
+typedef struct GDisplay GDisplay;
+
+typedef enum {
+    powerOff,
+    powerOn,
+} powermode_t;
+
+typedef enum {
+    GDISP_ROTATE_0,
+    GDISP_ROTATE_180,
+} orientation_t;
+
+#define LUMA2COLOR(l) ((color_t)(l))
+
+void gdispGClear(GDisplay* g, color_t color);
+void gdispGDrawPixel(GDisplay* g, coord_t x, coord_t y, color_t color);
+void gdispGDrawLine(GDisplay* g, coord_t x0, coord_t y0, coord_t x1, coord_t y1, color_t color);
+color_t gdispGGetPixelColor(GDisplay* g, coord_t x, coord_t y);
+void gdispGSetOrientation(GDisplay* g, orientation_t orientation);
+void gdispGSetPowerMode(GDisplay* g, powermode_t mode);
+
+#endif
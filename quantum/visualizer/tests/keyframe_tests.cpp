@@ -0,0 +1,355 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+#include "visualizer.h"
+#include "led_backlight_keyframes.h"
+#include "lcd_backlight_keyframes.h"
+#include "animation_math.h"
+}
+
+struct GDisplay {
+    uint8_t pixels[LED_HEIGHT][LED_WIDTH];
+};
+
+static GDisplay led_display;
+
+extern "C" {
+
+GDisplay* LED_DISPLAY = &led_display;
+GDisplay* LCD_DISPLAY = nullptr;
+
+void gdispGClear(GDisplay* g, color_t color) {
+    memset(g->pixels, color, sizeof(g->pixels));
+}
+
+void gdispGDrawPixel(GDisplay* g, coord_t x, coord_t y, color_t color) {
+    g->pixels[y][x] = color;
+}
+
+// The keyframes only draw horizontal and vertical lines
+void gdispGDrawLine(GDisplay* g, coord_t x0, coord_t y0, coord_t x1, coord_t y1, color_t color) {
+    for (coord_t y = y0; y <= y1; y++) {
+        for (coord_t x = x0; x <= x1; x++) {
+            g->pixels[y][x] = color;
+        }
+    }
+}
+
+color_t gdispGGetPixelColor(GDisplay* g, coord_t x, coord_t y) {
+    return g->pixels[y][x];
+}
+
+void gdispGSetOrientation(GDisplay*, orientation_t) {
+}
+
+void gdispGSetPowerMode(GDisplay*, powermode_t) {
+}
+
+void visualizer_mark_dirty(GDisplay*, coord_t, coord_t, coord_t, coord_t) {
+}
+
+void visualizer_mark_all_dirty(GDisplay*) {
+}
+
+void visualizer_mark_nothing_drawn(void) {
+}
+
+void run_next_keyframe(keyframe_animation_t* animation, visualizer_state_t* state) {
+    int next_frame = animation->current_frame + 1;
+    if (next_frame == animation->num_frames) {
+        next_frame = 0;
+    }
+    keyframe_animation_t temp_animation = *animation;
+    temp_animation.current_frame = next_frame;
+    temp_animation.time_left_in_frame = animation->frame_lengths[next_frame];
+    visualizer_state_t temp_state = *state;
+    (*temp_animation.frame_functions[next_frame])(&temp_animation, &temp_state);
+}
+
+static uint16_t hal_rgb[3];
+
+void lcd_backlight_hal_init(void) {
+}
+
+void lcd_backlight_hal_color(uint16_t r, uint16_t g, uint16_t b) {
+    hal_rgb[0] = r;
+    hal_rgb[1] = g;
+    hal_rgb[2] = b;
+}
+
+}
+
+/*
+ * The float implementations that the keyframes used before, the output of
+ * the keyframes is compared with these
+ */
+
+static uint8_t float_gradient_color(float t, float index, float num) {
+    const float two_pi = M_PI * 2.0f;
+    float normalized_index = (1.0f - index / (num - 1.0f)) * two_pi;
+    float x = t * two_pi + normalized_index;
+    float v = 0.5 * (cosf(x) + 1.0f);
+    return (uint8_t)(255.0f * v);
+}
+
+static uint8_t int_fade_color(int frame_length, int time_left, int from, int to) {
+    int current_pos = frame_length - time_left;
+    return from + ((to - from) * current_pos) / frame_length;
+}
+
+static void float_hsi_to_rgb(float h, float s, float i, uint16_t* r_out, uint16_t* g_out, uint16_t* b_out) {
+    unsigned int r, g, b;
+    h = fmodf(h, 360.0f);
+    h = 3.14159f * h / 180.0f;
+    s = s > 0.0f ? (s < 1.0f ? s : 1.0f) : 0.0f;
+    i = i > 0.0f ? (i < 1.0f ? i : 1.0f) : 0.0f;
+
+    if(h < 2.09439f) {
+        r = 65535.0f * i/3.0f *(1.0f + s * cos(h) / cosf(1.047196667f - h));
+        g = 65535.0f * i/3.0f *(1.0f + s *(1.0f - cosf(h) / cos(1.047196667f - h)));
+        b = 65535.0f * i/3.0f *(1.0f - s);
+    } else if(h < 4.188787) {
+        h = h - 2.09439;
+        g = 65535.0f * i/3.0f *(1.0f + s * cosf(h) / cosf(1.047196667f - h));
+        b = 65535.0f * i/3.0f *(1.0f + s * (1.0f - cosf(h) / cosf(1.047196667f - h)));
+        r = 65535.0f * i/3.0f *(1.0f - s);
+    } else {
+        h = h - 4.188787;
+        b = 65535.0f*i/3.0f * (1.0f + s * cosf(h) / cosf(1.047196667f - h));
+        r = 65535.0f*i/3.0f * (1.0f + s * (1.0f - cosf(h) / cosf(1.047196667f - h)));
+        g = 65535.0f*i/3.0f * (1.0f - s);
+    }
+    *r_out = r > 65535 ? 65535 : r;
+    *g_out = g > 65535 ? 65535 : g;
+    *b_out = b > 65535 ? 65535 : b;
+}
+
+static void float_lcd_color(uint8_t hue, uint8_t saturation, uint8_t intensity, uint8_t brightness, uint16_t* rgb) {
+    float hue_f = 360.0f * (float)hue / 255.0f;
+    float saturation_f = (float)saturation / 255.0f;
+    float intensity_f = (float)intensity / 255.0f;
+    intensity_f *= (float)brightness / 255.0f;
+    float_hsi_to_rgb(hue_f, saturation_f, intensity_f, &rgb[0], &rgb[1], &rgb[2]);
+}
+
+static uint16_t float_cie_lightness(uint16_t v) {
+    float l =  100.0f * (v / 65535.0f);
+    float y = 0.0f;
+    if (l <= 8.0f) {
+       y = l / 902.3;
+    }
+    else {
+        y = ((l + 16.0f) / 116.0f);
+        y = y * y * y;
+        if (y > 1.0f) {
+            y = 1.0f;
+        }
+    }
+    return y * 65535.0f;
+}
+
+// One LSB of an 8 bit value, for values scaled to 16 bits
+static const int lsb16 = 65535 / 255;
+
+class Keyframes : public testing::Test {
+public:
+    Keyframes() {
+        memset(&animation, 0, sizeof(animation));
+        memset(&state, 0, sizeof(state));
+        memset(&led_display, 0, sizeof(led_display));
+    }
+
+    void run_frame(frame_func func, int frame_length, int time_left) {
+        animation.num_frames = 1;
+        animation.frame_lengths[0] = frame_length;
+        animation.frame_functions[0] = func;
+        animation.current_frame = 0;
+        animation.time_left_in_frame = time_left;
+        func(&animation, &state);
+    }
+
+    // The largest difference between the display and the expected image
+    int max_difference(uint8_t expected[LED_HEIGHT][LED_WIDTH]) {
+        int worst = 0;
+        for (int y = 0; y < LED_HEIGHT; y++) {
+            for (int x = 0; x < LED_WIDTH; x++) {
+                worst = std::max(worst, std::abs(led_display.pixels[y][x] - expected[y][x]));
+            }
+        }
+        return worst;
+    }
+
+    keyframe_animation_t animation;
+    visualizer_state_t state;
+};
+
+static const int frame_lengths[] = {1, 7, 100, 255, 1000, 4000};
+
+TEST_F(Keyframes, left_to_right_gradient_matches_the_float_version) {
+    for (int frame_length : frame_lengths) {
+        for (int time_left = frame_length; time_left >= 0; time_left--) {
+            run_frame(led_backlight_keyframe_left_to_right_gradient, frame_length, time_left);
+            uint8_t expected[LED_HEIGHT][LED_WIDTH];
+            float t = (float)(frame_length - time_left) / frame_length;
+            for (int y = 0; y < LED_HEIGHT; y++) {
+                for (int x = 0; x < LED_WIDTH; x++) {
+                    expected[y][x] = float_gradient_color(t, x, LED_WIDTH);
+                }
+            }
+            ASSERT_LE(max_difference(expected), 1) << frame_length << " " << time_left;
+        }
+    }
+}
+
+TEST_F(Keyframes, top_to_bottom_gradient_matches_the_float_version) {
+    for (int frame_length : frame_lengths) {
+        for (int time_left = frame_length; time_left >= 0; time_left--) {
+            run_frame(led_backlight_keyframe_top_to_bottom_gradient, frame_length, time_left);
+            uint8_t expected[LED_HEIGHT][LED_WIDTH];
+            float t = (float)(frame_length - time_left) / frame_length;
+            for (int y = 0; y < LED_HEIGHT; y++) {
+                for (int x = 0; x < LED_WIDTH; x++) {
+                    expected[y][x] = float_gradient_color(t, y, LED_HEIGHT);
+                }
+            }
+            ASSERT_LE(max_difference(expected), 1) << frame_length << " " << time_left;
+        }
+    }
+}
+
+TEST_F(Keyframes, fades_match_the_integer_version) {
+    for (int frame_length : frame_lengths) {
+        for (int time_left = frame_length; time_left >= 0; time_left--) {
+            uint8_t expected[LED_HEIGHT][LED_WIDTH];
+            run_frame(led_backlight_keyframe_fade_in_all, frame_length, time_left);
+            memset(expected, int_fade_color(frame_length, time_left, 0, 255), sizeof(expected));
+            ASSERT_LE(max_difference(expected), 1) << frame_length << " " << time_left;
+            run_frame(led_backlight_keyframe_fade_out_all, frame_length, time_left);
+            memset(expected, int_fade_color(frame_length, time_left, 255, 0), sizeof(expected));
+            ASSERT_LE(max_difference(expected), 1) << frame_length << " " << time_left;
+        }
+    }
+    // The ends are exact
+    run_frame(led_backlight_keyframe_fade_in_all, 100, 0);
+    EXPECT_EQ(led_display.pixels[0][0], 255);
+    run_frame(led_backlight_keyframe_fade_out_all, 100, 0);
+    EXPECT_EQ(led_display.pixels[0][0], 0);
+}
+
+TEST_F(Keyframes, crossfade_matches_the_integer_version) {
+    const int frame_length = 500;
+    animation.num_frames = 2;
+    animation.frame_lengths[0] = frame_length;
+    animation.frame_lengths[1] = frame_length;
+    animation.frame_functions[0] = led_backlight_keyframe_crossfade;
+    animation.frame_functions[1] = led_backlight_keyframe_left_to_right_gradient;
+    animation.current_frame = 0;
+
+    uint8_t start[LED_HEIGHT][LED_WIDTH];
+    srand(1);
+    for (int y = 0; y < LED_HEIGHT; y++) {
+        for (int x = 0; x < LED_WIDTH; x++) {
+            start[y][x] = rand() & 0xFF;
+        }
+    }
+    memcpy(led_display.pixels, start, sizeof(start));
+    for (int time_left = frame_length; time_left >= 0; time_left--) {
+        animation.first_update_of_frame = time_left == frame_length;
+        animation.time_left_in_frame = time_left;
+        led_backlight_keyframe_crossfade(&animation, &state);
+        uint8_t expected[LED_HEIGHT][LED_WIDTH];
+        for (int y = 0; y < LED_HEIGHT; y++) {
+            for (int x = 0; x < LED_WIDTH; x++) {
+                uint8_t end = float_gradient_color(0.0f, x, LED_WIDTH);
+                expected[y][x] = int_fade_color(frame_length, time_left, start[y][x], end);
+            }
+        }
+        // the gradient that is faded to can already be off by one
+        ASSERT_LE(max_difference(expected), 2) << time_left;
+    }
+}
+
+TEST_F(Keyframes, lcd_color_animation_matches_the_float_version) {
+    const int frame_length = 1000;
+    lcd_backlight_brightness(255);
+    srand(2);
+    int worst = 0;
+    for (int i = 0; i < 200; i++) {
+        state.prev_lcd_color = LCD_COLOR(rand() & 0xFF, rand() & 0xFF, rand() & 0xFF);
+        state.target_lcd_color = LCD_COLOR(rand() & 0xFF, rand() & 0xFF, rand() & 0xFF);
+        for (int time_left = frame_length; time_left >= 0; time_left -= 10) {
+            run_frame(lcd_backlight_keyframe_animate_color, frame_length, time_left);
+            uint32_t color = state.current_lcd_color;
+            uint16_t expected[3];
+            float_lcd_color(LCD_HUE(color), LCD_SAT(color), LCD_INT(color), 255, expected);
+            for (int c = 0; c < 3; c++) {
+                worst = std::max(worst, std::abs(hal_rgb[c] - expected[c]));
+            }
+        }
+    }
+    EXPECT_LE(worst, lsb16);
+}
+
+TEST(AnimationMath, hsi_matches_the_float_version_for_every_hue) {
+    int worst = 0;
+    for (int hue = 0; hue < 256; hue++) {
+        for (int saturation = 0; saturation < 256; saturation += 15) {
+            for (int intensity = 0; intensity < 256; intensity += 15) {
+                for (int brightness : {64, 255}) {
+                    uint16_t expected[3];
+                    uint16_t rgb[3];
+                    float_lcd_color(hue, saturation, intensity, brightness, expected);
+                    animation_hsi_to_rgb(hue, saturation, intensity * brightness, &rgb[0], &rgb[1], &rgb[2]);
+                    for (int c = 0; c < 3; c++) {
+                        worst = std::max(worst, std::abs(rgb[c] - expected[c]));
+                    }
+                }
+            }
+        }
+    }
+    EXPECT_LE(worst, lsb16);
+}
+
+TEST(AnimationMath, cie_lightness_matches_the_float_version) {
+    int worst = 0;
+    for (int v = 0; v < 65536; v++) {
+        worst = std::max(worst, std::abs(animation_cie_lightness(v) - float_cie_lightness(v)));
+    }
+    EXPECT_LE(worst, 8);
+}
+
+TEST(AnimationMath, cos_is_accurate_all_around) {
+    for (int angle = 0; angle < ANIMATION_TURN; angle++) {
+        double expected = 32768.0 * cos(angle * 2.0 * M_PI / ANIMATION_TURN);
+        ASSERT_NEAR(animation_cos(angle), expected, 4.0) << angle;
+    }
+}
+
+TEST(AnimationMath, lerp_reaches_both_ends) {
+    EXPECT_EQ(animation_lerp(10, 200, 0), 10);
+    EXPECT_EQ(animation_lerp(10, 200, ANIMATION_ONE), 200);
+    EXPECT_EQ(animation_lerp(200, 10, ANIMATION_ONE), 10);
+    EXPECT_EQ(animation_lerp(-100, 100, ANIMATION_ONE / 2), 0);
+    EXPECT_EQ(animation_fraction(-5, 100), 0);
+    EXPECT_EQ(animation_fraction(150, 100), ANIMATION_ONE);
+    EXPECT_EQ(animation_fraction(0, 0), ANIMATION_ONE);
+}
@@ -0,0 +1,13 @@
+visualizer_keyframes_DEFS := -DLED_WIDTH=7 -DLED_HEIGHT=7 -DLCD_BACKLIGHT_ENABLE
+visualizer_keyframes_INC := $(QUANTUM_PATH)/visualizer/tests $(QUANTUM_PATH)/visualizer
+visualizer_keyframes_SRC := \
+	$(QUANTUM_PATH)/visualizer/tests/keyframe_tests.cpp \
+	$(QUANTUM_PATH)/visualizer/animation_math.c \
+	$(QUANTUM_PATH)/visualizer/led_backlight_keyframes.c \
+	$(QUANTUM_PATH)/visualizer/lcd_backlight.c \
+	$(QUANTUM_PATH)/visualizer/lcd_backlight_keyframes.c
+
+visualizer_dirty_region_INC := $(QUANTUM_PATH)/visualizer/tests $(QUANTUM_PATH)/visualizer
+visualizer_dirty_region_SRC := \
+	$(QUANTUM_PATH)/visualizer/tests/dirty_region_tests.cpp \
+	$(QUANTUM_PATH)/visualizer/dirty_region.c
@@ -0,0 +1,3 @@
+TEST_LIST +=\
+	visualizer_keyframes\
+	visualizer_dirty_region
@@ -30,6 +30,7 @@ SOFTWARE.
 #endif
 
 #include "gfx.h"
+#include "dirty_region.h"
 
 #ifdef LCD_BACKLIGHT_ENABLE
 #include "lcd_backlight.h"
@@ -91,6 +92,11 @@ static bool visualizer_enabled = false;
 static uint8_t user_data[VISUALIZER_USER_DATA_SIZE];
 #endif
 
+static dirty_region_t lcd_dirty = EMPTY_REGION;
+static dirty_region_t led_dirty = EMPTY_REGION;
+static bool dirty_reported;
+static flush_counter_t flushed;
+
 #define MAX_SIMULTANEOUS_ANIMATIONS 4
 static keyframe_animation_t* animations[MAX_SIMULTANEOUS_ANIMATIONS] = {};
 
@@ -120,6 +126,68 @@ GDisplay* get_led_display(void) {
 }
 #endif
 
+static dirty_region_t* get_dirty_region(GDisplay* display) {
+    if (!display) {
+        return NULL;
+    }
+    if (display == LCD_DISPLAY) {
+        return &lcd_dirty;
+    }
+    if (display == LED_DISPLAY) {
+        return &led_dirty;
+    }
+    return NULL;
+}
+
+void visualizer_mark_dirty(GDisplay* display, coord_t x, coord_t y, coord_t cx, coord_t cy) {
+    dirty_reported = true;
+    dirty_region_t* region = get_dirty_region(display);
+    if (region) {
+        dirty_region_add(region, x, y, cx, cy);
+    }
+}
+
+void visualizer_mark_all_dirty(GDisplay* display) {
+    if (display) {
+        visualizer_mark_dirty(display, 0, 0, gdispGGetWidth(display), gdispGGetHeight(display));
+    }
+    else {
+        dirty_reported = true;
+    }
+}
+
+void visualizer_mark_nothing_drawn(void) {
+    dirty_reported = true;
+}
+
+uint32_t visualizer_get_bytes_flushed_per_second(void) {
+    return flushed.per_second;
+}
+
+static void flush_display(GDisplay* display) {
+    dirty_region_t* region = get_dirty_region(display);
+    if (!region || dirty_region_is_empty(region)) {
+        return;
+    }
+    // The LCD is monochrome with eight rows per byte, the LEDs have a byte each
+    flush_counter_add(&flushed, dirty_region_bytes(region, display == LCD_DISPLAY ? 8 : 1));
+    gdispGFlush(display);
+    *region = (dirty_region_t)EMPTY_REGION;
+}
+
+// Keyframes that don't know about dirty regions mark everything
+static bool call_frame_function(keyframe_animation_t* animation, int frame, visualizer_state_t* state) {
+    bool reported = dirty_reported;
+    dirty_reported = false;
+    bool ret = (*animation->frame_functions[frame])(animation, state);
+    if (!dirty_reported) {
+        visualizer_mark_all_dirty(LCD_DISPLAY);
+        visualizer_mark_all_dirty(LED_DISPLAY);
+    }
+    dirty_reported = reported;
+    return ret;
+}
+
 void start_keyframe_animation(keyframe_animation_t* animation) {
     animation->current_frame = -1;
     animation->time_left_in_frame = 0;
@@ -193,7 +261,7 @@ static bool update_keyframe_animation(keyframe_animation_t* animation, visualize
             if (animation->need_update) {
                 animation->time_left_in_frame = 0;
                 animation->last_update_of_frame = true;
-                (*animation->frame_functions[animation->current_frame])(animation, state);
+                call_frame_function(animation, animation->current_frame, state);
                 animation->last_update_of_frame = false;
             }
             animation->current_frame++;
@@ -214,7 +282,7 @@ static bool update_keyframe_animation(keyframe_animation_t* animation, visualize
         }
     }
     if (animation->need_update) {
-        animation->need_update = (*animation->frame_functions[animation->current_frame])(animation, state);
+        animation->need_update = call_frame_function(animation, animation->current_frame, state);
         animation->first_update_of_frame = false;
     }
 
@@ -238,7 +306,7 @@ void run_next_keyframe(keyframe_animation_t* animation, visualizer_state_t* stat
     temp_animation.last_update_of_frame = false;
     temp_animation.need_update  = false;
     visualizer_state_t temp_state = *state;
-    (*temp_animation.frame_functions[next_frame])(&temp_animation, &temp_state);
+    call_frame_function(&temp_animation, next_frame, &temp_state);
 }
 
 // TODO: Optimize the stack size, this is probably way too big
@@ -284,6 +352,7 @@ static DECLARE_THREAD_FUNCTION(visualizerThread, arg) {
 
     systemticks_t sleep_time = TIME_INFINITE;
     systemticks_t current_time = gfxSystemTicks();
+    flushed.since = current_time;
     bool force_update = true;
 
     while(true) {
@@ -299,6 +368,7 @@ static DECLARE_THREAD_FUNCTION(visualizerThread, arg) {
                     gdispGSetPowerMode(LED_DISPLAY, powerOn);
                     uint16_t percent = (uint16_t)current_status.backlight_level * 100 / BACKLIGHT_LEVELS;
                     gdispGSetBacklight(LED_DISPLAY, percent);
+                    visualizer_mark_all_dirty(LED_DISPLAY);
                 }
                 else {
                     gdispGSetPowerMode(LED_DISPLAY, powerOff);
@@ -336,16 +406,25 @@ static DECLARE_THREAD_FUNCTION(visualizerThread, arg) {
                 update_keyframe_animation(animations[i], &state, delta, &sleep_time);
             }
         }
+#ifdef EMULATOR
+        bool dirty = !dirty_region_is_empty(&led_dirty) || !dirty_region_is_empty(&lcd_dirty);
+#endif
 #ifdef BACKLIGHT_ENABLE
-        gdispGFlush(LED_DISPLAY);
+        flush_display(LED_DISPLAY);
 #endif
 
 #ifdef LCD_ENABLE
-        gdispGFlush(LCD_DISPLAY);
+        flush_display(LCD_DISPLAY);
 #endif
 
+        if (flush_counter_update(&flushed, current_time, gfxMillisecondsToTicks(1000))) {
+            dprintf("Flushed %lu bytes per second\n", (unsigned long)flushed.per_second);
+        }
+
 #ifdef EMULATOR
-        draw_emulator();
+        if (dirty) {
+            draw_emulator();
+        }
 #endif
         // Enable the visualizer when the startup or the suspend animation has finished
         if (!visualizer_enabled && state.status.suspended == false && get_num_running_animations() == 0) {
@@ -393,7 +472,9 @@ void visualizer_init(void) {
   #endif
 
   #ifdef SERIAL_LINK_ENABLE
-    add_remote_objects(remote_objects, sizeof(remote_objects) / sizeof(remote_object_t*) );
+    if (!add_remote_objects(remote_objects, sizeof(remote_objects) / sizeof(remote_object_t*) )) {
+        chSysHalt("visualizer objects don't fit in SERIAL_LINK_ARENA_SIZE");
+    }
   #endif
 
   #ifdef LCD_ENABLE
@@ -134,6 +134,16 @@ void stop_keyframe_animation(keyframe_animation_t* animation);
 // Useful for crossfades for example
 void run_next_keyframe(keyframe_animation_t* animation, visualizer_state_t* state);
 
+// Keyframe functions should report the parts of the displays they draw, so that
+// only the displays that have changed are flushed. A keyframe that doesn't report
+// anything is assumed to have redrawn every display.
+void visualizer_mark_dirty(GDisplay* display, coord_t x, coord_t y, coord_t cx, coord_t cy);
+void visualizer_mark_all_dirty(GDisplay* display);
+// Call this from keyframes that don't draw anything
+void visualizer_mark_nothing_drawn(void);
+// The amount of display data flushed during the last second
+uint32_t visualizer_get_bytes_flushed_per_second(void);
+
 // The master can set userdata which will be transferred to the slave
 #ifdef VISUALIZER_USER_DATA_SIZE
 void visualizer_set_user_data(void* user_data);
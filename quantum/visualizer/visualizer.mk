@@ -45,7 +45,9 @@ endef
 GDISP_DRIVER_LIST:=
 
 SRC += $(VISUALIZER_DIR)/visualizer.c \
-	$(VISUALIZER_DIR)/visualizer_keyframes.c
+	$(VISUALIZER_DIR)/visualizer_keyframes.c \
+	$(VISUALIZER_DIR)/animation_math.c \
+	$(VISUALIZER_DIR)/dirty_region.c
 EXTRAINCDIRS += $(GFXINC) $(VISUALIZER_DIR)
 GFXLIB = $(LIB_PATH)/ugfx
 VPATH += $(VISUALIZER_PATH)
@@ -0,0 +1,63 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+// Row 1 of the test keymap contains ten plain keys, which are pressed
+// simultaneously to form chords of different sizes
+class Chord : public TestFixture, public testing::WithParamInterface<unsigned> {
+protected:
+    // Runs scans until the given number of reports has been sent, and returns
+    // the number of scans (ms) it took. This is the events-to-report latency.
+    unsigned scans_until_reports(TestDriver& driver, unsigned num_reports) {
+        unsigned reports = 0;
+        EXPECT_CALL(driver, send_keyboard_mock(_))
+            .Times(AnyNumber())
+            .WillRepeatedly(Invoke([&reports](report_keyboard_t&) { reports++; }));
+        unsigned scans = 0;
+        while (reports < num_reports && scans < num_reports) {
+            run_one_scan_loop();
+            scans++;
+        }
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        EXPECT_EQ(reports, num_reports);
+        return scans;
+    }
+};
+
+TEST_P(Chord, AllKeysAreReportedWithinTheBoundOfKeysPerScan) {
+    TestDriver driver;
+    const unsigned num_keys = GetParam();
+    const unsigned expected_scans = (num_keys + QMK_KEYS_PER_SCAN - 1) / QMK_KEYS_PER_SCAN;
+
+    for (unsigned col = 0; col < num_keys; col++) {
+        press_key(col, 1);
+    }
+    const unsigned press_latency = scans_until_reports(driver, num_keys);
+    EXPECT_EQ(press_latency, expected_scans);
+
+    for (unsigned col = 0; col < num_keys; col++) {
+        release_key(col, 1);
+    }
+    const unsigned release_latency = scans_until_reports(driver, num_keys);
+    EXPECT_EQ(release_latency, expected_scans);
+}
+
+INSTANTIATE_TEST_CASE_P(ChordSizes, Chord, testing::Range(2u, 11u));
@@ -0,0 +1,166 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+// The translation action_for_key used before the basic keycodes were
+// converted by a table, used as the reference for the correctness tests
+static action_t reference_keycode_to_action(uint16_t keycode) {
+    action_t action;
+    uint8_t action_layer, when, mod;
+
+    switch (keycode) {
+        case KC_FN0 ... KC_FN31:
+            action.code = keymap_function_id_to_action(FN_INDEX(keycode));
+            break;
+        case KC_A ... KC_EXSEL:
+        case KC_LCTRL ... KC_RGUI:
+            action.code = ACTION_KEY(keycode);
+            break;
+        case KC_SYSTEM_POWER ... KC_SYSTEM_WAKE:
+            action.code = ACTION_USAGE_SYSTEM(KEYCODE2SYSTEM(keycode));
+            break;
+        case KC_AUDIO_MUTE ... KC_MEDIA_REWIND:
+            action.code = ACTION_USAGE_CONSUMER(KEYCODE2CONSUMER(keycode));
+            break;
+        case KC_MS_UP ... KC_MS_ACCEL2:
+            action.code = ACTION_MOUSEKEY(keycode);
+            break;
+        case KC_TRNS:
+            action.code = ACTION_TRANSPARENT;
+            break;
+        case QK_MODS ... QK_MODS_MAX:
+            // Has a modifier
+            // Split it up
+            action.code = ACTION_MODS_KEY(keycode >> 8, keycode & 0xFF); // adds modifier to key
+            break;
+        case QK_FUNCTION ... QK_FUNCTION_MAX: ;
+            // Is a shortcut for function action_layer, pull last 12bits
+            // This means we have 4,096 FN macros at our disposal
+            action.code = keymap_function_id_to_action( (int)keycode & 0xFFF );
+            break;
+        case QK_MACRO ... QK_MACRO_MAX:
+            if (keycode & 0x800) // tap macros have upper bit set
+                action.code = ACTION_MACRO_TAP(keycode & 0xFF);
+            else
+                action.code = ACTION_MACRO(keycode & 0xFF);
+            break;
+        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+            action.code = ACTION_LAYER_TAP_KEY((keycode >> 0x8) & 0xF, keycode & 0xFF);
+            break;
+        case QK_TO ... QK_TO_MAX: ;
+            // Layer set "GOTO"
+            when = (keycode >> 0x4) & 0x3;
+            action_layer = keycode & 0xF;
+            action.code = ACTION_LAYER_SET(action_layer, when);
+            break;
+        case QK_MOMENTARY ... QK_MOMENTARY_MAX: ;
+            // Momentary action_layer
+            action_layer = keycode & 0xFF;
+            action.code = ACTION_LAYER_MOMENTARY(action_layer);
+            break;
+        case QK_DEF_LAYER ... QK_DEF_LAYER_MAX: ;
+            // Set default action_layer
+            action_layer = keycode & 0xFF;
+            action.code = ACTION_DEFAULT_LAYER_SET(action_layer);
+            break;
+        case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX: ;
+            // Set toggle
+            action_layer = keycode & 0xFF;
+            action.code = ACTION_LAYER_TOGGLE(action_layer);
+            break;
+        case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX: ;
+            // OSL(action_layer) - One-shot action_layer
+            action_layer = keycode & 0xFF;
+            action.code = ACTION_LAYER_ONESHOT(action_layer);
+            break;
+        case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX: ;
+            // OSM(mod) - One-shot mod
+            mod = keycode & 0xFF;
+            action.code = ACTION_MODS_ONESHOT(mod);
+            break;
+        case QK_LAYER_TAP_TOGGLE ... QK_LAYER_TAP_TOGGLE_MAX:
+            action.code = ACTION_LAYER_TAP_TOGGLE(keycode & 0xFF);
+            break;
+        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+            mod = mod_config((keycode >> 0x8) & 0x1F);
+            action.code = ACTION_MODS_TAP_KEY(mod, keycode & 0xFF);
+            break;
+    #ifdef BACKLIGHT_ENABLE
+        case BL_ON:
+            action.code = ACTION_BACKLIGHT_ON();
+            break;
+        case BL_OFF:
+            action.code = ACTION_BACKLIGHT_OFF();
+            break;
+        case BL_DEC:
+            action.code = ACTION_BACKLIGHT_DECREASE();
+            break;
+        case BL_INC:
+            action.code = ACTION_BACKLIGHT_INCREASE();
+            break;
+        case BL_TOGG:
+            action.code = ACTION_BACKLIGHT_TOGGLE();
+            break;
+        case BL_STEP:
+            action.code = ACTION_BACKLIGHT_STEP();
+            break;
+    #endif
+        default:
+            action.code = ACTION_NO;
+            break;
+    }
+    return action;
+}
+
+class KeycodeToAction : public TestFixture {};
+
+TEST_F(KeycodeToAction, AllKeycodesMatchTheReference) {
+    for (uint32_t keycode = 0; keycode <= 0xFFFF; keycode++) {
+        ASSERT_EQ(keymap_keycode_to_action(keycode).code, reference_keycode_to_action(keycode).code)
+            << "keycode " << std::hex << keycode;
+    }
+}
+
+TEST_F(KeycodeToAction, AllKeysInTheKeymapMatchTheReference) {
+    // The number of layers in tests/basic/keymap.c
+    const uint8_t num_layers = 3;
+    for (uint8_t layer = 0; layer < num_layers; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keypos_t key = {.col = col, .row = row};
+                uint16_t keycode = keycode_config(keymap_key_to_keycode(layer, key));
+                EXPECT_EQ(action_for_key(layer, key).code, reference_keycode_to_action(keycode).code)
+                    << "layer " << (int)layer << " row " << (int)row << " col " << (int)col;
+            }
+        }
+    }
+}
+
+TEST_F(KeycodeToAction, KeymapConfigSwapsAreApplied) {
+    keymap_config.raw = 0;
+    keymap_config.swap_grave_esc = true;
+    keymap_config.swap_lalt_lgui = true;
+    eeconfig_update_keymap(keymap_config.raw);
+    EXPECT_EQ(keymap_keycode_to_action(keycode_config(KC_ESC)).code, ACTION_KEY(KC_GRAVE));
+    EXPECT_EQ(keymap_keycode_to_action(keycode_config(KC_LALT)).code, ACTION_KEY(KC_LGUI));
+    EXPECT_EQ(keymap_keycode_to_action(keycode_config(KC_A)).code, ACTION_KEY(KC_A));
+    EXPECT_EQ(keymap_keycode_to_action(ALT_T(KC_A)).code, ACTION_MODS_TAP_KEY(MOD_LGUI, KC_A));
+    keymap_config.raw = 0;
+    eeconfig_update_keymap(keymap_config.raw);
+    EXPECT_EQ(keymap_keycode_to_action(keycode_config(KC_ESC)).code, ACTION_KEY(KC_ESC));
+    EXPECT_EQ(keymap_keycode_to_action(ALT_T(KC_A)).code, ACTION_MODS_TAP_KEY(MOD_LALT, KC_A));
+}
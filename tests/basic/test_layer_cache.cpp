@@ -0,0 +1,125 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "action_layer.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class LayerCache : public TestFixture {
+protected:
+    // The same search that layer_switch_get_layer did before the cache
+    int8_t uncached_layer(keypos_t key) {
+        uint32_t layers = layer_state | default_layer_state;
+        for (int8_t i = 31; i >= 0; i--) {
+            if ((layers & (1UL << i)) && action_for_key(i, key).code != ACTION_TRANSPARENT) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    void expect_all_keys_match() {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keypos_t key = {.col = col, .row = row};
+                EXPECT_EQ(layer_switch_get_layer(key), uncached_layer(key))
+                    << "row " << (int)row << " col " << (int)col << " layer_state " << layer_state;
+            }
+        }
+    }
+};
+
+TEST_F(LayerCache, MatchesTheLayerSearchForAllLayerStates) {
+    for (uint32_t state = 0; state < 8; state++) {
+        layer_state = state;
+        expect_all_keys_match();
+    }
+    // And the same in reverse, to turn off the layers in different orders
+    for (uint32_t state = 8; state > 0; state--) {
+        layer_state = state - 1;
+        expect_all_keys_match();
+    }
+}
+
+TEST_F(LayerCache, KeysFollowLayerChanges) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E)));
+    run_one_scan_loop();
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    // Changing the layer state clears the keyboard
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    layer_on(2);
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_F1)));
+    run_one_scan_loop();
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    // Layer 1 is below layer 2, so only the keys transparent on layer 2 change
+    // Changing the layer state clears the keyboard
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    layer_on(1);
+    press_key(0, 1);
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_F1)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_F1, KC_2)));
+    run_one_scan_loop();
+    release_key(0, 1);
+    release_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    // Changing the layer state clears the keyboard
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    layer_off(2);
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_1)));
+    run_one_scan_loop();
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(LayerCache, DirectAssignmentsToTheLayerStateAreNoticed) {
+    TestDriver driver;
+    InSequence s;
+    layer_state = 1UL << 1;
+    press_key(2, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_3)));
+    run_one_scan_loop();
+    release_key(2, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    layer_state = 0;
+    press_key(2, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_G)));
+    run_one_scan_loop();
+    release_key(2, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
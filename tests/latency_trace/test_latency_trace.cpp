@@ -0,0 +1,79 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "latency_trace.h"
+
+using testing::_;
+using testing::InSequence;
+
+class LatencyTrace : public TestFixture {
+public:
+    LatencyTrace() {
+        // Throw away everything recorded by the previous tests
+        latency_trace_task();
+        latency_trace_clear();
+    }
+};
+
+TEST_F(LatencyTrace, ScanRateIsMeasured) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(100);
+    const latency_stats_t* stats = latency_trace_get_stats(LATENCY_SCAN_PERIOD);
+    // The first scan has no previous scan to compare against
+    EXPECT_EQ(stats->count, 99);
+    EXPECT_EQ(stats->min, 1000);
+    EXPECT_EQ(stats->max, 1000);
+    EXPECT_EQ(latency_trace_average(LATENCY_SCAN_PERIOD), 1000);
+    EXPECT_EQ(latency_trace_percentile(LATENCY_SCAN_PERIOD, 99), 1000);
+    EXPECT_EQ(latency_trace_get_stats(LATENCY_SCAN_DURATION)->count, 100);
+    EXPECT_EQ(latency_trace_get_stats(LATENCY_EVENT_TO_REPORT)->count, 0);
+}
+
+TEST_F(LatencyTrace, NormalKeyIsReportedDuringTheSameScan) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    const latency_stats_t* stats = latency_trace_get_stats(LATENCY_EVENT_TO_REPORT);
+    EXPECT_EQ(stats->count, 2);
+    EXPECT_EQ(stats->max, 0);
+    EXPECT_EQ(latency_trace_get_stats(LATENCY_EVENT_TO_PROCESS)->count, 2);
+}
+
+TEST_F(LatencyTrace, TapIsDelayedUntilTheRelease) {
+    TestDriver driver;
+    InSequence s;
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(50);
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    const latency_stats_t* stats = latency_trace_get_stats(LATENCY_EVENT_TO_REPORT);
+    EXPECT_EQ(stats->count, 1);
+    EXPECT_EQ(stats->min, 50000);
+    EXPECT_EQ(latency_trace_percentile(LATENCY_EVENT_TO_REPORT, 99), 50000);
+    EXPECT_EQ(latency_trace_get_stats(LATENCY_EVENT_TO_PROCESS)->max, 50000);
+}
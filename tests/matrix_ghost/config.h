@@ -0,0 +1,25 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_MATRIX_GHOST_CONFIG_H_
+#define TESTS_MATRIX_GHOST_CONFIG_H_
+
+/* A 16x8 matrix without diodes, like the ones found on the converters */
+#define MATRIX_ROWS 16
+#define MATRIX_COLS 8
+#define MATRIX_HAS_GHOST
+
+#endif /* TESTS_MATRIX_GHOST_CONFIG_H_ */
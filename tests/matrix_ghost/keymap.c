@@ -0,0 +1,47 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// Row 2, Col 0 has to be KC_NO, because tests rely on it
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A,    KC_B,    KC_C,    KC_D,    KC_E,    KC_F,    KC_G,    KC_H},
+        {KC_I,    KC_J,    KC_K,    KC_L,    KC_M,    KC_N,    KC_O,    KC_P},
+        {KC_NO,   KC_R,    KC_S,    KC_T,    KC_U,    KC_V,    KC_W,    KC_X},
+        {KC_Y,    KC_Z,    KC_1,    KC_2,    KC_3,    KC_4,    KC_5,    KC_6},
+        {KC_7,    KC_8,    KC_9,    KC_0,    KC_F1,   KC_F2,   KC_F3,   KC_F4},
+        {KC_F5,   KC_F6,   KC_F7,   KC_F8,   KC_F9,   KC_F10,  KC_F11,  KC_F12},
+        {KC_F13,  KC_F14,  KC_F15,  KC_F16,  KC_F17,  KC_F18,  KC_F19,  KC_F20},
+        {KC_F21,  KC_F22,  KC_F23,  KC_F24,  KC_ENT,  KC_ESC,  KC_BSPC, KC_TAB},
+        {KC_SPC,  KC_MINS, KC_EQL,  KC_LBRC, KC_RBRC, KC_BSLS, KC_SCLN, KC_QUOT},
+        {KC_GRV,  KC_COMM, KC_DOT,  KC_SLSH, KC_CAPS, KC_PSCR, KC_SLCK, KC_PAUS},
+        {KC_INS,  KC_HOME, KC_PGUP, KC_DEL,  KC_END,  KC_PGDN, KC_RGHT, KC_LEFT},
+        {KC_DOWN, KC_UP,   KC_NLCK, KC_PSLS, KC_PAST, KC_PMNS, KC_PPLS, KC_PENT},
+        {KC_P1,   KC_P2,   KC_P3,   KC_P4,   KC_P5,   KC_P6,   KC_P7,   KC_P8},
+        {KC_P9,   KC_P0,   KC_PDOT, KC_APP,  KC_NO,   KC_NO,   KC_NO,   KC_NO},
+        {KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO},
+        {KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO},
+    },
+};
+
+const macro_t *action_get_macro(keyrecord_t *record, uint8_t id, uint8_t opt) {
+    return MACRO_NONE;
+};
+
+void action_function(keyrecord_t *record, uint8_t id, uint8_t opt) {
+}
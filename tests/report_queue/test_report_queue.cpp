@@ -0,0 +1,240 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+
+extern "C" {
+    void advance_time(uint32_t ms);
+}
+
+class ReportQueue : public TestFixture {
+protected:
+    // Wraps the test driver, so that the host can be made busy
+    void wrap_driver() {
+        m_driver = *host_get_driver();
+        m_driver.keyboard_ready = &ReportQueue::keyboard_ready;
+        host_set_driver(&m_driver);
+        s_ready = true;
+        s_one_per_ms = false;
+    }
+
+    // Each failed poll takes 1 ms, like waiting for the next USB frame
+    static uint8_t keyboard_ready(void) {
+        bool ready = s_ready && !(s_one_per_ms && timer_read32() == s_last_sent);
+        if (!ready) {
+            advance_time(1);
+        }
+        return ready;
+    }
+
+    host_driver_t m_driver;
+    static bool s_ready;
+    static bool s_one_per_ms;
+    static uint32_t s_last_sent;
+};
+
+bool ReportQueue::s_ready;
+bool ReportQueue::s_one_per_ms;
+uint32_t ReportQueue::s_last_sent;
+
+TEST_F(ReportQueue, ReportIsSentImmediatelyWhenTheHostIsReady) {
+    TestDriver driver;
+    wrap_driver();
+    InSequence s;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    EXPECT_EQ(host_report_queue_count(), 0);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ReportQueue, ReportIsQueuedWhileTheHostIsBusy) {
+    TestDriver driver;
+    wrap_driver();
+    InSequence s;
+    s_ready = false;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    EXPECT_EQ(host_report_queue_count(), 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    s_ready = true;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    EXPECT_EQ(host_report_queue_count(), 0);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ReportQueue, PressesWaitingForTheHostAreMerged) {
+    TestDriver driver;
+    wrap_driver();
+    InSequence s;
+    s_ready = false;
+    press_key(0, 0);
+    run_one_scan_loop();
+    press_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(host_report_queue_count(), 1);
+    s_ready = true;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ReportQueue, PressAndReleaseAreNotMerged) {
+    TestDriver driver;
+    wrap_driver();
+    InSequence s;
+    s_ready = false;
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(host_report_queue_count(), 2);
+    s_ready = true;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ReportQueue, ModsAreNotMergedWithKeys) {
+    TestDriver driver;
+    wrap_driver();
+    InSequence s;
+    s_ready = false;
+    press_key(2, 0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(host_report_queue_count(), 2);
+    s_ready = true;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    run_one_scan_loop();
+    release_key(2, 0);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ReportQueue, FullQueueIsSentWhenTheHostDoesNotRespond) {
+    TestDriver driver;
+    wrap_driver();
+    InSequence s;
+    s_ready = false;
+    for (int i = 0; i < REPORT_QUEUE_SIZE / 2; i++) {
+        register_code(KC_A);
+        unregister_code(KC_A);
+    }
+    EXPECT_EQ(host_report_queue_count(), REPORT_QUEUE_SIZE);
+    // The oldest report is sent anyway after the timeout
+    uint32_t start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    register_code(KC_A);
+    EXPECT_GE(timer_read32() - start, REPORT_QUEUE_TIMEOUT);
+    EXPECT_EQ(host_report_queue_count(), REPORT_QUEUE_SIZE);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    s_ready = true;
+    // The release makes room for itself by sending one report
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(REPORT_QUEUE_SIZE + 1);
+    unregister_code(KC_A);
+    EXPECT_EQ(host_report_queue_count(), 0);
+}
+
+TEST_F(ReportQueue, SendStringIsLimitedByThePollRate) {
+    TestDriver driver;
+    wrap_driver();
+    s_one_per_ms = true;
+    unsigned reports = 0;
+    EXPECT_CALL(driver, send_keyboard_mock(_))
+        .WillRepeatedly(Invoke([&reports](report_keyboard_t&) {
+            reports++;
+            s_last_sent = timer_read32();
+        }));
+    s_last_sent = timer_read32();
+    uint32_t start = timer_read32();
+    send_string("Hello, world");
+    host_report_queue_task();
+    while (host_report_queue_count()) {
+        advance_time(1);
+        host_report_queue_task();
+    }
+    uint32_t elapsed = timer_read32() - start;
+    // One report per poll interval, with no extra stalls
+    EXPECT_EQ(elapsed, reports);
+}
+
+TEST_F(ReportQueue, OtherReportsAreSentAfterTheQueuedKeys) {
+    TestDriver driver;
+    wrap_driver();
+    InSequence s;
+    s_ready = false;
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(host_report_queue_count(), 2);
+    s_ready = true;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_consumer_mock(0xE9));
+    EXPECT_CALL(driver, send_mouse_mock(_));
+    EXPECT_CALL(driver, send_system_mock(0x82));
+    host_consumer_send(0xE9);
+    report_mouse_t mouse = {};
+    host_mouse_send(&mouse);
+    host_system_send(0x82);
+    EXPECT_EQ(host_report_queue_count(), 0);
+    EXPECT_CALL(driver, send_consumer_mock(0));
+    EXPECT_CALL(driver, send_system_mock(0));
+    host_consumer_send(0);
+    host_system_send(0);
+}
+
+TEST_F(ReportQueue, OtherReportsDoNotWaitForeverForTheQueue) {
+    TestDriver driver;
+    wrap_driver();
+    InSequence s;
+    s_ready = false;
+    press_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(host_report_queue_count(), 1);
+    uint32_t start = timer_read32();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_mouse_mock(_));
+    report_mouse_t mouse = {};
+    host_mouse_send(&mouse);
+    EXPECT_GE(timer_read32() - start, REPORT_QUEUE_TIMEOUT);
+    EXPECT_EQ(host_report_queue_count(), 0);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    s_ready = true;
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
@@ -0,0 +1,27 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_RGB_MATRIX_CONFIG_H_
+#define TESTS_RGB_MATRIX_CONFIG_H_
+
+// A full size keyboard, with four more LEDs underneath
+#define MATRIX_ROWS 6
+#define MATRIX_COLS 18
+
+#define RGB_MATRIX_LED_COUNT 112
+#define RGB_MATRIX_STARTUP_MODE RGB_MATRIX_SOLID_COLOR
+
+#endif /* TESTS_RGB_MATRIX_CONFIG_H_ */
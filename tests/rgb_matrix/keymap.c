@@ -0,0 +1,56 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_ESC, KC_F1, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9, KC_F10, KC_F11, KC_F12, KC_PSCR, KC_SLCK, KC_PAUS, RGB_TOG, RGB_MOD},
+        {KC_GRV, KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0, KC_MINS, KC_EQL, KC_BSPC, KC_INS, KC_HOME, KC_PGUP, KC_NLCK},
+        {KC_TAB, KC_Q, KC_W, KC_E, KC_R, KC_T, KC_Y, KC_U, KC_I, KC_O, KC_P, KC_LBRC, KC_RBRC, KC_BSLS, KC_DEL, KC_END, KC_PGDN, KC_PSLS},
+        {KC_CAPS, KC_A, KC_S, KC_D, KC_F, KC_G, KC_H, KC_J, KC_K, KC_L, KC_SCLN, KC_QUOT, KC_ENT, KC_P7, KC_P8, KC_P9, KC_PAST, KC_PMNS},
+        {KC_LSFT, KC_Z, KC_X, KC_C, KC_V, KC_B, KC_N, KC_M, KC_COMM, KC_DOT, KC_SLSH, KC_RSFT, KC_UP, KC_P4, KC_P5, KC_P6, KC_PPLS, KC_PENT},
+        {KC_LCTL, KC_LGUI, KC_LALT, KC_SPC, KC_RALT, KC_RGUI, KC_APP, KC_RCTL, KC_LEFT, KC_DOWN, KC_RGHT, KC_P1, KC_P2, KC_P3, KC_P0, KC_PDOT, RGB_HUI, RGB_VAI},
+    },
+};
+
+// The LEDs go row by row under the keys, spaced 15 units apart
+#define KEY_LED(row, col) {row, col, (col) * 15, (row) * 15}
+#define KEY_LED_ROW(row) \
+    KEY_LED(row, 0), KEY_LED(row, 1), KEY_LED(row, 2), KEY_LED(row, 3), KEY_LED(row, 4), KEY_LED(row, 5), \
+    KEY_LED(row, 6), KEY_LED(row, 7), KEY_LED(row, 8), KEY_LED(row, 9), KEY_LED(row, 10), KEY_LED(row, 11), \
+    KEY_LED(row, 12), KEY_LED(row, 13), KEY_LED(row, 14), KEY_LED(row, 15), KEY_LED(row, 16), KEY_LED(row, 17)
+
+const rgb_matrix_led_t rgb_matrix_leds[RGB_MATRIX_LED_COUNT] PROGMEM = {
+    KEY_LED_ROW(0),
+    KEY_LED_ROW(1),
+    KEY_LED_ROW(2),
+    KEY_LED_ROW(3),
+    KEY_LED_ROW(4),
+    KEY_LED_ROW(5),
+    // Underglow in the corners
+    {RGB_MATRIX_NO_KEY, RGB_MATRIX_NO_KEY, 0, 0},
+    {RGB_MATRIX_NO_KEY, RGB_MATRIX_NO_KEY, 255, 0},
+    {RGB_MATRIX_NO_KEY, RGB_MATRIX_NO_KEY, 0, 75},
+    {RGB_MATRIX_NO_KEY, RGB_MATRIX_NO_KEY, 255, 75},
+};
+
+const macro_t *action_get_macro(keyrecord_t *record, uint8_t id, uint8_t opt) {
+    return MACRO_NONE;
+};
+
+void action_function(keyrecord_t *record, uint8_t id, uint8_t opt) {
+}
@@ -0,0 +1,232 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <cstring>
+
+extern "C" {
+#include "rgb_matrix_driver.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::InSequence;
+
+// The number of scans it takes to render one frame
+static const unsigned scans_per_frame =
+    (RGB_MATRIX_LED_COUNT + RGB_MATRIX_LED_PROCESS_LIMIT - 1) / RGB_MATRIX_LED_PROCESS_LIMIT;
+
+static uint8_t key_led(uint8_t row, uint8_t col) {
+    return row * MATRIX_COLS + col;
+}
+
+static bool led_is_off(uint8_t led) {
+    const LED_TYPE& l = rgb_matrix_test_leds[led];
+    return l.r == 0 && l.g == 0 && l.b == 0;
+}
+
+class RgbMatrix : public TestFixture {
+public:
+    RgbMatrix() {
+        rgb_matrix_init();
+        rgb_matrix_sethsv(0, 255, 255);
+    }
+
+    // Runs the scans of one whole frame without moving the time forward
+    void draw_frame() {
+        for (unsigned i = 0; i < scans_per_frame; i++) {
+            rgb_matrix_task();
+        }
+    }
+
+    // The frames and writes of a still picture
+    void expect_no_writes_for(unsigned scans) {
+        uint32_t flushes = rgb_matrix_test_flushes;
+        uint32_t written = rgb_matrix_test_leds_written;
+        for (unsigned i = 0; i < scans; i++) {
+            rgb_matrix_task();
+            advance_time(1);
+        }
+        EXPECT_EQ(rgb_matrix_test_flushes, flushes);
+        EXPECT_EQ(rgb_matrix_test_leds_written, written);
+    }
+};
+
+TEST_F(RgbMatrix, KeysAreMappedToTheirLeds) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            EXPECT_EQ(rgb_matrix_key_to_led(row, col), key_led(row, col));
+        }
+    }
+    EXPECT_EQ(rgb_matrix_key_to_led(MATRIX_ROWS, 0), RGB_MATRIX_NO_LED);
+}
+
+TEST_F(RgbMatrix, AFrameIsSpreadOverScans) {
+    for (unsigned i = 0; i < scans_per_frame; i++) {
+        uint32_t written = rgb_matrix_test_leds_written;
+        EXPECT_EQ(rgb_matrix_test_flushes, 0);
+        rgb_matrix_task();
+        EXPECT_LE(rgb_matrix_test_leds_written - written, RGB_MATRIX_LED_PROCESS_LIMIT);
+    }
+    EXPECT_EQ(rgb_matrix_test_flushes, 1);
+    EXPECT_EQ(rgb_matrix_test_leds_written, RGB_MATRIX_LED_COUNT);
+    EXPECT_FALSE(rgb_matrix_test_out_of_range);
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        EXPECT_EQ(rgb_matrix_test_leds[i].r, 255);
+        EXPECT_EQ(rgb_matrix_test_leds[i].g, 0);
+        EXPECT_EQ(rgb_matrix_test_leds[i].b, 0);
+    }
+}
+
+TEST_F(RgbMatrix, AStillPictureIsOnlyWrittenOnce) {
+    draw_frame();
+    expect_no_writes_for(100);
+    rgb_matrix_sethsv(85, 255, 255);
+    uint32_t written = rgb_matrix_test_leds_written;
+    draw_frame();
+    EXPECT_EQ(rgb_matrix_test_leds_written - written, RGB_MATRIX_LED_COUNT);
+    EXPECT_EQ(rgb_matrix_test_flushes, 2);
+    EXPECT_EQ(rgb_matrix_test_leds[0].r, 0);
+    EXPECT_EQ(rgb_matrix_test_leds[0].g, 255);
+    expect_no_writes_for(100);
+}
+
+TEST_F(RgbMatrix, CycleLeftRightMovesToTheRight) {
+    rgb_matrix_mode(RGB_MATRIX_CYCLE_LEFT_RIGHT);
+    draw_frame();
+    LED_TYPE before[RGB_MATRIX_LED_COUNT];
+    memcpy(before, rgb_matrix_test_leds, sizeof(before));
+    // The hue moves one step each 16ms, and the keys are 15 steps apart
+    advance_time(16 * 15);
+    draw_frame();
+    for (uint8_t col = 1; col < MATRIX_COLS; col++) {
+        EXPECT_EQ(memcmp(&rgb_matrix_test_leds[key_led(0, col)], &before[key_led(0, col - 1)], sizeof(LED_TYPE)), 0);
+    }
+    EXPECT_NE(memcmp(&rgb_matrix_test_leds[0], &before[0], sizeof(LED_TYPE)), 0);
+}
+
+TEST_F(RgbMatrix, PressedKeyLightsUpAndFades) {
+    TestDriver driver;
+    InSequence s;
+    rgb_matrix_mode(RGB_MATRIX_REACTIVE);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(scans_per_frame);
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        EXPECT_TRUE(led_is_off(i));
+    }
+
+    press_key(5, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_G)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(5, 3);
+    idle_for(scans_per_frame);
+    EXPECT_GT(rgb_matrix_test_leds[key_led(3, 5)].r, 240);
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        if (i != key_led(3, 5)) {
+            EXPECT_TRUE(led_is_off(i));
+        }
+    }
+
+    idle_for(RGB_MATRIX_REACTIVE_FADE_MS / 2);
+    EXPECT_GT(rgb_matrix_test_leds[key_led(3, 5)].r, 0);
+    EXPECT_LT(rgb_matrix_test_leds[key_led(3, 5)].r, 255);
+    idle_for(RGB_MATRIX_REACTIVE_FADE_MS / 2);
+    EXPECT_TRUE(led_is_off(key_led(3, 5)));
+    idle_for(RGB_MATRIX_SPLASH_MS);
+    expect_no_writes_for(100);
+}
+
+TEST_F(RgbMatrix, SplashSpreadsFromTheKey) {
+    TestDriver driver;
+    InSequence s;
+    rgb_matrix_mode(RGB_MATRIX_SPLASH);
+    press_key(9, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_O)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(9, 2);
+    // The ring has travelled 60 units, four keys
+    idle_for(240);
+    draw_frame();
+    EXPECT_TRUE(led_is_off(key_led(2, 9)));
+    EXPECT_FALSE(led_is_off(key_led(2, 5)));
+    EXPECT_FALSE(led_is_off(key_led(2, 13)));
+    EXPECT_TRUE(led_is_off(key_led(2, 1)));
+    EXPECT_TRUE(led_is_off(key_led(2, 17)));
+    idle_for(RGB_MATRIX_SPLASH_MS);
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        EXPECT_TRUE(led_is_off(i));
+    }
+    expect_no_writes_for(100);
+}
+
+TEST_F(RgbMatrix, SplashAfterTheKeysWentIdle) {
+    TestDriver driver;
+    InSequence s;
+    rgb_matrix_mode(RGB_MATRIX_SPLASH);
+    press_key(1, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(1, 2);
+    // Long enough for the splash to be forgotten
+    idle_for(RGB_MATRIX_SPLASH_MS + 2 * scans_per_frame);
+
+    press_key(9, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_O)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(9, 2);
+    idle_for(240);
+    draw_frame();
+    EXPECT_TRUE(led_is_off(key_led(2, 9)));
+    EXPECT_FALSE(led_is_off(key_led(2, 5)));
+    EXPECT_FALSE(led_is_off(key_led(2, 13)));
+}
+
+TEST_F(RgbMatrix, DisablingTurnsTheLedsOff) {
+    rgb_matrix_mode(RGB_MATRIX_CYCLE_ALL);
+    draw_frame();
+    EXPECT_FALSE(led_is_off(0));
+    rgb_matrix_disable();
+    draw_frame();
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        EXPECT_TRUE(led_is_off(i));
+    }
+    expect_no_writes_for(100);
+}
+
+TEST_F(RgbMatrix, RgbKeycodesControlTheMatrix) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    press_key(17, 0);
+    run_one_scan_loop();
+    release_key(17, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(rgb_matrix_get_mode(), RGB_MATRIX_SOLID_COLOR + 1);
+    press_key(16, 5);
+    run_one_scan_loop();
+    release_key(16, 5);
+    run_one_scan_loop();
+    EXPECT_EQ(rgb_matrix_get_config()->hue, RGB_MATRIX_HUE_STEP);
+    press_key(16, 0);
+    run_one_scan_loop();
+    release_key(16, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(rgb_matrix_get_mode(), 0);
+}
@@ -0,0 +1,288 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <string>
+
+extern "C" {
+#include "progmem.h"
+#include "rgblight.h"
+#include "ws2812.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+extern rgblight_config_t rgblight_config;
+}
+
+typedef std::function<void(LED_TYPE*)> render_func;
+
+// The effects as they were drawn before the effect engine, each call draws
+// the next frame, starting from the first one
+static render_func previous_effect(uint8_t mode) {
+    if (mode >= 2 && mode <= 5) {
+        return [pos = 0](LED_TYPE* leds) mutable {
+            float val = (exp(sin((pos/255.0)*M_PI)) - RGBLIGHT_EFFECT_BREATHE_CENTER/M_E)*(RGBLIGHT_EFFECT_BREATHE_MAX/(M_E-1/M_E));
+            for (int i = 0; i < RGBLED_NUM; i++) {
+                sethsv(rgblight_config.hue, rgblight_config.sat, val, &leds[i]);
+            }
+            pos = (pos + 1) % 256;
+        };
+    } else if (mode >= 6 && mode <= 8) {
+        return [current_hue = 0](LED_TYPE* leds) mutable {
+            for (int i = 0; i < RGBLED_NUM; i++) {
+                sethsv(current_hue, rgblight_config.sat, rgblight_config.val, &leds[i]);
+            }
+            current_hue = (current_hue + 1) % 360;
+        };
+    } else if (mode >= 9 && mode <= 14) {
+        return [current_hue = 0, interval = mode - 9](LED_TYPE* leds) mutable {
+            for (int i = 0; i < RGBLED_NUM; i++) {
+                uint16_t hue = (360 / RGBLED_NUM * i + current_hue) % 360;
+                sethsv(hue, rgblight_config.sat, rgblight_config.val, &leds[i]);
+            }
+            if (interval % 2) {
+                current_hue = (current_hue + 1) % 360;
+            } else {
+                current_hue = current_hue - 1 < 0 ? 359 : current_hue - 1;
+            }
+        };
+    } else if (mode >= 15 && mode <= 20) {
+        return [pos = 0, interval = mode - 15](LED_TYPE* leds) mutable {
+            int8_t increment = interval % 2 ? -1 : 1;
+            for (int i = 0; i < RGBLED_NUM; i++) {
+                leds[i].r = 0;
+                leds[i].g = 0;
+                leds[i].b = 0;
+                for (int j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
+                    int8_t k = pos + j * increment;
+                    if (k < 0) {
+                        k = k + RGBLED_NUM;
+                    }
+                    if (i == k) {
+                        sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val*(RGBLIGHT_EFFECT_SNAKE_LENGTH-j)/RGBLIGHT_EFFECT_SNAKE_LENGTH), &leds[i]);
+                    }
+                }
+            }
+            if (increment == 1) {
+                pos = pos - 1 < 0 ? RGBLED_NUM - 1 : pos - 1;
+            } else {
+                pos = (pos + 1) % RGBLED_NUM;
+            }
+        };
+    } else if (mode >= 21 && mode <= 23) {
+        return [low_bound = 0, high_bound = RGBLIGHT_EFFECT_KNIGHT_LENGTH - 1, increment = 1](LED_TYPE* leds) mutable {
+            for (int i = 0; i < RGBLED_NUM; i++) {
+                leds[i].r = 0;
+                leds[i].g = 0;
+                leds[i].b = 0;
+            }
+            for (int i = 0; i < RGBLIGHT_EFFECT_KNIGHT_LED_NUM; i++) {
+                int cur = (i + RGBLIGHT_EFFECT_KNIGHT_OFFSET) % RGBLED_NUM;
+                if (i >= low_bound && i <= high_bound) {
+                    sethsv(rgblight_config.hue, rgblight_config.sat, rgblight_config.val, &leds[cur]);
+                }
+            }
+            low_bound += increment;
+            high_bound += increment;
+            if (high_bound <= 0 || low_bound >= RGBLIGHT_EFFECT_KNIGHT_LED_NUM - 1) {
+                increment = -increment;
+            }
+        };
+    } else if (mode == 24) {
+        return [current_offset = 0](LED_TYPE* leds) mutable {
+            current_offset = (current_offset + 1) % 2;
+            for (int i = 0; i < RGBLED_NUM; i++) {
+                uint16_t hue = ((i/RGBLIGHT_EFFECT_CHRISTMAS_STEP + current_offset) % 2) * 120;
+                sethsv(hue, rgblight_config.sat, rgblight_config.val, &leds[i]);
+            }
+        };
+    } else {
+        return [mode](LED_TYPE* leds) {
+            static const uint16_t ranges[] = {360, 240, 180, 120, 90};
+            int8_t direction = ((mode - 25) % 2) ? -1 : 1;
+            uint16_t range = ranges[(mode - 25) / 2];
+            for (int i = 0; i < RGBLED_NUM; i++) {
+                uint16_t hue = (range / RGBLED_NUM * i * direction + rgblight_config.hue + 360) % 360;
+                sethsv(hue, rgblight_config.sat, rgblight_config.val, &leds[i]);
+            }
+        };
+    }
+}
+
+static uint16_t frame_interval(uint8_t mode) {
+    if (mode >= 2 && mode <= 5) {
+        return pgm_read_byte(&RGBLED_BREATHING_INTERVALS[mode - 2]);
+    } else if (mode >= 6 && mode <= 8) {
+        return pgm_read_byte(&RGBLED_RAINBOW_MOOD_INTERVALS[mode - 6]);
+    } else if (mode >= 9 && mode <= 14) {
+        return pgm_read_byte(&RGBLED_RAINBOW_SWIRL_INTERVALS[(mode - 9) / 2]);
+    } else if (mode >= 15 && mode <= 20) {
+        return pgm_read_byte(&RGBLED_SNAKE_INTERVALS[(mode - 15) / 2]);
+    } else if (mode >= 21 && mode <= 23) {
+        return pgm_read_byte(&RGBLED_KNIGHT_INTERVALS[mode - 21]);
+    }
+    return RGBLIGHT_EFFECT_CHRISTMAS_INTERVAL;
+}
+
+static bool operator==(const LED_TYPE& a, const LED_TYPE& b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static std::string to_string(const LED_TYPE* leds) {
+    std::string s;
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        s += "(" + std::to_string(leds[i].r) + "," + std::to_string(leds[i].g) + "," + std::to_string(leds[i].b) + ")";
+    }
+    return s;
+}
+
+class RgbLight : public testing::Test {
+public:
+    RgbLight() {
+        set_time(1000);
+        rgblight_enable();
+        set_color(0, 255, 255);
+    }
+
+    // The color can only be fully changed in static light mode
+    void set_color(uint16_t hue, uint8_t sat, uint8_t val) {
+        rgblight_mode(1);
+        rgblight_sethsv(hue, sat, val);
+    }
+
+    // Draws the next frame of the current effect
+    void next_frame() {
+        advance_time(frame_interval(rgblight_config.mode));
+        rgblight_task();
+    }
+};
+
+TEST_F(RgbLight, AnimatedEffectsDrawTheSameFramesAsBefore) {
+    set_color(200, 180, 220);
+    // breathing is only close to what it was, see the next test
+    for (uint8_t mode = 6; mode <= 24; mode++) {
+        // the 16 bit timer doesn't wrap during the frames, as 65535 ms is
+        // 65534 ms to timer_elapsed
+        set_time(1000);
+        rgblight_mode(mode);
+        render_func previous = previous_effect(mode);
+        LED_TYPE expected[RGBLED_NUM] = {};
+        rgblight_task();
+        for (int frame = 0; frame < std::min(400, 60000 / frame_interval(mode)); frame++) {
+            previous(expected);
+            ASSERT_EQ(to_string(led), to_string(expected)) << "mode " << int(mode) << " frame " << frame;
+            next_frame();
+        }
+    }
+}
+
+TEST_F(RgbLight, BreathingIsWithinOneStepOfTheFloatingPointCurve) {
+    set_color(40, 0, 255);
+    rgblight_mode(2);
+    rgblight_task();
+    for (int pos = 0; pos < 512; pos++) {
+        double val = (exp(sin(((pos % 256)/255.0)*M_PI)) - RGBLIGHT_EFFECT_BREATHE_CENTER/M_E)*(RGBLIGHT_EFFECT_BREATHE_MAX/(M_E-1/M_E));
+        // with no saturation every channel shows the value
+        int difference = 256;
+        for (int v = 0; v < 256; v++) {
+            LED_TYPE expected;
+            sethsv(0, 0, v, &expected);
+            if (expected == led[0]) {
+                difference = std::min(difference, std::abs(v - (int)val));
+            }
+        }
+        ASSERT_LE(difference, 1) << "pos " << pos;
+        next_frame();
+    }
+}
+
+TEST_F(RgbLight, StaticGradientsDrawTheSameAsBefore) {
+    for (uint16_t hue = 0; hue < 360; hue += 35) {
+        for (uint8_t mode = 25; mode <= 34; mode++) {
+            set_color(hue, 255, 200);
+            rgblight_mode(mode);
+            LED_TYPE expected[RGBLED_NUM];
+            previous_effect(mode)(expected);
+            ASSERT_EQ(to_string(led), to_string(expected)) << "mode " << int(mode) << " hue " << hue;
+        }
+    }
+}
+
+TEST_F(RgbLight, TheColorIsKeptByEffectsThatAnimateIt) {
+    set_color(100, 150, 200);
+    rgblight_mode(2);
+    rgblight_sethsv(10, 20, 30);
+    EXPECT_EQ(rgblight_get_hue(), 10);
+    EXPECT_EQ(rgblight_get_sat(), 20);
+    EXPECT_EQ(rgblight_get_val(), 200);
+    rgblight_mode(9);
+    rgblight_sethsv(50, 60, 70);
+    EXPECT_EQ(rgblight_get_hue(), 10);
+    EXPECT_EQ(rgblight_get_sat(), 60);
+    EXPECT_EQ(rgblight_get_val(), 70);
+}
+
+TEST_F(RgbLight, FramesAreDrawnAtTheEffectInterval) {
+    rgblight_mode(24);
+    rgblight_task();
+    LED_TYPE first[RGBLED_NUM];
+    memcpy(first, led, sizeof(led));
+    advance_time(RGBLIGHT_EFFECT_CHRISTMAS_INTERVAL - 1);
+    rgblight_task();
+    EXPECT_EQ(to_string(led), to_string(first));
+    advance_time(1);
+    rgblight_task();
+    EXPECT_NE(to_string(led), to_string(first));
+}
+
+TEST_F(RgbLight, StaticLightIsNotAnimated) {
+    rgblight_mode(1);
+    uint32_t frames = ws2812_test_frames;
+    for (int i = 0; i < 1000; i++) {
+        advance_time(1);
+        rgblight_task();
+    }
+    EXPECT_EQ(ws2812_test_frames, frames);
+}
+
+TEST_F(RgbLight, UnchangedFramesAreNotSent) {
+    set_color(20, 255, 255);
+    uint32_t frames = ws2812_test_frames;
+    set_color(20, 255, 255);
+    rgblight_setrgb_at(led[3].r, led[3].g, led[3].b, 3);
+    EXPECT_EQ(ws2812_test_frames, frames);
+    set_color(21, 255, 255);
+    EXPECT_EQ(ws2812_test_frames, frames + 1);
+    LED_TYPE expected;
+    sethsv(21, 255, 255, &expected);
+    EXPECT_EQ(ws2812_test_num_leds, RGBLED_NUM);
+    EXPECT_TRUE(ws2812_test_leds[RGBLED_NUM - 1] == expected);
+
+    // The slowest breathing repeats values at the top of the breath
+    set_color(20, 255, 128);
+    rgblight_mode(2);
+    frames = ws2812_test_frames;
+    rgblight_task();
+    for (int i = 1; i < 256; i++) {
+        next_frame();
+    }
+    const uint32_t sent = ws2812_test_frames - frames;
+    EXPECT_LT(sent, 256);
+}
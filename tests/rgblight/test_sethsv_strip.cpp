@@ -0,0 +1,108 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <random>
+
+extern "C" {
+#include "progmem.h"
+#include "rgblight.h"
+#include "led_tables.h"
+}
+
+// sethsv as it was before sethsv_strip, one LED at a time
+static void previous_sethsv(uint16_t hue, uint8_t sat, uint8_t val, LED_TYPE *led1) {
+    uint8_t r = 0, g = 0, b = 0, base, color;
+
+    if (sat == 0) {
+        r = val;
+        g = val;
+        b = val;
+    } else {
+        base = ((255 - sat) * val) >> 8;
+        color = (val - base) * (hue % 60) / 60;
+
+        switch (hue / 60) {
+            case 0: r = val; g = base + color; b = base; break;
+            case 1: r = val - color; g = val; b = base; break;
+            case 2: r = base; g = val; b = base + color; break;
+            case 3: r = base; g = val - color; b = val; break;
+            case 4: r = base + color; g = base; b = val; break;
+            case 5: r = val; g = base; b = val - color; break;
+        }
+    }
+    led1->r = pgm_read_byte(&CIE1931_CURVE[r]);
+    led1->g = pgm_read_byte(&CIE1931_CURVE[g]);
+    led1->b = pgm_read_byte(&CIE1931_CURVE[b]);
+}
+
+static bool same(const LED_TYPE& a, const LED_TYPE& b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+TEST(SethsvStrip, EveryColorIsTheSameAsBefore) {
+    for (uint16_t hue = 0; hue < 360; hue++) {
+        for (int sat = 0; sat < 256; sat++) {
+            for (int val = 0; val < 256; val++) {
+                LED_TYPE expected, actual;
+                previous_sethsv(hue, sat, val, &expected);
+                sethsv(hue, sat, val, &actual);
+                ASSERT_TRUE(same(actual, expected)) << hue << " " << sat << " " << val;
+            }
+        }
+    }
+}
+
+TEST(SethsvStrip, GradientsAreTheSameAsOneLedAtATime) {
+    std::mt19937 rng(0);
+    LED_TYPE leds[256];
+    for (int n = 0; n < 2000; n++) {
+        uint16_t hue = rng() % 360;
+        int16_t step = (int)(rng() % 721) - 360;
+        uint8_t sat = rng();
+        uint8_t val = rng();
+        uint16_t count = 1 + rng() % 256;
+        sethsv_strip(hue, step, sat, val, leds, count);
+        for (int i = 0; i < count; i++) {
+            LED_TYPE expected;
+            previous_sethsv(((hue + step * i) % 360 + 360) % 360, sat, val, &expected);
+            ASSERT_TRUE(same(leds[i], expected)) << "hue " << hue << " step " << step << " led " << i;
+        }
+    }
+}
+
+TEST(SethsvStrip, HuesWrapAround) {
+    LED_TYPE leds[3], expected;
+    sethsv_strip(400, -50, 255, 255, leds, 3);
+    previous_sethsv(40, 255, 255, &expected);
+    EXPECT_TRUE(same(leds[0], expected));
+    previous_sethsv(350, 255, 255, &expected);
+    EXPECT_TRUE(same(leds[1], expected));
+    previous_sethsv(300, 255, 255, &expected);
+    EXPECT_TRUE(same(leds[2], expected));
+}
+
+TEST(SethsvStrip, StepsOfAWholeTurnOrMoreWrapAround) {
+    const int16_t steps[] = {360, -360, 720, -720, -1, 1000, -1000, 32767, -32768};
+    LED_TYPE leds[8], expected;
+    for (int16_t step : steps) {
+        sethsv_strip(100, step, 255, 255, leds, 8);
+        for (int i = 0; i < 8; i++) {
+            previous_sethsv(((100 + step * i) % 360 + 360) % 360, 255, 255, &expected);
+            EXPECT_TRUE(same(leds[i], expected)) << "step " << step << " led " << i;
+        }
+    }
+}
@@ -0,0 +1,285 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <cstdlib>
+
+extern "C" {
+#include "split/transport.h"
+#include "split/loopback.h"
+}
+
+// The shared state is read and applied through these on a real keyboard,
+// here they just record what the slave got
+static split_shared_state_t master_state;
+static split_shared_state_t slave_state;
+static uint8_t slave_state_flags;
+static unsigned slave_state_updates;
+
+extern "C" {
+void split_get_shared_state(split_shared_state_t* state) {
+    *state = master_state;
+}
+
+void split_apply_shared_state(uint8_t flags, const split_shared_state_t* state) {
+    if (flags & SPLIT_STATE_LAYER) {
+        slave_state.layer_state = state->layer_state;
+    }
+    if (flags & SPLIT_STATE_LEDS) {
+        slave_state.leds = state->leds;
+    }
+    slave_state_flags |= flags;
+    slave_state_updates++;
+}
+}
+
+class SplitTransport : public testing::Test {
+public:
+    SplitTransport() {
+        memset(slave_rows, 0, sizeof(slave_rows));
+        memset(master_rows, 0, sizeof(master_rows));
+        memset(&master_state, 0, sizeof(master_state));
+        memset(&slave_state, 0, sizeof(slave_state));
+        slave_state_flags = 0;
+        slave_state_updates = 0;
+        split_loopback_reset();
+        split_transport_slave_init();
+        split_transport_master_init();
+    }
+
+    bool update() {
+        split_transport_slave_update(slave_rows);
+        return split_transport_master_update(master_rows);
+    }
+
+    unsigned reply_bytes_of_next_update() {
+        uint32_t before = split_loopback_stats.reply_bytes;
+        EXPECT_TRUE(update());
+        return split_loopback_stats.reply_bytes - before;
+    }
+
+    unsigned request_bytes_of_next_update() {
+        uint32_t before = split_loopback_stats.request_bytes;
+        EXPECT_TRUE(update());
+        return split_loopback_stats.request_bytes - before;
+    }
+
+    void expect_rows_equal() {
+        for (unsigned row = 0; row < ROWS_PER_HAND; row++) {
+            EXPECT_EQ(master_rows[row], slave_rows[row]) << "row " << row;
+        }
+    }
+
+    matrix_row_t slave_rows[ROWS_PER_HAND];
+    matrix_row_t master_rows[ROWS_PER_HAND];
+};
+
+static bool drop_replies(uint8_t* frame, uint8_t len, bool to_slave) {
+    return to_slave;
+}
+
+static bool drop_requests(uint8_t* frame, uint8_t len, bool to_slave) {
+    return !to_slave;
+}
+
+static bool corrupt_replies(uint8_t* frame, uint8_t len, bool to_slave) {
+    if (!to_slave) {
+        frame[len / 2] ^= 0x10;
+    }
+    return true;
+}
+
+static bool corrupt_requests(uint8_t* frame, uint8_t len, bool to_slave) {
+    if (to_slave) {
+        frame[0] ^= 0x01;
+    }
+    return true;
+}
+
+// seq, mask and crc, followed by the rows
+static const unsigned reply_overhead = 1 + SPLIT_ROW_MASK_SIZE + 1;
+
+TEST_F(SplitTransport, SlaveRowsReachTheMaster) {
+    slave_rows[0] = 0x01;
+    slave_rows[3] = 0x24;
+    EXPECT_TRUE(update());
+    expect_rows_equal();
+}
+
+TEST_F(SplitTransport, TheFirstReplyHasEveryRow) {
+    EXPECT_EQ(reply_bytes_of_next_update(), reply_overhead + ROWS_PER_HAND * sizeof(matrix_row_t));
+}
+
+TEST_F(SplitTransport, OnlyChangedRowsAreSent) {
+    EXPECT_TRUE(update());
+    EXPECT_EQ(reply_bytes_of_next_update(), reply_overhead);
+    slave_rows[2] = 0x08;
+    EXPECT_EQ(reply_bytes_of_next_update(), reply_overhead + sizeof(matrix_row_t));
+    expect_rows_equal();
+    EXPECT_EQ(reply_bytes_of_next_update(), reply_overhead);
+    slave_rows[1] = 0x02;
+    slave_rows[2] = 0x00;
+    EXPECT_EQ(reply_bytes_of_next_update(), reply_overhead + 2 * sizeof(matrix_row_t));
+    expect_rows_equal();
+}
+
+TEST_F(SplitTransport, ALostReplyIsSentAgain) {
+    EXPECT_TRUE(update());
+    slave_rows[1] = 0x04;
+    split_loopback_set_fault(drop_replies);
+    EXPECT_FALSE(update());
+    EXPECT_EQ(master_rows[1], 0);
+    split_loopback_set_fault(NULL);
+    EXPECT_EQ(reply_bytes_of_next_update(), reply_overhead + sizeof(matrix_row_t));
+    expect_rows_equal();
+}
+
+TEST_F(SplitTransport, ACorruptReplyIsIgnored) {
+    EXPECT_TRUE(update());
+    slave_rows[1] = 0x04;
+    split_loopback_set_fault(corrupt_replies);
+    EXPECT_FALSE(update());
+    EXPECT_EQ(master_rows[1], 0);
+    split_loopback_set_fault(NULL);
+    EXPECT_TRUE(update());
+    expect_rows_equal();
+}
+
+TEST_F(SplitTransport, ARowThatChangesBackWhileRequestsAreLostIsCorrected) {
+    EXPECT_TRUE(update());
+    slave_rows[1] = 0x04;
+    EXPECT_TRUE(update());
+    // The master has the row, but the slave never hears about it
+    split_loopback_set_fault(drop_requests);
+    EXPECT_FALSE(update());
+    split_loopback_set_fault(corrupt_requests);
+    EXPECT_FALSE(update());
+    split_loopback_set_fault(NULL);
+    slave_rows[1] = 0x00;
+    EXPECT_TRUE(update());
+    expect_rows_equal();
+}
+
+TEST_F(SplitTransport, AResetMasterGetsEveryRow) {
+    slave_rows[0] = 0x01;
+    EXPECT_TRUE(update());
+    memset(master_rows, 0, sizeof(master_rows));
+    split_transport_master_reset();
+    EXPECT_EQ(reply_bytes_of_next_update(), reply_overhead + ROWS_PER_HAND * sizeof(matrix_row_t));
+    expect_rows_equal();
+}
+
+TEST_F(SplitTransport, AResetSlaveSendsEveryRowAndGetsTheStateAgain) {
+    master_state.leds = 0x02;
+    slave_rows[0] = 0x01;
+    EXPECT_TRUE(update());
+    EXPECT_TRUE(update());
+    EXPECT_EQ(slave_state.leds, 0x02);
+    split_transport_slave_init();
+    memset(&slave_state, 0, sizeof(slave_state));
+    EXPECT_EQ(reply_bytes_of_next_update(), reply_overhead + ROWS_PER_HAND * sizeof(matrix_row_t));
+    expect_rows_equal();
+    EXPECT_TRUE(update());
+    EXPECT_TRUE(update());
+    EXPECT_EQ(slave_state.leds, 0x02);
+}
+
+TEST_F(SplitTransport, SharedStateIsSentOnlyWhenItChanges) {
+    // ack, flags and crc
+    const unsigned request_overhead = 3;
+    master_state.layer_state = 0x5;
+    master_state.leds = 0x1;
+    EXPECT_EQ(request_bytes_of_next_update(), request_overhead + 5);
+    EXPECT_TRUE(update());
+    EXPECT_EQ(slave_state.layer_state, 0x5u);
+    EXPECT_EQ(slave_state.leds, 0x1);
+    EXPECT_EQ(slave_state_flags, SPLIT_STATE_LAYER | SPLIT_STATE_LEDS);
+    EXPECT_EQ(request_bytes_of_next_update(), request_overhead);
+
+    slave_state_flags = 0;
+    master_state.leds = 0x3;
+    EXPECT_EQ(request_bytes_of_next_update(), request_overhead + 1);
+    EXPECT_TRUE(update());
+    EXPECT_EQ(slave_state.leds, 0x3);
+    EXPECT_EQ(slave_state_flags, SPLIT_STATE_LEDS);
+}
+
+TEST_F(SplitTransport, SharedStateIsSentAgainUntilTheSlaveConfirmsIt) {
+    EXPECT_TRUE(update());
+    master_state.layer_state = 0x2;
+    split_loopback_set_fault(drop_requests);
+    EXPECT_FALSE(update());
+    EXPECT_FALSE(update());
+    split_loopback_set_fault(drop_replies);
+    EXPECT_FALSE(update());
+    split_loopback_set_fault(NULL);
+    EXPECT_EQ(request_bytes_of_next_update(), 3u + 4);
+    EXPECT_TRUE(update());
+    EXPECT_EQ(slave_state.layer_state, 0x2u);
+    EXPECT_EQ(request_bytes_of_next_update(), 3u);
+}
+
+static unsigned fault_rate;
+
+static bool random_faults(uint8_t* frame, uint8_t len, bool to_slave) {
+    unsigned r = rand() % 100;
+    if (r < fault_rate) {
+        return false;
+    }
+    if (r < 2 * fault_rate) {
+        frame[rand() % len] ^= 1 << (rand() % 8);
+    }
+    return true;
+}
+
+TEST_F(SplitTransport, TheMasterStaysInSyncOnABadLine) {
+    srand(1);
+    fault_rate = 10;
+    split_loopback_set_fault(random_faults);
+    unsigned successes = 0;
+    for (unsigned i = 0; i < 10000; i++) {
+        if (rand() % 4 == 0) {
+            slave_rows[rand() % ROWS_PER_HAND] ^= 1 << (rand() % MATRIX_COLS);
+        }
+        if (rand() % 16 == 0) {
+            master_state.layer_state = 1 << (rand() % 4);
+        }
+        if (update()) {
+            successes++;
+            for (unsigned row = 0; row < ROWS_PER_HAND; row++) {
+                ASSERT_EQ(master_rows[row], slave_rows[row]) << "row " << row << " iteration " << i;
+            }
+        }
+    }
+    split_loopback_set_fault(NULL);
+    EXPECT_TRUE(update());
+    EXPECT_TRUE(update());
+    EXPECT_EQ(slave_state.layer_state, master_state.layer_state);
+    EXPECT_GT(successes, 0);
+}
+
+TEST_F(SplitTransport, RepliesWhileTypingOnlyCarryTheChangedRow) {
+    const unsigned num_transactions = 10000;
+    for (unsigned i = 0; i < num_transactions; i++) {
+        // Typing speed, a key changes every 16 scans
+        if (i % 16 == 0) {
+            slave_rows[(i / 16) % ROWS_PER_HAND] ^= 1 << ((i / 16) % MATRIX_COLS);
+        }
+        ASSERT_TRUE(update());
+    }
+    const unsigned reply_bytes = (split_loopback_stats.reply_bytes + num_transactions - 1) / num_transactions;
+    EXPECT_LE(reply_bytes, reply_overhead + 1);
+}
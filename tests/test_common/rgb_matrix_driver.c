@@ -0,0 +1,47 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "rgb_matrix.h"
+#include "rgb_matrix_driver.h"
+
+LED_TYPE rgb_matrix_test_leds[RGB_MATRIX_TEST_MAX_LEDS];
+uint32_t rgb_matrix_test_writes = 0;
+uint32_t rgb_matrix_test_leds_written = 0;
+uint32_t rgb_matrix_test_flushes = 0;
+bool rgb_matrix_test_out_of_range = false;
+
+void rgb_matrix_driver_init(void) {
+    memset(rgb_matrix_test_leds, 0, sizeof(rgb_matrix_test_leds));
+    rgb_matrix_test_writes = 0;
+    rgb_matrix_test_leds_written = 0;
+    rgb_matrix_test_flushes = 0;
+    rgb_matrix_test_out_of_range = false;
+}
+
+void rgb_matrix_driver_write(uint8_t first, const LED_TYPE *leds, uint8_t count) {
+    if (count == 0 || first + count > RGB_MATRIX_LED_COUNT) {
+        rgb_matrix_test_out_of_range = true;
+        return;
+    }
+    memcpy(&rgb_matrix_test_leds[first], leds, count * sizeof(LED_TYPE));
+    rgb_matrix_test_writes++;
+    rgb_matrix_test_leds_written += count;
+}
+
+void rgb_matrix_driver_flush(void) {
+    rgb_matrix_test_flushes++;
+}
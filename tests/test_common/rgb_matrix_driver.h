@@ -0,0 +1,39 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_TEST_COMMON_RGB_MATRIX_DRIVER_H_
+#define TESTS_TEST_COMMON_RGB_MATRIX_DRIVER_H_
+
+#include "rgblight_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Records what the RGB matrix writes instead of driving any LEDs
+#define RGB_MATRIX_TEST_MAX_LEDS 256
+extern LED_TYPE rgb_matrix_test_leds[RGB_MATRIX_TEST_MAX_LEDS];
+extern uint32_t rgb_matrix_test_writes;
+extern uint32_t rgb_matrix_test_leds_written;
+extern uint32_t rgb_matrix_test_flushes;
+// Set when a write is outside of the LEDs
+extern bool rgb_matrix_test_out_of_range;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TESTS_TEST_COMMON_RGB_MATRIX_DRIVER_H_ */
@@ -53,5 +53,5 @@ void TestDriver::send_system(uint16_t data) {
 }
 
 void TestDriver::send_consumer(uint16_t data) {
-    m_this->send_consumer(data);
+    m_this->send_consumer_mock(data);
 }
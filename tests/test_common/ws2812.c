@@ -0,0 +1,32 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "ws2812.h"
+
+LED_TYPE ws2812_test_leds[WS2812_TEST_MAX_LEDS];
+uint16_t ws2812_test_num_leds = 0;
+uint32_t ws2812_test_frames = 0;
+
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds) {
+    memcpy(ws2812_test_leds, ledarray, number_of_leds * sizeof(LED_TYPE));
+    ws2812_test_num_leds = number_of_leds;
+    ws2812_test_frames++;
+}
+
+void ws2812_setleds_rgbw(LED_TYPE *ledarray, uint16_t number_of_leds) {
+    ws2812_setleds(ledarray, number_of_leds);
+}
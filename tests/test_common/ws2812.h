@@ -0,0 +1,39 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_TEST_COMMON_WS2812_H_
+#define TESTS_TEST_COMMON_WS2812_H_
+
+#include "rgblight_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds);
+void ws2812_setleds_rgbw(LED_TYPE *ledarray, uint16_t number_of_leds);
+
+// Records what has been sent to the LEDs instead of driving them
+#define WS2812_TEST_MAX_LEDS 256
+extern LED_TYPE ws2812_test_leds[WS2812_TEST_MAX_LEDS];
+extern uint16_t ws2812_test_num_leds;
+extern uint32_t ws2812_test_frames;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TESTS_TEST_COMMON_WS2812_H_ */
@@ -81,6 +81,10 @@ ifeq ($(strip $(USB_6KRO_ENABLE)), yes)
     TMK_COMMON_DEFS += -DUSB_6KRO_ENABLE
 endif
 
+ifeq ($(strip $(REPORT_QUEUE_ENABLE)), yes)
+    TMK_COMMON_DEFS += -DREPORT_QUEUE_ENABLE
+endif
+
 ifeq ($(strip $(SLEEP_LED_ENABLE)), yes)
     TMK_COMMON_SRC += $(PLATFORM_COMMON_DIR)/sleep_led.c
     TMK_COMMON_DEFS += -DSLEEP_LED_ENABLE
@@ -44,9 +44,16 @@ int retro_tapping_counter = 0;
 #include <fauxclicky.h>
 #endif
 
+#ifdef RGB_MATRIX_ENABLE
+#include "rgb_matrix.h"
+#endif
+
+#include "latency_trace.h"
+
 void action_exec(keyevent_t event)
 {
     if (!IS_NOEVENT(event)) {
+        LATENCY_TRACE(TRACE_EVENT);
         dprint("\n---- action_exec: start -----\n");
         dprint("EVENT: "); debug_event(event); dprintln();
 #ifdef RETRO_TAPPING
@@ -64,6 +71,12 @@ void action_exec(keyevent_t event)
     fauxclicky_check();
 #endif
 
+#ifdef RGB_MATRIX_ENABLE
+    if (IS_PRESSED(event)) {
+        rgb_matrix_record_key(event);
+    }
+#endif
+
 #ifdef ONEHAND_ENABLE
     if (!IS_NOEVENT(event)) {
         process_hand_swap(&event);
@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "action.h"
 #include "util.h"
@@ -201,15 +202,15 @@ action_t store_or_get_action(bool pressed, keypos_t key)
 }
 
 
-int8_t layer_switch_get_layer(keypos_t key)
-{
 #ifndef NO_ACTION_LAYER
+/* find the topmost non-transparent layer of key among the active layers */
+static int8_t layer_find_top(uint32_t layers, keypos_t key)
+{
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
-    uint32_t layers = layer_state | default_layer_state;
     /* check top layer first */
-    for (int8_t i = 31; i >= 0; i--) {
+    for (int8_t i = biton32(layers); i >= 0; i--) {
         if (layers & (1UL<<i)) {
             action = action_for_key(i, key);
             if (action.code != ACTION_TRANSPARENT) {
@@ -219,6 +220,60 @@ int8_t layer_switch_get_layer(keypos_t key)
     }
     /* fall back to layer 0 */
     return 0;
+}
+#endif
+
+#if !defined(NO_ACTION_LAYER) && !defined(NO_LAYER_CACHE)
+/*
+ * Effective keymap cache
+ *
+ * Stores the resolved layer of each key plus one, zero meaning that the key
+ * has to be resolved again. The layer state the cache was built for is kept,
+ * so that also direct assignments to layer_state are noticed.
+ */
+static uint8_t layer_cache[MATRIX_ROWS][MATRIX_COLS];
+static uint32_t layer_cache_state = 0;
+
+void layer_cache_invalidate(void)
+{
+    memset(layer_cache, 0, sizeof(layer_cache));
+}
+
+static void layer_cache_update(uint32_t layers)
+{
+    uint32_t changed = layers ^ layer_cache_state;
+    if (!changed) {
+        return;
+    }
+    layer_cache_state = layers;
+
+    /* keys resolved to a layer above all the changed ones stay the same */
+    uint8_t highest = biton32(changed) + 1;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (layer_cache[row][col] <= highest) {
+                layer_cache[row][col] = 0;
+            }
+        }
+    }
+}
+#endif
+
+int8_t layer_switch_get_layer(keypos_t key)
+{
+#ifndef NO_ACTION_LAYER
+    uint32_t layers = layer_state | default_layer_state;
+#ifndef NO_LAYER_CACHE
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        layer_cache_update(layers);
+        uint8_t *entry = &layer_cache[key.row][key.col];
+        if (!*entry) {
+            *entry = layer_find_top(layers, key) + 1;
+        }
+        return *entry - 1;
+    }
+#endif
+    return layer_find_top(layers, key);
 #else
     return biton32(default_layer_state);
 #endif
@@ -96,6 +96,14 @@ uint8_t read_source_layers_cache(keypos_t key);
 #endif
 action_t store_or_get_action(bool pressed, keypos_t key);
 
+/* effective keymap cache */
+#if !defined(NO_ACTION_LAYER) && !defined(NO_LAYER_CACHE)
+/* call after changing the contents of the keymap at runtime */
+void layer_cache_invalidate(void);
+#else
+#define layer_cache_invalidate()
+#endif
+
 /* return the topmost non-transparent layer currently associated with key */
 int8_t layer_switch_get_layer(keypos_t key);
 
@@ -116,6 +116,26 @@ uint32_t timer_elapsed32(uint32_t last)
     return TIMER_DIFF_32(t, last);
 }
 
+inline
+uint32_t timer_read_us(void)
+{
+    uint32_t t;
+    uint8_t raw;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      t = timer_count;
+      raw = TIMER_RAW;
+#ifndef __AVR_ATmega32A__
+      // The compare match happened after interrupts were disabled
+      if ((TIFR0 & (1<<OCF0A)) && raw < TIMER_RAW_TOP / 2) t++;
+#else
+      if ((TIFR & (1<<OCF0)) && raw < TIMER_RAW_TOP / 2) t++;
+#endif
+    }
+
+    return t * 1000 + (uint32_t)raw * 1000 / TIMER_RAW_TOP;
+}
+
 // excecuted once per 1ms.(excess for just timer count?)
 #ifndef __AVR_ATmega32A__
 #define TIMER_INTERRUPT_VECTOR TIMER0_COMPA_vect
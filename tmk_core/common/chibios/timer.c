@@ -25,3 +25,12 @@ uint32_t timer_elapsed32(uint32_t last)
 {
     return ST2MS(chVTTimeElapsedSinceX(MS2ST(last)));
 }
+
+uint32_t timer_read_us(void)
+{
+#if (1000000 % CH_CFG_ST_FREQUENCY) == 0
+    return (uint32_t)chVTGetSystemTime() * (1000000 / CH_CFG_ST_FREQUENCY);
+#else
+    return ST2MS(chVTGetSystemTime()) * 1000;
+#endif
+}
@@ -21,6 +21,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "latency_trace.h"
+#ifdef REPORT_QUEUE_ENABLE
+#include "timer.h"
+#include "keycode_config.h"
+#endif
 
 static host_driver_t *driver;
 static uint16_t last_system_report = 0;
@@ -42,11 +47,10 @@ uint8_t host_keyboard_leds(void)
     if (!driver) return 0;
     return (*driver->keyboard_leds)();
 }
-/* send report */
-void host_keyboard_send(report_keyboard_t *report)
+static void host_keyboard_send_now(report_keyboard_t *report)
 {
-    if (!driver) return;
     (*driver->send_keyboard)(report);
+    LATENCY_TRACE(TRACE_REPORT);
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -57,9 +61,145 @@ void host_keyboard_send(report_keyboard_t *report)
     }
 }
 
+#ifdef REPORT_QUEUE_ENABLE
+/*
+ * Keyboard report queue
+ *
+ * The reports are queued and sent when the driver is ready to accept them,
+ * instead of blocking in the driver. A report that is still waiting in the
+ * queue is merged with the next one, when no key press or release would be
+ * lost by doing so. The other reports are still sent directly, once the
+ * queue has been flushed, so that they stay in order with the keys.
+ */
+static report_keyboard_t report_queue[REPORT_QUEUE_SIZE];
+static uint8_t report_queue_head = 0;
+static uint8_t report_queue_len = 0;
+static report_keyboard_t report_queue_last_sent;
+
+#define REPORT_QUEUE_INDEX(i) (((i) + report_queue_head) % REPORT_QUEUE_SIZE)
+
+/* true if all the keys of report a are also pressed in report b */
+static bool report_keys_subset(report_keyboard_t *a, report_keyboard_t *b)
+{
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if (a->nkro.bits[i] & ~b->nkro.bits[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (!a->keys[i]) {
+            continue;
+        }
+        uint8_t j = 0;
+        for (; j < KEYBOARD_REPORT_KEYS && b->keys[j] != a->keys[i]; j++)
+            ;
+        if (j == KEYBOARD_REPORT_KEYS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * The report in the middle can be dropped, if the keys only get pressed or
+ * only get released over the three reports, and the mods stay the same.
+ * Mod changes are never merged, so that a shifted key is never pressed
+ * before the shift, or a shift released before the key.
+ */
+static bool report_can_merge(report_keyboard_t *prev, report_keyboard_t *middle, report_keyboard_t *next)
+{
+    if (prev->mods != middle->mods || middle->mods != next->mods) {
+        return false;
+    }
+    return (report_keys_subset(prev, middle) && report_keys_subset(middle, next)) ||
+           (report_keys_subset(middle, prev) && report_keys_subset(next, middle));
+}
+
+static bool report_queue_driver_ready(void)
+{
+    return !driver->keyboard_ready || (*driver->keyboard_ready)();
+}
+
+static void report_queue_send_head(void)
+{
+    report_queue_last_sent = report_queue[report_queue_head];
+    report_queue_head = REPORT_QUEUE_INDEX(1);
+    report_queue_len--;
+    host_keyboard_send_now(&report_queue_last_sent);
+}
+
+/* wait for the host to take a report, but don't hang if it's gone */
+static void report_queue_send_head_blocking(void)
+{
+    uint16_t start = timer_read();
+    while (!report_queue_driver_ready() && timer_elapsed(start) < REPORT_QUEUE_TIMEOUT)
+        ;
+    report_queue_send_head();
+}
+
+static void report_queue_flush(void)
+{
+    while (report_queue_len) {
+        report_queue_send_head_blocking();
+    }
+}
+
+static void report_queue_push(report_keyboard_t *report)
+{
+    if (report_queue_len) {
+        report_keyboard_t *tail = &report_queue[REPORT_QUEUE_INDEX(report_queue_len - 1)];
+        report_keyboard_t *prev = report_queue_len > 1 ?
+            &report_queue[REPORT_QUEUE_INDEX(report_queue_len - 2)] : &report_queue_last_sent;
+        if (report_can_merge(prev, tail, report)) {
+            *tail = *report;
+            return;
+        }
+    }
+
+    if (report_queue_len == REPORT_QUEUE_SIZE) {
+        report_queue_send_head_blocking();
+    }
+    report_queue[REPORT_QUEUE_INDEX(report_queue_len)] = *report;
+    report_queue_len++;
+}
+
+void host_report_queue_task(void)
+{
+    if (!driver) return;
+    while (report_queue_len && report_queue_driver_ready()) {
+        report_queue_send_head();
+    }
+}
+
+uint8_t host_report_queue_count(void)
+{
+    return report_queue_len;
+}
+#endif
+
+/* send report */
+void host_keyboard_send(report_keyboard_t *report)
+{
+    if (!driver) return;
+#ifdef REPORT_QUEUE_ENABLE
+    report_queue_push(report);
+    host_report_queue_task();
+#else
+    host_keyboard_send_now(report);
+#endif
+}
+
 void host_mouse_send(report_mouse_t *report)
 {
     if (!driver) return;
+#ifdef REPORT_QUEUE_ENABLE
+    report_queue_flush();
+#endif
     (*driver->send_mouse)(report);
 }
 
@@ -69,6 +209,9 @@ void host_system_send(uint16_t report)
     last_system_report = report;
 
     if (!driver) return;
+#ifdef REPORT_QUEUE_ENABLE
+    report_queue_flush();
+#endif
     (*driver->send_system)(report);
 }
 
@@ -78,6 +221,9 @@ void host_consumer_send(uint16_t report)
     last_consumer_report = report;
 
     if (!driver) return;
+#ifdef REPORT_QUEUE_ENABLE
+    report_queue_flush();
+#endif
     (*driver->send_consumer)(report);
 }
 
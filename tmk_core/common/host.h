@@ -46,6 +46,19 @@ void host_consumer_send(uint16_t data);
 uint16_t host_last_system_report(void);
 uint16_t host_last_consumer_report(void);
 
+#ifdef REPORT_QUEUE_ENABLE
+#ifndef REPORT_QUEUE_SIZE
+#define REPORT_QUEUE_SIZE 4
+#endif
+/* how long to wait for the host when the queue is full (ms) */
+#ifndef REPORT_QUEUE_TIMEOUT
+#define REPORT_QUEUE_TIMEOUT 10
+#endif
+/* send the queued keyboard reports the driver is ready for */
+void host_report_queue_task(void);
+uint8_t host_report_queue_count(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,8 @@ typedef struct {
     void (*send_mouse)(report_mouse_t *);
     void (*send_system)(uint16_t);
     void (*send_consumer)(uint16_t);
+    /* optional, non-zero when a keyboard report can be sent without waiting */
+    uint8_t (*keyboard_ready)(void);
 } host_driver_t;
 
 #endif
@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "eeconfig.h"
 #include "backlight.h"
 #include "action_layer.h"
+#include "latency_trace.h"
 #ifdef BOOTMAGIC_ENABLE
 #   include "bootmagic.h"
 #else
@@ -72,16 +73,31 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #ifdef MATRIX_HAS_GHOST
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
-static matrix_row_t get_real_keys(uint8_t row, matrix_row_t rowdata){
-    matrix_row_t out = 0;
-    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-        //read each key in the row data and check if the keymap defines it as a real key
-        if (pgm_read_byte(&keymaps[0][row][col]) && (rowdata & (1<<col))){
-            //this creates new row data, if a key is defined in the keymap, it will be set here
-            out |= 1<<col;
+
+/* Positions defined in the base layer of the keymap, one bit per column.
+ * Calculated once at init, so that the ghost check doesn't need to read flash. */
+static matrix_row_t ghost_real_keys[MATRIX_ROWS];
+/* The real keys of the current scan, calculated once per scan with changes */
+static matrix_row_t ghost_real_rows[MATRIX_ROWS];
+
+static void ghost_init(void)
+{
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t real_keys = 0;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (pgm_read_word(&keymaps[0][row][col])) {
+                real_keys |= (matrix_row_t)1<<col;
+            }
         }
+        ghost_real_keys[row] = real_keys;
+    }
+}
+
+static void ghost_update_real_rows(void)
+{
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        ghost_real_rows[row] = matrix_get_row(row) & ghost_real_keys[row];
     }
-    return out;
 }
 
 static inline bool popcount_more_than_one(matrix_row_t rowdata)
@@ -90,14 +106,14 @@ static inline bool popcount_more_than_one(matrix_row_t rowdata)
     return rowdata;
 }
 
-static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata)
+static inline bool has_ghost_in_row(uint8_t row)
 {
     /* No ghost exists when less than 2 keys are down on the row.
     If there are "active" blanks in the matrix, the key can't be pressed by the user,
     there is no doubt as to which keys are really being pressed.
     The ghosts will be ignored, they are KC_NO.   */
-    rowdata = get_real_keys(row, rowdata);
-    if ((popcount_more_than_one(rowdata)) == 0){
+    const matrix_row_t rowdata = ghost_real_rows[row];
+    if (!popcount_more_than_one(rowdata)) {
         return false;
     }
     /* Ghost occurs when the row shares a column line with other row,
@@ -108,7 +124,7 @@ static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata)
     we are checking one row at a time, not all of them at once.
     */
     for (uint8_t i=0; i < MATRIX_ROWS; i++) {
-        if (i != row && popcount_more_than_one(get_real_keys(i, matrix_get_row(i)) & rowdata)){
+        if (i != row && popcount_more_than_one(ghost_real_rows[i] & rowdata)){
             return true;
         }
     }
@@ -133,6 +149,9 @@ bool is_keyboard_master(void) {
 void keyboard_init(void) {
     timer_init();
     matrix_init();
+#ifdef MATRIX_HAS_GHOST
+    ghost_init();
+#endif
 #ifdef PS2_MOUSE_ENABLE
     ps2_mouse_init();
 #endif
@@ -167,72 +186,78 @@ void keyboard_init(void) {
 #endif
 }
 
+static matrix_row_t matrix_prev[MATRIX_ROWS];
+static keyevent_t scan_events[QMK_KEYS_PER_SCAN];
+
+/*
+ * Collect the changed keys of the last matrix scan into events, in matrix order.
+ * All events of one scan share a single timestamp.
+ */
+static uint8_t keyboard_collect_events(keyevent_t events[], uint8_t max_events)
+{
+    uint8_t num_events = 0;
+    const uint16_t time = timer_read() | 1; /* time should not be 0 */
+#ifdef MATRIX_HAS_GHOST
+    bool ghost_rows_valid = false;
+#endif
+
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        matrix_row_t matrix_row = matrix_get_row(r);
+        matrix_row_t matrix_change = matrix_row ^ matrix_prev[r];
+        if (!matrix_change) {
+            continue;
+        }
+#ifdef MATRIX_HAS_GHOST
+        if (!ghost_rows_valid) {
+            ghost_update_real_rows();
+            ghost_rows_valid = true;
+        }
+        if (has_ghost_in_row(r)) {
+            /* Don't update matrix_prev until un-ghosted, or the last key would be lost. */
+            continue;
+        }
+#endif
+        if (debug_matrix) matrix_print();
+        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+            if (matrix_change & ((matrix_row_t)1<<c)) {
+                if (num_events >= max_events) {
+                    return num_events;
+                }
+                events[num_events++] = (keyevent_t){
+                    .key = (keypos_t){ .row = r, .col = c },
+                    .pressed = (matrix_row & ((matrix_row_t)1<<c)),
+                    .time = time
+                };
+                // record a collected key
+                matrix_prev[r] ^= ((matrix_row_t)1<<c);
+            }
+        }
+    }
+    return num_events;
+}
+
 /*
  * Do keyboard routine jobs: scan matrix, light LEDs, ...
  * This is repeatedly called as fast as possible.
  */
 void keyboard_task(void)
 {
-    static matrix_row_t matrix_prev[MATRIX_ROWS];
-#ifdef MATRIX_HAS_GHOST
-  //  static matrix_row_t matrix_ghost[MATRIX_ROWS];
-#endif
     static uint8_t led_status = 0;
-    matrix_row_t matrix_row = 0;
-    matrix_row_t matrix_change = 0;
-#ifdef QMK_KEYS_PER_SCAN
-    uint8_t keys_processed = 0;
-#endif
+    uint8_t num_events = 0;
 
+    LATENCY_TRACE(TRACE_SCAN_START);
     matrix_scan();
+    LATENCY_TRACE(TRACE_SCAN_END);
     if (is_keyboard_master()) {
-        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
-            matrix_row = matrix_get_row(r);
-            matrix_change = matrix_row ^ matrix_prev[r];
-            if (matrix_change) {
-#ifdef MATRIX_HAS_GHOST
-                if (has_ghost_in_row(r, matrix_row)) {
-                    /* Keep track of whether ghosted status has changed for
-                    * debugging. But don't update matrix_prev until un-ghosted, or
-                    * the last key would be lost.
-                    */
-                    //if (debug_matrix && matrix_ghost[r] != matrix_row) {
-                    //    matrix_print();
-                    //}
-                    //matrix_ghost[r] = matrix_row;
-                    continue;
-                }
-                //matrix_ghost[r] = matrix_row;
-#endif
-                if (debug_matrix) matrix_print();
-                for (uint8_t c = 0; c < MATRIX_COLS; c++) {
-                    if (matrix_change & ((matrix_row_t)1<<c)) {
-                        action_exec((keyevent_t){
-                            .key = (keypos_t){ .row = r, .col = c },
-                            .pressed = (matrix_row & ((matrix_row_t)1<<c)),
-                            .time = (timer_read() | 1) /* time should not be 0 */
-                        });
-                        // record a processed key
-                        matrix_prev[r] ^= ((matrix_row_t)1<<c);
-#ifdef QMK_KEYS_PER_SCAN
-                        // only jump out if we have processed "enough" keys.
-                        if (++keys_processed >= QMK_KEYS_PER_SCAN)
-#endif
-                        // process a key per task call
-                        goto MATRIX_LOOP_END;
-                    }
-                }
-            }
+        num_events = keyboard_collect_events(scan_events, QMK_KEYS_PER_SCAN);
+        for (uint8_t i = 0; i < num_events; i++) {
+            action_exec(scan_events[i]);
         }
     }
     // call with pseudo tick event when no real key event.
-#ifdef QMK_KEYS_PER_SCAN
-    // we can get here with some keys processed now.
-    if (!keys_processed)
-#endif
-    action_exec(TICK);
-
-MATRIX_LOOP_END:
+    if (!num_events) {
+        action_exec(TICK);
+    }
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
@@ -267,11 +292,19 @@ MATRIX_LOOP_END:
     midi_task();
 #endif
 
+#ifdef REPORT_QUEUE_ENABLE
+    host_report_queue_task();
+#endif
+
     // update LED
     if (led_status != host_keyboard_leds()) {
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+
+#ifdef LATENCY_TRACE_ENABLE
+    latency_trace_task();
+#endif
 }
 
 void keyboard_set_leds(uint8_t leds)
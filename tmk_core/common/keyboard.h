@@ -39,6 +39,13 @@ typedef struct {
     uint16_t time;
 } keyevent_t;
 
+/* Upper bound of key events taken from a single matrix scan. Changes beyond
+ * this stay pending in the matrix and are picked up on the next scan.
+ * Define QMK_KEYS_PER_SCAN 1 to get the old one event per scan behaviour. */
+#ifndef QMK_KEYS_PER_SCAN
+#   define QMK_KEYS_PER_SCAN 8
+#endif
+
 /* equivalent test of keypos_t */
 #define KEYEQ(keya, keyb)       ((keya).row == (keyb).row && (keya).col == (keyb).col)
 
@@ -3,11 +3,18 @@
 
 #if defined(__AVR__)
 #   include <avr/pgmspace.h>
+#   ifndef pgm_read_ptr
+#       define pgm_read_ptr(p)  (void*)pgm_read_word(p)
+#   endif
 #else
 #   define PROGMEM
 #   define pgm_read_byte(p)     *((unsigned char*)p)
 #   define pgm_read_word(p)     *((uint16_t*)p)
 #   define pgm_read_dword(p)    *((uint32_t*)p)
+#   define pgm_read_ptr(p)      *((void* const*)p)
+#   ifndef PSTR
+#       define PSTR(x)          x
+#   endif
 #endif
 
 #endif
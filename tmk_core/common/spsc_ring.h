@@ -0,0 +1,146 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+/*
+ * Single producer, single consumer byte ring buffer
+ *
+ * One side, for example an interrupt, only writes and the other side only
+ * reads. The producer is the only one updating head and the consumer the
+ * only one updating tail, and both are single bytes, so no interrupts need
+ * to be disabled. The size has to be a power of two, up to 256, and one
+ * byte is always left unused to tell a full ring from an empty one.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+typedef struct {
+    uint8_t* buffer;
+    uint8_t mask;
+    uint8_t head;
+    uint8_t tail;
+} spsc_ring_t;
+
+#define SPSC_RING_IS_VALID_SIZE(size) ((size) >= 2 && (size) <= 256 && ((size) & ((size) - 1)) == 0)
+
+/* static initializer, for example
+ * static uint8_t buffer[32];
+ * static spsc_ring_t ring = SPSC_RING_INITIALIZER(buffer, sizeof(buffer)); */
+#define SPSC_RING_INITIALIZER(buf, size) { (buf), (uint8_t)((size) - 1), 0, 0 }
+
+/* the index written by the other side has to be read again every time,
+ * and the data has to be in place before the index is published */
+#define SPSC_RING_LOAD(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define SPSC_RING_STORE(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+
+static inline void spsc_ring_init(spsc_ring_t* ring, uint8_t* buffer, uint16_t size) {
+    ring->buffer = buffer;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+/* number of bytes that can be read */
+static inline uint8_t spsc_ring_count(spsc_ring_t* ring) {
+    return (SPSC_RING_LOAD(ring->head) - SPSC_RING_LOAD(ring->tail)) & ring->mask;
+}
+
+/* number of bytes that can be written */
+static inline uint8_t spsc_ring_space(spsc_ring_t* ring) {
+    return (SPSC_RING_LOAD(ring->tail) - SPSC_RING_LOAD(ring->head) - 1) & ring->mask;
+}
+
+static inline bool spsc_ring_is_empty(spsc_ring_t* ring) {
+    return SPSC_RING_LOAD(ring->head) == SPSC_RING_LOAD(ring->tail);
+}
+
+/* producer side */
+static inline bool spsc_ring_push(spsc_ring_t* ring, uint8_t data) {
+    uint8_t head = ring->head;
+    uint8_t next = (head + 1) & ring->mask;
+    if (next == SPSC_RING_LOAD(ring->tail)) {
+        return false;
+    }
+    ring->buffer[head] = data;
+    SPSC_RING_STORE(ring->head, next);
+    return true;
+}
+
+/* producer side, writes as many bytes as there is space for and returns the number written */
+static inline uint8_t spsc_ring_write(spsc_ring_t* ring, const uint8_t* data, uint8_t len) {
+    uint8_t head = ring->head;
+    uint8_t space = (SPSC_RING_LOAD(ring->tail) - head - 1) & ring->mask;
+    if (len > space) {
+        len = space;
+    }
+    uint16_t first = (uint16_t)ring->mask + 1 - head;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&ring->buffer[head], data, first);
+    memcpy(ring->buffer, data + first, len - first);
+    SPSC_RING_STORE(ring->head, (head + len) & ring->mask);
+    return len;
+}
+
+/* consumer side */
+static inline bool spsc_ring_pop(spsc_ring_t* ring, uint8_t* data) {
+    uint8_t tail = ring->tail;
+    if (tail == SPSC_RING_LOAD(ring->head)) {
+        return false;
+    }
+    *data = ring->buffer[tail];
+    SPSC_RING_STORE(ring->tail, (tail + 1) & ring->mask);
+    return true;
+}
+
+/* consumer side, reads up to len bytes and returns the number read */
+static inline uint8_t spsc_ring_read(spsc_ring_t* ring, uint8_t* data, uint8_t len) {
+    uint8_t tail = ring->tail;
+    uint8_t count = (SPSC_RING_LOAD(ring->head) - tail) & ring->mask;
+    if (len > count) {
+        len = count;
+    }
+    uint16_t first = (uint16_t)ring->mask + 1 - tail;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(data, &ring->buffer[tail], first);
+    memcpy(data + first, ring->buffer, len - first);
+    SPSC_RING_STORE(ring->tail, (tail + len) & ring->mask);
+    return len;
+}
+
+/* consumer side, the byte at index from the oldest one, which has to be less than the count */
+static inline uint8_t spsc_ring_peek(spsc_ring_t* ring, uint8_t index) {
+    return ring->buffer[(ring->tail + index) & ring->mask];
+}
+
+/* consumer side, drops count bytes, which has to be at most the count */
+static inline void spsc_ring_skip(spsc_ring_t* ring, uint8_t count) {
+    SPSC_RING_STORE(ring->tail, (ring->tail + count) & ring->mask);
+}
+
+/* consumer side, drops everything written so far */
+static inline void spsc_ring_clear(spsc_ring_t* ring) {
+    SPSC_RING_STORE(ring->tail, SPSC_RING_LOAD(ring->head));
+}
+
+#endif
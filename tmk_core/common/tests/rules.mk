@@ -0,0 +1,2 @@
+spsc_ring_SRC := $(TMK_PATH)/common/tests/spsc_ring_tests.cpp \
+	$(TMK_PATH)/protocol/midi/bytequeue/bytequeue.c
@@ -0,0 +1,196 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <thread>
+#include "protocol/lufa/ringbuffer.hpp"
+
+extern "C" {
+#include "spsc_ring.h"
+#include "protocol/midi/bytequeue/bytequeue.h"
+}
+
+class SpscRing : public testing::Test {
+public:
+    SpscRing() {
+        spsc_ring_init(&ring, buffer, sizeof(buffer));
+    }
+    uint8_t buffer[16];
+    spsc_ring_t ring;
+};
+
+TEST_F(SpscRing, IsEmptyAfterInit) {
+    uint8_t data;
+    EXPECT_TRUE(spsc_ring_is_empty(&ring));
+    EXPECT_EQ(spsc_ring_count(&ring), 0);
+    EXPECT_EQ(spsc_ring_space(&ring), 15);
+    EXPECT_FALSE(spsc_ring_pop(&ring, &data));
+}
+
+TEST_F(SpscRing, BytesComeOutInTheSameOrder) {
+    uint8_t data;
+    EXPECT_TRUE(spsc_ring_push(&ring, 1));
+    EXPECT_TRUE(spsc_ring_push(&ring, 2));
+    EXPECT_EQ(spsc_ring_count(&ring), 2);
+    EXPECT_TRUE(spsc_ring_pop(&ring, &data));
+    EXPECT_EQ(data, 1);
+    EXPECT_TRUE(spsc_ring_pop(&ring, &data));
+    EXPECT_EQ(data, 2);
+    EXPECT_TRUE(spsc_ring_is_empty(&ring));
+}
+
+TEST_F(SpscRing, OneByteIsLeftUnused) {
+    for (uint8_t i = 0; i < 15; i++) {
+        EXPECT_TRUE(spsc_ring_push(&ring, i));
+    }
+    EXPECT_FALSE(spsc_ring_push(&ring, 15));
+    EXPECT_EQ(spsc_ring_space(&ring), 0);
+    EXPECT_EQ(spsc_ring_count(&ring), 15);
+}
+
+TEST_F(SpscRing, BulkWriteAndReadWrapAround) {
+    uint8_t in[12];
+    uint8_t out[12];
+    for (int round = 0; round < 10; round++) {
+        for (uint8_t i = 0; i < sizeof(in); i++) {
+            in[i] = round * 16 + i;
+        }
+        EXPECT_EQ(spsc_ring_write(&ring, in, sizeof(in)), sizeof(in));
+        EXPECT_EQ(spsc_ring_read(&ring, out, sizeof(out)), sizeof(out));
+        EXPECT_EQ(memcmp(in, out, sizeof(in)), 0);
+    }
+}
+
+TEST_F(SpscRing, BulkWriteIsLimitedToTheSpace) {
+    uint8_t in[20] = {0};
+    uint8_t out[20];
+    EXPECT_EQ(spsc_ring_write(&ring, in, sizeof(in)), 15);
+    EXPECT_EQ(spsc_ring_write(&ring, in, sizeof(in)), 0);
+    EXPECT_EQ(spsc_ring_read(&ring, out, 4), 4);
+    EXPECT_EQ(spsc_ring_write(&ring, in, sizeof(in)), 4);
+    EXPECT_EQ(spsc_ring_read(&ring, out, sizeof(out)), 15);
+    EXPECT_EQ(spsc_ring_read(&ring, out, sizeof(out)), 0);
+}
+
+TEST_F(SpscRing, PeekAndSkip) {
+    for (uint8_t i = 0; i < 10; i++) {
+        spsc_ring_push(&ring, i);
+    }
+    EXPECT_EQ(spsc_ring_peek(&ring, 0), 0);
+    EXPECT_EQ(spsc_ring_peek(&ring, 9), 9);
+    spsc_ring_skip(&ring, 8);
+    EXPECT_EQ(spsc_ring_count(&ring), 2);
+    EXPECT_EQ(spsc_ring_peek(&ring, 0), 8);
+    spsc_ring_clear(&ring);
+    EXPECT_TRUE(spsc_ring_is_empty(&ring));
+}
+
+TEST_F(SpscRing, FullSizeRingWithByteIndices) {
+    uint8_t large[256];
+    spsc_ring_t large_ring = SPSC_RING_INITIALIZER(large, sizeof(large));
+    for (int i = 0; i < 255; i++) {
+        EXPECT_TRUE(spsc_ring_push(&large_ring, i));
+    }
+    EXPECT_FALSE(spsc_ring_push(&large_ring, 0));
+    EXPECT_EQ(spsc_ring_count(&large_ring), 255);
+    uint8_t data;
+    for (int i = 0; i < 255; i++) {
+        EXPECT_TRUE(spsc_ring_pop(&large_ring, &data));
+        EXPECT_EQ(data, i);
+    }
+}
+
+TEST_F(SpscRing, ByteQueueUsesTheRing) {
+    uint8_t data[8];
+    byteQueue_t queue;
+    bytequeue_init(&queue, data, sizeof(data));
+    EXPECT_TRUE(bytequeue_enqueue(&queue, 5));
+    EXPECT_TRUE(bytequeue_enqueue(&queue, 6));
+    EXPECT_EQ(bytequeue_length(&queue), 2);
+    EXPECT_EQ(bytequeue_get(&queue, 1), 6);
+    bytequeue_remove(&queue, 1);
+    EXPECT_EQ(bytequeue_get(&queue, 0), 6);
+    EXPECT_EQ(bytequeue_length(&queue), 1);
+}
+
+TEST_F(SpscRing, TemplateRingBuffer) {
+    struct item {
+        uint16_t a;
+        uint8_t b;
+    };
+    RingBuffer<item, 4> rb;
+    item out;
+    EXPECT_TRUE(rb.empty());
+    EXPECT_TRUE(rb.enqueue({1, 2}));
+    EXPECT_TRUE(rb.enqueue({3, 4}));
+    EXPECT_TRUE(rb.enqueue({5, 6}));
+    EXPECT_FALSE(rb.enqueue({7, 8}));
+    EXPECT_EQ(rb.size(), 3);
+    EXPECT_TRUE(rb.peek(out));
+    EXPECT_EQ(out.a, 1);
+    EXPECT_TRUE(rb.get(out));
+    EXPECT_EQ(out.a, 1);
+    EXPECT_TRUE(rb.get(out));
+    EXPECT_EQ(out.b, 4);
+    EXPECT_EQ(rb.size(), 1);
+}
+
+// The producer and consumer run in separate threads, like an interrupt
+// and the main loop, and every byte has to arrive exactly once in order
+TEST_F(SpscRing, ProducerAndConsumerThreads) {
+    const unsigned num_bytes = 1000000;
+    std::thread producer([this, num_bytes]() {
+        uint8_t chunk[7];
+        unsigned sent = 0;
+        while (sent < num_bytes) {
+            uint8_t len = sizeof(chunk);
+            if (num_bytes - sent < len) {
+                len = num_bytes - sent;
+            }
+            for (uint8_t i = 0; i < len; i++) {
+                chunk[i] = (uint8_t)(sent + i);
+            }
+            // Mix single and bulk writes
+            uint8_t written;
+            if (sent & 1) {
+                written = spsc_ring_push(&ring, chunk[0]) ? 1 : 0;
+            } else {
+                written = spsc_ring_write(&ring, chunk, len);
+            }
+            if (!written) {
+                std::this_thread::yield();
+            }
+            sent += written;
+        }
+    });
+    unsigned received = 0;
+    unsigned errors = 0;
+    uint8_t chunk[5];
+    while (received < num_bytes) {
+        uint8_t len = spsc_ring_read(&ring, chunk, sizeof(chunk));
+        for (uint8_t i = 0; i < len; i++) {
+            if (chunk[i] != (uint8_t)(received + i)) {
+                errors++;
+            }
+        }
+        if (!len) {
+            std::this_thread::yield();
+        }
+        received += len;
+    }
+    producer.join();
+    EXPECT_EQ(errors, 0);
+}
@@ -45,6 +45,9 @@ uint16_t timer_read(void);
 uint32_t timer_read32(void);
 uint16_t timer_elapsed(uint16_t last);
 uint32_t timer_elapsed32(uint32_t last);
+/* Timestamp in microseconds for profiling, the actual resolution depends on the platform.
+ * It wraps around after about 71 minutes, so only use it for differences. */
+uint32_t timer_read_us(void);
 
 #ifdef __cplusplus
 }
@@ -696,6 +696,22 @@ void send_keyboard(report_keyboard_t *report) {
   keyboard_report_sent = *report;
 }
 
+/* true when send_keyboard can start the transfer without waiting
+ * for the previous report to make it through */
+uint8_t keyboard_ready(void) {
+  uint8_t ready;
+  usbep_t ep = KEYBOARD_IN_EPNUM;
+#ifdef NKRO_ENABLE
+  if(keymap_config.nkro) {
+    ep = NKRO_IN_EPNUM;
+  }
+#endif /* NKRO_ENABLE */
+  osalSysLock();
+  ready = usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE || !usbGetTransmitStatusI(&USB_DRIVER, ep);
+  osalSysUnlock();
+  return ready;
+}
+
 /* ---------------------------------------------------------
  *                     Mouse functions
  * ---------------------------------------------------------
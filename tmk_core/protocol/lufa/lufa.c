@@ -103,12 +103,14 @@ static void send_keyboard(report_keyboard_t *report);
 static void send_mouse(report_mouse_t *report);
 static void send_system(uint16_t data);
 static void send_consumer(uint16_t data);
+static uint8_t keyboard_ready(void);
 host_driver_t lufa_driver = {
     keyboard_leds,
     send_keyboard,
     send_mouse,
     send_system,
     send_consumer,
+    keyboard_ready,
 };
 
 #ifdef VIRTSER_ENABLE
@@ -613,6 +615,30 @@ static void send_keyboard(report_keyboard_t *report)
     keyboard_report_sent = *report;
 }
 
+static uint8_t keyboard_ready(void)
+{
+    uint8_t where = where_to_send();
+
+    /* send_keyboard doesn't wait for anything else than USB */
+    if (where != OUTPUT_USB && where != OUTPUT_USB_AND_BT) {
+        return true;
+    }
+    if (USB_DeviceState != DEVICE_STATE_Configured) {
+        return true;
+    }
+
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        Endpoint_SelectEndpoint(NKRO_IN_EPNUM);
+    }
+    else
+#endif
+    {
+        Endpoint_SelectEndpoint(KEYBOARD_IN_EPNUM);
+    }
+    return Endpoint_IsReadWriteAllowed();
+}
+
 static void send_mouse(report_mouse_t *report)
 {
 #ifdef MOUSE_ENABLE
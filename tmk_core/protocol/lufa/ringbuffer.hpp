@@ -1,38 +1,39 @@
 #pragma once
-// A simple ringbuffer holding Size elements of type T
-template <typename T, uint8_t Size>
+#include "spsc_ring.h"
+// A simple ringbuffer holding Size - 1 elements of type T
+// It follows the same single producer, single consumer rules as spsc_ring.h,
+// so the producer and the consumer don't need to disable interrupts.
+template <typename T, uint16_t Size>
 class RingBuffer {
+  static_assert(SPSC_RING_IS_VALID_SIZE(Size), "RingBuffer size must be a power of two, from 2 to 256");
  protected:
+  static const uint8_t Mask = Size - 1;
   T buf_[Size];
   uint8_t head_{0}, tail_{0};
  public:
   inline uint8_t nextPosition(uint8_t position) {
-    return (position + 1) % Size;
+    return (position + 1) & Mask;
   }
 
   inline uint8_t prevPosition(uint8_t position) {
-    if (position == 0) {
-      return Size - 1;
-    }
-    return position - 1;
+    return (position - 1) & Mask;
   }
 
   inline bool enqueue(const T &item) {
-    static_assert(Size > 1, "RingBuffer size must be > 1");
     uint8_t next = nextPosition(head_);
-    if (next == tail_) {
+    if (next == SPSC_RING_LOAD(tail_)) {
       // Full
       return false;
     }
 
     buf_[head_] = item;
-    head_ = next;
+    SPSC_RING_STORE(head_, next);
     return true;
   }
 
   inline bool get(T &dest, bool commit = true) {
     auto tail = tail_;
-    if (tail == head_) {
+    if (tail == SPSC_RING_LOAD(head_)) {
       // No more data
       return false;
     }
@@ -41,19 +42,15 @@ class RingBuffer {
     tail = nextPosition(tail);
 
     if (commit) {
-      tail_ = tail;
+      SPSC_RING_STORE(tail_, tail);
     }
     return true;
   }
 
-  inline bool empty() const { return head_ == tail_; }
+  inline bool empty() const { return SPSC_RING_LOAD(head_) == SPSC_RING_LOAD(tail_); }
 
   inline uint8_t size() const {
-    int diff = head_ - tail_;
-    if (diff >= 0) {
-      return diff;
-    }
-    return Size + diff;
+    return (SPSC_RING_LOAD(head_) - SPSC_RING_LOAD(tail_)) & Mask;
   }
 
   inline T& front() {
@@ -26,17 +26,13 @@ extern "C" {
 
 #include <inttypes.h>
 #include <stdbool.h>
+#include "spsc_ring.h"
 
 typedef uint8_t byteQueueIndex_t;
 
-typedef struct {
-	byteQueueIndex_t start;
-	byteQueueIndex_t end;
-	byteQueueIndex_t length;
-	uint8_t * data;
-} byteQueue_t;
+//the length of the data array has to be a power of two
+typedef spsc_ring_t byteQueue_t;
 
-//you must have a queue, an array of data which the queue will use, and the length of that array
 void bytequeue_init(byteQueue_t * queue, uint8_t * dataArray, byteQueueIndex_t arrayLen);
 
 //add an item to the queue, returns false if the queue is full